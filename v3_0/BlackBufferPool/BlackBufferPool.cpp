@@ -0,0 +1,193 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackBufferPool.h"
+
+#include <cstdlib>
+#include <new>
+
+
+
+
+
+namespace BlackLib
+{
+
+    const uint32_t          BUFFER_POOL_EMPTY           = 0xFFFFFFFF;   //!< Index value which marks the end of free stack
+
+
+
+    void BlackBuffer::release()
+    {
+        this->pool->release(this);
+    }
+
+
+
+
+
+
+
+
+
+    BlackBufferPool::BlackBufferPool(size_t size, uint32_t count)
+    {
+        this->bufferSize        = size;
+        this->bufferCount       = 0;
+        this->bufferStride      = ( (size + BLACK_CACHE_LINE_SIZE - 1) / BLACK_CACHE_LINE_SIZE ) * BLACK_CACHE_LINE_SIZE;
+        this->memory            = NULL;
+        this->buffers           = NULL;
+        this->nextFree          = NULL;
+        this->freeHead          = BUFFER_POOL_EMPTY;
+        this->availableCount    = 0;
+        this->exhaustedCount    = 0;
+
+        if( count == 0 or count == BUFFER_POOL_EMPTY or this->bufferStride == 0 )
+        {
+            return;
+        }
+
+        void *block;
+        if( ::posix_memalign(&block, BLACK_CACHE_LINE_SIZE, this->bufferStride * count) != 0 )
+        {
+            return;
+        }
+
+        this->memory    = static_cast<uint8_t*>(block);
+        this->nextFree  = new uint32_t[count];
+        this->buffers   = static_cast<BlackBuffer*>( ::operator new(sizeof(BlackBuffer) * count) );
+
+        for( uint32_t i = 0 ; i < count ; i++ )
+        {
+            new (&(this->buffers[i])) BlackBuffer(this->memory + i * this->bufferStride, size, i, this);
+            this->nextFree[i] = (i + 1 < count) ? (i + 1) : BUFFER_POOL_EMPTY;
+        }
+
+        this->bufferCount       = count;
+        this->availableCount    = count;
+        this->freeHead          = 0;
+        __sync_synchronize();
+    }
+
+    BlackBufferPool::~BlackBufferPool()
+    {
+        if( this->memory != NULL )
+        {
+            ::free(this->memory);
+            ::operator delete(this->buffers);
+            delete[] this->nextFree;
+        }
+    }
+
+    BlackBuffer *BlackBufferPool::acquire()
+    {
+        while( true )
+        {
+            uint64_t oldHead    = this->freeHead;
+            uint32_t index      = static_cast<uint32_t>(oldHead);
+
+            if( index == BUFFER_POOL_EMPTY )
+            {
+                __sync_fetch_and_add( &(this->exhaustedCount), 1 );
+                return NULL;
+            }
+
+            // 64 bit head can be read in two parts at 32 bit cpus, so a torn value is read again
+            if( index >= this->bufferCount )
+            {
+                continue;
+            }
+
+            // tag is increased at every change, so an old head can't be swapped back (ABA)
+            uint64_t newHead    = ( ((oldHead >> 32) + 1) << 32 ) | this->nextFree[index];
+
+            if( __sync_bool_compare_and_swap( &(this->freeHead), oldHead, newHead ) )
+            {
+                __sync_fetch_and_sub( &(this->availableCount), 1 );
+
+                this->buffers[index].setLength(0);
+                return &(this->buffers[index]);
+            }
+        }
+    }
+
+    bool BlackBufferPool::release(BlackBuffer *buffer)
+    {
+        if( buffer == NULL or buffer->getPool() != this or buffer->getIndex() >= this->bufferCount )
+        {
+            return false;
+        }
+
+        uint32_t index = buffer->getIndex();
+        uint64_t oldHead;
+        uint64_t newHead;
+
+        do
+        {
+            oldHead                 = this->freeHead;
+            this->nextFree[index]   = static_cast<uint32_t>(oldHead);
+            newHead                 = ( ((oldHead >> 32) + 1) << 32 ) | index;
+        }
+        while( not __sync_bool_compare_and_swap( &(this->freeHead), oldHead, newHead ) );
+
+        __sync_fetch_and_add( &(this->availableCount), 1 );
+
+        return true;
+    }
+
+    size_t BlackBufferPool::getBufferSize()
+    {
+        return this->bufferSize;
+    }
+
+    uint32_t BlackBufferPool::getBufferCount()
+    {
+        return this->bufferCount;
+    }
+
+    uint32_t BlackBufferPool::getAvailableCount()
+    {
+        return this->availableCount;
+    }
+
+    uint32_t BlackBufferPool::getExhaustedCount()
+    {
+        return this->exhaustedCount;
+    }
+
+    bool BlackBufferPool::isValid()
+    {
+        return ( this->memory != NULL );
+    }
+
+
+
+} /* namespace BlackLib */
@@ -0,0 +1,274 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKBUFFERPOOL_H_
+#define BLACKBUFFERPOOL_H_
+
+#include <cstdint>
+#include <cstddef>
+
+
+
+
+namespace BlackLib
+{
+
+    const size_t            BLACK_CACHE_LINE_SIZE       = 64;           //!< Alignment of pool buffers, it is enough for Cortex-A8 and common x86 cpus
+
+    class BlackBufferPool;
+
+    // ########################################### BLACKBUFFER DECLARATION STARTS ############################################ //
+
+    /*! @brief Fixed-capacity buffer which is owned by a BlackBufferPool.
+     *
+     *    Objects of this class are created only by BlackBufferPool class. Every buffer starts at a cache
+     *    line boundary and doesn't share its cache lines with other buffers. Length shows the number of
+     *    valid bytes; transfer functions which accept BlackBuffer objects use or set this value.
+     *
+     *    Example usage is shown in BlackBufferPool class.
+     */
+    class BlackBuffer
+    {
+        private:
+            uint8_t                *data;                   /*!< @brief is used to hold the aligned memory of buffer */
+            size_t                  capacity;               /*!< @brief is used to hold the usable size of buffer */
+            size_t                  length;                 /*!< @brief is used to hold the number of valid bytes */
+            uint32_t                index;                  /*!< @brief is used to hold the position of buffer at its pool */
+            BlackBufferPool        *pool;                   /*!< @brief is used to hold the owner pool */
+
+        public:
+
+            /*! @brief Constructor of BlackBuffer class.
+            *
+            * This function is called by BlackBufferPool. Users should not create buffers directly.
+            */
+                                    BlackBuffer(uint8_t *memory, size_t bufferCapacity, uint32_t poolIndex, BlackBufferPool *ownerPool)
+            {
+                this->data          = memory;
+                this->capacity      = bufferCapacity;
+                this->length        = 0;
+                this->index         = poolIndex;
+                this->pool          = ownerPool;
+            }
+
+            /*! @brief Exports pointer of buffer memory.
+            */
+            uint8_t                *getData() const
+            {
+                return this->data;
+            }
+
+            /*! @brief Exports usable size of buffer.
+            */
+            size_t                  getCapacity() const
+            {
+                return this->capacity;
+            }
+
+            /*! @brief Exports the number of valid bytes.
+            */
+            size_t                  getLength() const
+            {
+                return this->length;
+            }
+
+            /*! @brief Changes the number of valid bytes.
+            *
+            * @return false if new length is bigger than capacity, else true.
+            */
+            bool                    setLength(size_t newLength)
+            {
+                if( newLength > this->capacity )
+                {
+                    return false;
+                }
+
+                this->length = newLength;
+                return true;
+            }
+
+            /*! @brief Exports position of buffer at its pool.
+            */
+            uint32_t                getIndex() const
+            {
+                return this->index;
+            }
+
+            /*! @brief Exports owner pool of buffer.
+            */
+            BlackBufferPool        *getPool() const
+            {
+                return this->pool;
+            }
+
+            /*! @brief Accesses a byte of buffer.
+            */
+            uint8_t&                operator[](size_t position)
+            {
+                return this->data[position];
+            }
+
+            /*! @brief Gives the buffer back to its pool.
+            *
+            * The buffer must not be used after this call.
+            */
+            void                    release();
+    };
+    // ############################################ BLACKBUFFER DECLARATION ENDS ############################################# //
+
+
+
+
+
+
+
+
+
+
+    // ######################################### BLACKBUFFERPOOL DECLARATION STARTS ########################################## //
+
+    /*! @brief Preallocated pool of fixed-size, cache line aligned buffers.
+     *
+     *    This class allocates all buffers with one aligned allocation at construction. After that,
+     *    acquire() and release() functions don't allocate memory and don't take any lock. Free buffers
+     *    are kept in a lock-free stack whose head holds a modification tag beside the buffer index, so
+     *    a buffer which is taken and given back between the read and the swap of another thread can't
+     *    corrupt the stack. Buffers can be acquired at one thread and released at another thread.
+     *
+     *    If the pool is empty, acquire() function returns NULL instead of allocating; the number of
+     *    these failures can be read with getExhaustedCount() function, so the pool size can be tuned.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myBufferPoolProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackSPI/BlackSPI.h"
+     *  #include "BlackLib/BlackBufferPool/BlackBufferPool.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackBufferPool   pool(32, 16);                   // sixteen buffers of 32 bytes
+     *      BlackLib::BlackSPI          mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiDefault, 2400000);
+     *      mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+     *
+     *      BlackLib::BlackBuffer *frame = pool.acquire();
+     *      if( frame != NULL )
+     *      {
+     *          (*frame)[0] = 0x01;
+     *          (*frame)[1] = 0x80;
+     *          (*frame)[2] = 0x00;
+     *          frame->setLength(3);
+     *
+     *          mySpi.transfer(*frame);                                 // data is exchanged in place
+     *
+     *          std::cout << "Result: " << (int)(*frame)[2] << std::endl;
+     *          frame->release();
+     *      }
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackBufferPool
+    {
+        private:
+            uint8_t                *memory;                 /*!< @brief is used to hold the aligned memory of all buffers */
+            BlackBuffer            *buffers;                /*!< @brief is used to hold the buffer descriptors */
+            uint32_t               *nextFree;               /*!< @brief is used to hold the links of free stack */
+            volatile uint64_t       freeHead;               /*!< @brief is used to hold the modification tag (high half) and top index (low half) of free stack */
+            volatile uint32_t       availableCount;         /*!< @brief is used to hold the number of free buffers */
+            volatile uint32_t       exhaustedCount;         /*!< @brief is used to hold the number of failed acquire requests */
+            size_t                  bufferSize;             /*!< @brief is used to hold the usable size of every buffer */
+            size_t                  bufferStride;           /*!< @brief is used to hold the distance between buffers */
+            uint32_t                bufferCount;            /*!< @brief is used to hold the number of buffers */
+
+        public:
+
+            /*! @brief Constructor of BlackBufferPool class.
+            *
+            * This function allocates all buffers. Buffer size is rounded up to cache line size internally,
+            * but capacity of buffers is equal to requested size.
+            *
+            * @param [in] size              usable size of every buffer
+            * @param [in] count             number of buffers
+            */
+                                    BlackBufferPool(size_t size, uint32_t count);
+
+            /*! @brief Destructor of BlackBufferPool class.
+            *
+            * All buffers must be released before the pool is destroyed.
+            */
+            virtual                 ~BlackBufferPool();
+
+            /*! @brief Takes a free buffer from pool.
+            *
+            * Length of returned buffer is zero.
+            *
+            * @return pointer of buffer, or NULL if all buffers are in use.
+            */
+            BlackBuffer            *acquire();
+
+            /*! @brief Gives a buffer back to pool.
+            *
+            * @param [in] buffer            buffer which is taken from this pool
+            * @return false if buffer doesn't belong to this pool, else true.
+            */
+            bool                    release(BlackBuffer *buffer);
+
+            /*! @brief Exports usable size of buffers.
+            */
+            size_t                  getBufferSize();
+
+            /*! @brief Exports the number of buffers.
+            */
+            uint32_t                getBufferCount();
+
+            /*! @brief Exports the number of free buffers.
+            */
+            uint32_t                getAvailableCount();
+
+            /*! @brief Exports the number of failed acquire requests.
+            */
+            uint32_t                getExhaustedCount();
+
+            /*! @brief Checks the memory allocation of pool.
+            *
+            * @return true if buffers are allocated, else false.
+            */
+            bool                    isValid();
+    };
+    // ########################################## BLACKBUFFERPOOL DECLARATION ENDS ########################################### //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKBUFFERPOOL_H_ */
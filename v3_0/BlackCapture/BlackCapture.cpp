@@ -0,0 +1,286 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackCapture.h"
+
+
+namespace BlackLib
+{
+
+    // eCAP register offsets from start of pwm subsystem
+    static const uint32_t   ECAP_OFFSET             = 0x100;
+    static const uint32_t   ECAP_TSCTR              = ECAP_OFFSET + 0x00;
+    static const uint32_t   ECAP_CAP1               = ECAP_OFFSET + 0x08;
+    static const uint32_t   ECAP_ECCTL1             = ECAP_OFFSET + 0x28;
+    static const uint32_t   ECAP_ECCTL2             = ECAP_OFFSET + 0x2A;
+    static const uint32_t   ECAP_ECEINT             = ECAP_OFFSET + 0x2C;
+    static const uint32_t   ECAP_ECFLG              = ECAP_OFFSET + 0x2E;
+    static const uint32_t   ECAP_ECCLR              = ECAP_OFFSET + 0x30;
+
+    static const uint32_t   PWMSS_ECAPCLK_EN        = 0x0001;
+
+    // ECCTL1: CAP2POL and CAP4POL falling edge, CAPLDEN, FREE_SOFT free run
+    static const uint16_t   ECCTL1_CONFIG           = 0x0004 | 0x0040 | 0x0100 | 0xC000;
+    // ECCTL2: continuous mode, wrap after CAP4, SYNCO disabled
+    static const uint16_t   ECCTL2_CONFIG           = 0x0006 | 0x0080;
+    static const uint16_t   ECCTL2_TSCTRSTOP        = 0x0010;
+    static const uint16_t   ECFLG_CEVT4             = 0x0010;
+
+
+    // ######################################### BLACKCAPTURE DEFINITION STARTS ########################################### //
+
+    BlackCapture::BlackCapture(captureName cap)
+    {
+        const off_t baseAddress[3] = { PWMSS0_BASE_ADDRESS, PWMSS1_BASE_ADDRESS, PWMSS2_BASE_ADDRESS };
+
+        this->captureErrors     = new errorCapture();
+        this->captureModule     = cap;
+        this->clockFrequency    = ECAP_DEFAULT_CLOCK;
+
+        if( this->registerMap.open(DEV_MEM_PATH, baseAddress[cap], PWMSS_MAP_SIZE) )
+        {
+            this->initialize();
+        }
+        else
+        {
+            this->captureErrors->mapError = true;
+        }
+    }
+
+    BlackCapture::BlackCapture(captureName cap, const std::string &registerImagePath)
+    {
+        this->captureErrors     = new errorCapture();
+        this->captureModule     = cap;
+        this->clockFrequency    = ECAP_DEFAULT_CLOCK;
+
+        if( this->registerMap.open(registerImagePath, 0, PWMSS_MAP_SIZE) )
+        {
+            this->initialize();
+        }
+        else
+        {
+            this->captureErrors->mapError = true;
+        }
+    }
+
+    BlackCapture::~BlackCapture()
+    {
+        delete this->captureErrors;
+    }
+
+    void        BlackCapture::initialize()
+    {
+        uint32_t clockConfig = this->registerMap.read32(PWMSS_CLKCONFIG_OFFSET);
+        this->registerMap.write32(PWMSS_CLKCONFIG_OFFSET, clockConfig | PWMSS_ECAPCLK_EN);
+
+        this->registerMap.write16(ECAP_ECCTL2, ECCTL2_CONFIG);
+        this->registerMap.write16(ECAP_ECEINT, 0x0000);
+        this->registerMap.write16(ECAP_ECCLR,  0xFFFF);
+        this->registerMap.write16(ECAP_ECCTL1, ECCTL1_CONFIG);
+        this->registerMap.write16(ECAP_ECCTL2, ECCTL2_CONFIG | ECCTL2_TSCTRSTOP);
+    }
+
+    uint64_t    BlackCapture::toNanosecond(uint32_t count)
+    {
+        return ( static_cast<uint64_t>(count) * 1000000000ULL ) / this->clockFrequency;
+    }
+
+    uint64_t    BlackCapture::fromNanosecond(uint64_t value, timeType tType)
+    {
+        switch( tType )
+        {
+            case picosecond:    { return value * 1000;          }
+            case microsecond:   { return value / 1000;          }
+            case milisecond:    { return value / 1000000;       }
+            case second:        { return value / 1000000000;    }
+            default:            { return value;                 }
+        }
+    }
+
+
+
+    bool        BlackCapture::readCapture(BlackCaptureValue &value)
+    {
+        if( not this->registerMap.isOpen() )
+        {
+            this->captureErrors->captureError = true;
+            return false;
+        }
+
+        // counter is read after capture registers, so no capture can be newer than counter
+        uint32_t captures[4];
+        for( int i = 0 ; i < 4 ; i++ )
+        {
+            captures[i] = this->registerMap.read32(ECAP_CAP1 + 4 * i);
+        }
+        uint32_t counter    = this->registerMap.read32(ECAP_TSCTR);
+        uint16_t eventFlags = this->registerMap.read16(ECAP_ECFLG);
+
+        if( not (eventFlags & ECFLG_CEVT4) )
+        {
+            this->captureErrors->captureError = true;
+            return false;
+        }
+
+        // ages are wrap-safe; CAP1 and CAP3 hold rising edges, CAP2 and CAP4 hold falling edges
+        uint32_t ages[4];
+        for( int i = 0 ; i < 4 ; i++ )
+        {
+            ages[i] = counter - captures[i];
+        }
+
+        int olderRise = (ages[0] > ages[2]) ? 0 : 2;
+        int newerRise = 2 - olderRise;
+        int fallBetween = -1;
+
+        for( int i = 1 ; i < 4 ; i += 2 )
+        {
+            if( ages[i] < ages[olderRise] and ages[i] > ages[newerRise] )
+            {
+                fallBetween = i;
+            }
+        }
+
+        if( fallBetween < 0 )
+        {
+            this->captureErrors->captureError = true;
+            return false;
+        }
+
+        uint32_t newestAge = ages[0];
+        for( int i = 1 ; i < 4 ; i++ )
+        {
+            if( ages[i] < newestAge )
+            {
+                newestAge = ages[i];
+            }
+        }
+
+        value.periodCount   = ages[olderRise] - ages[newerRise];
+        value.highCount     = ages[olderRise] - ages[fallBetween];
+        value.periodTime    = this->toNanosecond(value.periodCount);
+        value.highTime      = this->toNanosecond(value.highCount);
+        value.lastEdgeAge   = this->toNanosecond(newestAge);
+        value.frequency     = static_cast<float>(this->clockFrequency) / static_cast<float>(value.periodCount);
+        value.dutyPercent   = 100.0 * static_cast<float>(value.highCount) / static_cast<float>(value.periodCount);
+
+        this->captureErrors->captureError = false;
+        return true;
+    }
+
+    uint64_t    BlackCapture::getPeriodTime(timeType tType)
+    {
+        BlackCaptureValue value;
+        if( not this->readCapture(value) )
+        {
+            return 0;
+        }
+
+        return this->fromNanosecond(value.periodTime, tType);
+    }
+
+    uint64_t    BlackCapture::getHighTime(timeType tType)
+    {
+        BlackCaptureValue value;
+        if( not this->readCapture(value) )
+        {
+            return 0;
+        }
+
+        return this->fromNanosecond(value.highTime, tType);
+    }
+
+    float       BlackCapture::getFrequency()
+    {
+        BlackCaptureValue value;
+        if( not this->readCapture(value) )
+        {
+            return 0.0;
+        }
+
+        return value.frequency;
+    }
+
+    float       BlackCapture::getDutyPercent()
+    {
+        BlackCaptureValue value;
+        if( not this->readCapture(value) )
+        {
+            return 0.0;
+        }
+
+        return value.dutyPercent;
+    }
+
+    bool        BlackCapture::isSignalPresent(uint64_t timeout, timeType tType)
+    {
+        BlackCaptureValue value;
+        if( not this->readCapture(value) )
+        {
+            return false;
+        }
+
+        return ( this->fromNanosecond(value.lastEdgeAge, tType) <= timeout );
+    }
+
+    void        BlackCapture::setClockFrequency(uint32_t frequency)
+    {
+        if( frequency > 0 )
+        {
+            this->clockFrequency = frequency;
+        }
+    }
+
+    uint32_t    BlackCapture::getClockFrequency()
+    {
+        return this->clockFrequency;
+    }
+
+
+
+    bool        BlackCapture::fail()
+    {
+        return (this->captureErrors->mapError or
+                this->captureErrors->captureError
+                );
+    }
+
+    bool        BlackCapture::fail(BlackCapture::flags f)
+    {
+        if(f==mapErr)       { return this->captureErrors->mapError;     }
+        if(f==captureErr)   { return this->captureErrors->captureError; }
+
+        return true;
+    }
+
+    // ########################################### BLACKCAPTURE DEFINITION ENDS ############################################ //
+
+} /* namespace BlackLib */
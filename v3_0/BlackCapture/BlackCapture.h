@@ -0,0 +1,267 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKCAPTURE_H_
+#define BLACKCAPTURE_H_
+
+#include "../BlackDef.h"
+#include "../BlackErr.h"
+#include "../BlackRegisterMap/BlackRegisterMap.h"
+
+#include <string>
+#include <cstdint>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used to define eCAP module names.
+    */
+    enum captureName        {   CAPTURE0                = 0,    /*!< eCAP0 module, input pin is P9_42 */
+                                CAPTURE1                = 1,    /*!< eCAP1 module */
+                                CAPTURE2                = 2     /*!< eCAP2 module, input pin is P9_28 */
+                            };
+
+
+    const uint32_t          ECAP_DEFAULT_CLOCK          = 100000000;                //!< eCAP time stamp counter clock (SYSCLKOUT) frequency
+
+
+
+
+    /*! @brief Holds one measurement of BlackCapture class.
+     *
+     *    All values are calculated from the last complete cycle of input signal, so they are updated
+     *    at every rising edge.
+     */
+    struct BlackCaptureValue
+    {
+        uint32_t    periodCount;                /*!< @brief is used to hold the period as counter ticks */
+        uint32_t    highCount;                  /*!< @brief is used to hold the high time as counter ticks */
+        uint64_t    periodTime;                 /*!< @brief is used to hold the period at nanosecond level */
+        uint64_t    highTime;                   /*!< @brief is used to hold the high time at nanosecond level */
+        uint64_t    lastEdgeAge;                /*!< @brief is used to hold the elapsed time since last edge at nanosecond level */
+        float       frequency;                  /*!< @brief is used to hold the frequency in Hz */
+        float       dutyPercent;                /*!< @brief is used to hold the percentage value of high time */
+
+        BlackCaptureValue()
+        {
+            periodCount = 0;
+            highCount   = 0;
+            periodTime  = 0;
+            highTime    = 0;
+            lastEdgeAge = 0;
+            frequency   = 0.0;
+            dutyPercent = 0.0;
+        }
+    };
+
+
+
+
+    // ######################################### BLACKCAPTURE DECLARATION STARTS ########################################### //
+
+    /*! @brief Measures period and high time of input signal with AM335x eCAP modules.
+     *
+     *    This class maps the registers of pwm subsystem and configures its eCAP module to absolute time
+     *    stamp capture mode. Rising edges are captured to CAP1 and CAP3 registers and falling edges are
+     *    captured to CAP2 and CAP4 registers continuously by hardware. Because of that, the measurement
+     *    doesn't depend on CPU timing and reading a measurement is only a few register reads.
+     *
+     *    The registers can be mapped from @b "/dev/mem" or from a file which holds image of the pwm
+     *    subsystem's 4 KB register area. The second one is useful for testing without hardware.
+     *
+     *    @warning The pwm subsystem module must be enabled (for example by loading a pwm or ecap device tree)
+     *    and input pin must be muxed to eCAP mode before using this class. Otherwise register access causes
+     *    bus error. eCAP0 can't be used with BlackPWM's P9_42 output at the same time.
+     *
+     *    @warning Time stamp counter is 32 bit, so if there is no edge for more than 42 seconds (at 100 MHz),
+     *    calculated values become meaningless.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myCaptureProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackCapture/BlackCapture.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackCapture  myCapture(BlackLib::CAPTURE0);
+     *      BlackLib::BlackCaptureValue value;
+     *
+     *      if( myCapture.readCapture(value) )
+     *      {
+     *          std::cout << "Frequency: " << value.frequency << " Hz" << std::endl;
+     *          std::cout << "Duty: " << value.dutyPercent << "%" << std::endl;
+     *      }
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     * @code{.cpp}
+     *   // Possible Output:
+     *   // Frequency: 1000 Hz
+     *   // Duty: 25%
+     * @endcode
+     */
+    class BlackCapture
+    {
+        private:
+            errorCapture        *captureErrors;         /*!< @brief is used to hold the errors of BlackCapture class */
+            captureName         captureModule;          /*!< @brief is used to hold the selected eCAP module */
+            BlackRegisterMap    registerMap;            /*!< @brief is used to hold the mapped pwm subsystem registers */
+            uint32_t            clockFrequency;         /*!< @brief is used to hold the time stamp counter frequency */
+
+            /*! @brief Configures eCAP module.
+            *
+            * This function enables eCAP clock of pwm subsystem, sets rising/falling edge polarities of capture
+            * registers, enables continuous absolute time stamp capturing and starts time stamp counter.
+            */
+            void                initialize();
+
+            /*! @brief Converts counter ticks to nanosecond.
+            */
+            uint64_t            toNanosecond(uint32_t count);
+
+            /*! @brief Converts nanosecond value to selected time type.
+            */
+            uint64_t            fromNanosecond(uint64_t value, timeType tType);
+
+        public:
+            /*!
+            * This enum is used to define Capture debugging flags.
+            */
+            enum flags          {   mapErr          = 0,    /*!< enumeration for @a errorCapture::mapError status */
+                                    captureErr      = 1     /*!< enumeration for @a errorCapture::captureError status */
+                                };
+
+            /*! @brief Constructor of BlackCapture class.
+            *
+            * This function maps the pwm subsystem of selected eCAP module from @b "/dev/mem" and configures
+            * the eCAP module.
+            * @param [in] cap        eCAP module name (enum)
+            *
+            * @sa captureName
+            */
+                                BlackCapture(captureName cap);
+
+            /*! @brief Constructor of BlackCapture class.
+            *
+            * This function maps the entered register image file instead of @b "/dev/mem". The file must be
+            * at least 4 KB and it must hold the register area of pwm subsystem from its beginning.
+            * @param [in] cap                eCAP module name (enum)
+            * @param [in] registerImagePath  register image file path
+            */
+                                BlackCapture(captureName cap, const std::string &registerImagePath);
+
+            /*! @brief Destructor of BlackCapture class.
+            *
+            * This function unmaps registers and deletes errorCapture struct pointer. eCAP module keeps running.
+            */
+            virtual             ~BlackCapture();
+
+            /*! @brief Reads the last measurement.
+            *
+            * This function reads four capture registers and time stamp counter. Then it orders the edges by
+            * their ages and calculates period and high time from the last complete cycle.
+            * @param [out] value     measurement
+            * @return True if at least four edges are captured and the edges are consistent, else false.
+            */
+            bool                readCapture(BlackCaptureValue &value);
+
+            /*! @brief Reads period time of input signal.
+            *
+            * @return period value at selected time type, or 0 if reading fails.
+            */
+            uint64_t            getPeriodTime(timeType tType = nanosecond);
+
+            /*! @brief Reads high time of input signal.
+            *
+            * @return high time value at selected time type, or 0 if reading fails.
+            */
+            uint64_t            getHighTime(timeType tType = nanosecond);
+
+            /*! @brief Reads frequency of input signal.
+            *
+            * @return frequency in Hz, or 0.0 if reading fails.
+            */
+            float               getFrequency();
+
+            /*! @brief Reads percentage value of high time.
+            *
+            * @return duty percentage, or 0.0 if reading fails.
+            */
+            float               getDutyPercent();
+
+            /*! @brief Checks input signal existence.
+            *
+            * @param [in] timeout    maximum accepted time since last edge
+            * @param [in] tType      time type of timeout value(enum)
+            * @return True if a valid measurement exists and last edge is newer than timeout, else false.
+            */
+            bool                isSignalPresent(uint64_t timeout, timeType tType = milisecond);
+
+            /*! @brief Changes time stamp counter frequency used at calculations.
+            */
+            void                setClockFrequency(uint32_t frequency);
+
+            /*! @brief Exports time stamp counter frequency used at calculations.
+            */
+            uint32_t            getClockFrequency();
+
+            /*! @brief Is used for general debugging.
+            *
+            * @return True if any error occured, else false.
+            *
+            * @sa errorCapture
+            */
+            bool                fail();
+
+            /*! @brief Is used for specific debugging.
+            *
+            * @param [in] f specific error type (enum)
+            * @return Value of @a selected error.
+            *
+            * @sa errorCapture
+            */
+            bool                fail(BlackCapture::flags f);
+    };
+    // ########################################## BLACKCAPTURE DECLARATION ENDS ############################################ //
+
+
+
+} /* namespace BlackLib */
+
+#endif /* BLACKCAPTURE_H_ */
@@ -38,6 +38,7 @@
 
 #include <cstring>
 #include <string>
+#include <cstdint>
 #include <sstream>          // need for tostr() function
 #include <cstdio>           // need for popen() function in BlackCore::executeShellCmd()
 #include <dirent.h>         // need for dirent struct in BlackCore::searchDirectory()
@@ -67,6 +68,117 @@ namespace BlackLib
 
 
 
+    /*! @brief Holds the write counters of shadow register layer.
+    *
+    * The classes which use BlackShadowRegister, fill this struct for reporting how many sysfs writes
+    * are done and how many of them are avoided.
+    */
+    struct BlackShadowStatistics
+    {
+        uint64_t requestCount;          /*!< @brief is used to hold the number of setter calls */
+        uint64_t writeCount;            /*!< @brief is used to hold the number of done file writes */
+        uint64_t unchangedCount;        /*!< @brief is used to hold the number of skipped writes, because of unchanged value */
+        uint64_t coalescedCount;        /*!< @brief is used to hold the number of pending values which are overwritten before commit */
+
+        /*! @brief BlackShadowStatistics struct's constructor.
+        *
+        *  This function clears all counters.
+        */
+        BlackShadowStatistics()
+        {
+            requestCount    = 0;
+            writeCount      = 0;
+            unchangedCount  = 0;
+            coalescedCount  = 0;
+        }
+
+        /*! @brief Exports number of avoided writes.
+        *
+        *  @return sum of unchanged and coalesced write counts.
+        */
+        uint64_t getAvoidedCount() const
+        {
+            return (unchangedCount + coalescedCount);
+        }
+    };
+
+
+
+    /*! @brief Holds the last written and pending values of a sysfs attribute.
+    *
+    * This template doesn't access any file. It only remembers the value which is written to file last time
+    * and the value which is waiting for commit. The owner class decides writing by using these values.
+    *
+    * @tparam T type of attribute value.
+    */
+    template <typename T>
+    class BlackShadowRegister
+    {
+        private:
+            T       lastValue;              /*!< @brief is used to hold the last written value */
+            T       pendingValue;           /*!< @brief is used to hold the value which is waiting for commit */
+            bool    isLastValueKnown;       /*!< @brief is used to hold the validity of last written value */
+            bool    isPendingValue;         /*!< @brief is used to hold the existence of pending value */
+
+        public:
+            BlackShadowRegister() : lastValue(), pendingValue(), isLastValueKnown(false), isPendingValue(false)
+            {
+            }
+
+            /*! @brief Checks the value is equal to last written value or not.
+            *
+            *  @return True if last written value is known and equal to input value, else false.
+            */
+            bool    isUnchanged(const T &value) const
+            {
+                return (this->isLastValueKnown and this->lastValue == value);
+            }
+
+            /*! @brief Saves value as pending value.
+            *
+            *  If there is a pending value already, coalesced counter of statistics is increased.
+            */
+            void    setPending(const T &value, BlackShadowStatistics &statistics)
+            {
+                if( this->isPendingValue )
+                {
+                    statistics.coalescedCount++;
+                }
+
+                this->pendingValue      = value;
+                this->isPendingValue    = true;
+            }
+
+            /*! @brief Saves value as last written value.
+            */
+            void    setWritten(const T &value)
+            {
+                this->lastValue         = value;
+                this->isLastValueKnown  = true;
+            }
+
+            /*! @brief Forgets last written value, so the next write can not be skipped.
+            */
+            void    invalidate()
+            {
+                this->isLastValueKnown  = false;
+            }
+
+            /*! @brief Clears pending value.
+            */
+            void    clearPending()
+            {
+                this->isPendingValue    = false;
+            }
+
+            bool        hasPending() const      { return this->isPendingValue;      }
+            bool        isKnown() const         { return this->isLastValueKnown;    }
+            const T&    getPending() const      { return this->pendingValue;        }
+            const T&    getLast() const         { return this->lastValue;           }
+    };
+
+
+
 
 
     // ########################################### BLACKCORE DECLARATION STARTS ########################################### //
@@ -78,6 +78,15 @@ namespace BlackLib
                             };
 
 
+    /*!
+     * This enum is used for selecting write mode of sysfs attributes (like BlackPWM::setWriteMode() function).
+     */
+    enum writeMode          {   DirectWrite             = 0,    /*!< every setter call is written to file */
+                                ShadowWrite             = 1,    /*!< setter calls which don't change the last written value are skipped */
+                                DeferredWrite           = 2     /*!< setter calls are held until commit() call, then only changed values are written */
+                            };
+
+
 
 
 
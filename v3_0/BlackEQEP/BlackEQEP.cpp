@@ -0,0 +1,363 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackEQEP.h"
+#include "../BlackTime/BlackTime.h"
+
+
+namespace BlackLib
+{
+
+    // eQEP register offsets from start of pwm subsystem
+    static const uint32_t   EQEP_OFFSET             = 0x180;
+    static const uint32_t   EQEP_QPOSCNT            = EQEP_OFFSET + 0x00;
+    static const uint32_t   EQEP_QPOSINIT           = EQEP_OFFSET + 0x04;
+    static const uint32_t   EQEP_QPOSMAX            = EQEP_OFFSET + 0x08;
+    static const uint32_t   EQEP_QPOSILAT           = EQEP_OFFSET + 0x10;
+    static const uint32_t   EQEP_QPOSLAT            = EQEP_OFFSET + 0x18;
+    static const uint32_t   EQEP_QUTMR              = EQEP_OFFSET + 0x1C;
+    static const uint32_t   EQEP_QUPRD              = EQEP_OFFSET + 0x20;
+    static const uint32_t   EQEP_QDECCTL            = EQEP_OFFSET + 0x28;
+    static const uint32_t   EQEP_QEPCTL             = EQEP_OFFSET + 0x2A;
+    static const uint32_t   EQEP_QEINT              = EQEP_OFFSET + 0x30;
+    static const uint32_t   EQEP_QFLG               = EQEP_OFFSET + 0x32;
+    static const uint32_t   EQEP_QCLR               = EQEP_OFFSET + 0x34;
+
+    static const uint32_t   PWMSS_EQEPCLK_EN        = 0x0010;
+
+    // QEPCTL: FREE_SOFT free run, PCRM reset at max position, IEL latch at rising index, QPEN, QCLM latch at unit time
+    static const uint16_t   QEPCTL_CONFIG           = 0xC000 | 0x1000 | 0x0010 | 0x0008 | 0x0004;
+    static const uint16_t   QEPCTL_UTE              = 0x0002;
+    static const uint16_t   QFLG_IEL                = 0x0400;
+    static const uint16_t   QFLG_UTO                = 0x0800;
+
+
+    // ########################################### BLACKEQEP DEFINITION STARTS ############################################ //
+
+    BlackEQEP::BlackEQEP(eqepName eqep, uint64_t unitTime, timeType tType)
+    {
+        const off_t baseAddress[3] = { PWMSS0_BASE_ADDRESS, PWMSS1_BASE_ADDRESS, PWMSS2_BASE_ADDRESS };
+
+        this->eqepErrors        = new errorEQEP();
+        this->eqepModule        = eqep;
+        this->clockFrequency    = EQEP_DEFAULT_CLOCK;
+        this->unitTimeNs        = 0;
+        this->lastLatchedPosition = 0;
+        this->isLatchValid      = false;
+        this->velocityCount     = 0;
+        this->isVelocityValid   = false;
+
+        if( this->registerMap.open(DEV_MEM_PATH, baseAddress[eqep], PWMSS_MAP_SIZE) )
+        {
+            this->initialize(unitTime, tType);
+        }
+        else
+        {
+            this->eqepErrors->mapError = true;
+        }
+    }
+
+    BlackEQEP::BlackEQEP(eqepName eqep, const std::string &registerImagePath, uint64_t unitTime, timeType tType)
+    {
+        this->eqepErrors        = new errorEQEP();
+        this->eqepModule        = eqep;
+        this->clockFrequency    = EQEP_DEFAULT_CLOCK;
+        this->unitTimeNs        = 0;
+        this->lastLatchedPosition = 0;
+        this->isLatchValid      = false;
+        this->velocityCount     = 0;
+        this->isVelocityValid   = false;
+
+        if( this->registerMap.open(registerImagePath, 0, PWMSS_MAP_SIZE) )
+        {
+            this->initialize(unitTime, tType);
+        }
+        else
+        {
+            this->eqepErrors->mapError = true;
+        }
+    }
+
+    BlackEQEP::~BlackEQEP()
+    {
+        delete this->eqepErrors;
+    }
+
+    void        BlackEQEP::initialize(uint64_t unitTime, timeType tType)
+    {
+        uint32_t clockConfig = this->registerMap.read32(PWMSS_CLKCONFIG_OFFSET);
+        this->registerMap.write32(PWMSS_CLKCONFIG_OFFSET, clockConfig | PWMSS_EQEPCLK_EN);
+
+        this->registerMap.write16(EQEP_QEPCTL,   0x0000);
+        this->registerMap.write16(EQEP_QDECCTL,  0x0000);
+        this->registerMap.write16(EQEP_QEINT,    0x0000);
+        this->registerMap.write32(EQEP_QPOSINIT, 0x00000000);
+        this->registerMap.write32(EQEP_QPOSMAX,  0xFFFFFFFF);
+        this->registerMap.write16(EQEP_QCLR,     0xFFFF);
+        this->registerMap.write16(EQEP_QEPCTL,   QEPCTL_CONFIG);
+
+        this->setUnitTime(unitTime, tType);
+    }
+
+    bool        BlackEQEP::updateVelocity()
+    {
+        if( this->registerMap.read16(EQEP_QFLG) & QFLG_UTO )
+        {
+            uint32_t latchedPosition = this->registerMap.read32(EQEP_QPOSLAT);
+            this->registerMap.write16(EQEP_QCLR, QFLG_UTO);
+
+            if( this->isLatchValid )
+            {
+                this->velocityCount     = static_cast<int32_t>(latchedPosition - this->lastLatchedPosition);
+                this->isVelocityValid   = true;
+            }
+
+            this->lastLatchedPosition   = latchedPosition;
+            this->isLatchValid          = true;
+        }
+
+        this->eqepErrors->velocityError = not this->isVelocityValid;
+        return this->isVelocityValid;
+    }
+
+
+
+    int32_t     BlackEQEP::getPosition() const
+    {
+        return static_cast<int32_t>( this->registerMap.read32(EQEP_QPOSCNT) );
+    }
+
+    void        BlackEQEP::setPosition(int32_t position)
+    {
+        this->registerMap.write32(EQEP_QPOSCNT, static_cast<uint32_t>(position));
+        this->isLatchValid      = false;
+        this->isVelocityValid   = false;
+    }
+
+    int32_t     BlackEQEP::getVelocityCount()
+    {
+        if( not this->updateVelocity() )
+        {
+            return 0;
+        }
+
+        return this->velocityCount;
+    }
+
+    float       BlackEQEP::getVelocity()
+    {
+        if( not this->updateVelocity() )
+        {
+            return 0.0;
+        }
+
+        return static_cast<float>( static_cast<double>(this->velocityCount) * 1000000000.0 / this->unitTimeNs );
+    }
+
+    bool        BlackEQEP::setUnitTime(uint64_t unitTime, timeType tType)
+    {
+        uint64_t newUnitTime;
+
+        switch( tType )
+        {
+            case picosecond:    { newUnitTime = unitTime / 1000;            break; }
+            case microsecond:   { newUnitTime = unitTime * 1000;            break; }
+            case milisecond:    { newUnitTime = unitTime * 1000000;         break; }
+            case second:        { newUnitTime = unitTime * 1000000000ULL;   break; }
+            default:            { newUnitTime = unitTime;                   break; }
+        }
+
+        uint64_t period = newUnitTime * this->clockFrequency / 1000000000ULL;
+
+        if( period == 0 or period > 0xFFFFFFFFULL )
+        {
+            this->eqepErrors->outOfRange = true;
+            return false;
+        }
+
+        this->eqepErrors->outOfRange = false;
+
+        if( not this->registerMap.isOpen() )
+        {
+            return false;
+        }
+
+        uint16_t control = this->registerMap.read16(EQEP_QEPCTL);
+        this->registerMap.write16(EQEP_QEPCTL, control & ~QEPCTL_UTE);
+        this->registerMap.write32(EQEP_QUTMR, 0);
+        this->registerMap.write32(EQEP_QUPRD, static_cast<uint32_t>(period));
+        this->registerMap.write16(EQEP_QCLR,  QFLG_UTO);
+        this->registerMap.write16(EQEP_QEPCTL, control | QEPCTL_UTE);
+
+        this->unitTimeNs        = newUnitTime;
+        this->isLatchValid      = false;
+        this->isVelocityValid   = false;
+        return true;
+    }
+
+    uint64_t    BlackEQEP::getUnitTime()
+    {
+        return this->unitTimeNs;
+    }
+
+    int32_t     BlackEQEP::getIndexPosition() const
+    {
+        return static_cast<int32_t>( this->registerMap.read32(EQEP_QPOSILAT) );
+    }
+
+    bool        BlackEQEP::readIndexLatch(int32_t &position)
+    {
+        if( not (this->registerMap.read16(EQEP_QFLG) & QFLG_IEL) )
+        {
+            return false;
+        }
+
+        position = static_cast<int32_t>( this->registerMap.read32(EQEP_QPOSILAT) );
+        this->registerMap.write16(EQEP_QCLR, QFLG_IEL);
+        return true;
+    }
+
+
+
+    bool        BlackEQEP::fail()
+    {
+        return (this->eqepErrors->mapError or
+                this->eqepErrors->velocityError or
+                this->eqepErrors->outOfRange
+                );
+    }
+
+    bool        BlackEQEP::fail(BlackEQEP::flags f)
+    {
+        if(f==mapErr)           { return this->eqepErrors->mapError;        }
+        if(f==velocityErr)      { return this->eqepErrors->velocityError;   }
+        if(f==outOfRangeErr)    { return this->eqepErrors->outOfRange;      }
+
+        return true;
+    }
+
+    // ############################################ BLACKEQEP DEFINITION ENDS ############################################# //
+
+
+
+
+
+
+
+
+
+
+    // ######################################## BLACKEQEPSAMPLER DEFINITION STARTS ######################################## //
+
+    BlackEQEPSampler::BlackEQEPSampler(BlackEQEP *eqep, uint64_t interval, timeType tType, size_t bufferSize)
+        : BlackPeriodicThread(interval, tType)
+    {
+        size_t capacity = 2;
+        while( capacity < bufferSize )
+        {
+            capacity <<= 1;
+        }
+
+        this->eqepObject    = eqep;
+        this->ringBuffer.resize(capacity);
+        this->ringMask      = capacity - 1;
+        this->writeIndex    = 0;
+        this->readIndex     = 0;
+        this->droppedCount  = 0;
+    }
+
+    BlackEQEPSampler::~BlackEQEPSampler()
+    {
+    }
+
+    bool        BlackEQEPSampler::onTickHandler(uint64_t)
+    {
+        size_t currentWrite = this->writeIndex;
+
+        if( currentWrite - this->readIndex > this->ringMask )
+        {
+            this->droppedCount = this->droppedCount + 1;
+            return true;
+        }
+
+        // slot must be released by consumer before it is overwritten
+        __sync_synchronize();
+
+        BlackEQEPSample &sample = this->ringBuffer[currentWrite & this->ringMask];
+        sample.timestamp    = BlackTime::getMonotonicTime();
+        sample.position     = this->eqepObject->getPosition();
+
+        // sample must be visible before the index which publishes it
+        __sync_synchronize();
+        this->writeIndex = currentWrite + 1;
+
+        return true;
+    }
+
+    bool        BlackEQEPSampler::popSample(BlackEQEPSample &sample)
+    {
+        return ( this->popSamples(&sample, 1) == 1 );
+    }
+
+    size_t      BlackEQEPSampler::popSamples(BlackEQEPSample *samples, size_t maxCount)
+    {
+        size_t currentRead  = this->readIndex;
+        size_t available    = this->writeIndex - currentRead;
+        size_t count        = (available < maxCount) ? available : maxCount;
+
+        // index must be read before the samples which it publishes
+        __sync_synchronize();
+
+        for( size_t i = 0 ; i < count ; i++ )
+        {
+            samples[i] = this->ringBuffer[(currentRead + i) & this->ringMask];
+        }
+
+        // samples must be copied before their slots are released
+        __sync_synchronize();
+        this->readIndex = currentRead + count;
+
+        return count;
+    }
+
+    size_t      BlackEQEPSampler::getAvailableCount()
+    {
+        return ( this->writeIndex - this->readIndex );
+    }
+
+    uint64_t    BlackEQEPSampler::getDroppedCount()
+    {
+        return this->droppedCount;
+    }
+
+    // ######################################### BLACKEQEPSAMPLER DEFINITION ENDS ######################################### //
+
+} /* namespace BlackLib */
@@ -0,0 +1,345 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKEQEP_H_
+#define BLACKEQEP_H_
+
+#include "../BlackDef.h"
+#include "../BlackErr.h"
+#include "../BlackRegisterMap/BlackRegisterMap.h"
+#include "../BlackThread/BlackThread.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used to define eQEP module names.
+    */
+    enum eqepName           {   EQEP0                   = 0,    /*!< eQEP0 module, A/B/index pins are P9_42/P9_27/P9_41 */
+                                EQEP1                   = 1,    /*!< eQEP1 module, A/B/index pins are P8_35/P8_33/P8_31 */
+                                EQEP2                   = 2     /*!< eQEP2 module, A/B/index pins are P8_12/P8_11/P8_16 */
+                            };
+
+
+    const uint32_t          EQEP_DEFAULT_CLOCK          = 100000000;                //!< eQEP unit timer clock (SYSCLKOUT) frequency
+
+
+
+
+    // ########################################### BLACKEQEP DECLARATION STARTS ############################################ //
+
+    /*! @brief Reads quadrature encoders with AM335x eQEP modules.
+     *
+     *    This class maps the registers of pwm subsystem and configures its eQEP module to quadrature count
+     *    mode with free running 32 bit position counter. The unit timer of module latches position counter
+     *    at every unit time, and the index input latches position counter at every rising index edge. So
+     *    position, velocity and index position are read with single register reads.
+     *
+     *    The registers can be mapped from @b "/dev/mem" or from a file which holds image of the pwm
+     *    subsystem's 4 KB register area. The second one is useful for testing without hardware.
+     *
+     *    @warning The pwm subsystem module must be enabled (for example by loading a qep device tree) and
+     *    encoder pins must be muxed to eQEP mode before using this class. Otherwise register access causes
+     *    bus error.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myEncoderProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackEQEP/BlackEQEP.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackEQEP  myEncoder(BlackLib::EQEP2, 10, BlackLib::milisecond);
+     *
+     *      std::cout << "Position: " << myEncoder.getPosition() << std::endl;
+     *      BlackLib::BlackThread::msleep(20);
+     *      std::cout << "Velocity: " << myEncoder.getVelocity() << " counts/s" << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     * @code{.cpp}
+     *   // Possible Output:
+     *   // Position: 1024
+     *   // Velocity: 4000 counts/s
+     * @endcode
+     */
+    class BlackEQEP
+    {
+        private:
+            errorEQEP           *eqepErrors;            /*!< @brief is used to hold the errors of BlackEQEP class */
+            eqepName            eqepModule;             /*!< @brief is used to hold the selected eQEP module */
+            BlackRegisterMap    registerMap;            /*!< @brief is used to hold the mapped pwm subsystem registers */
+            uint32_t            clockFrequency;         /*!< @brief is used to hold the unit timer clock frequency */
+            uint64_t            unitTimeNs;             /*!< @brief is used to hold the unit time at nanosecond level */
+            uint32_t            lastLatchedPosition;    /*!< @brief is used to hold the last read unit time position latch */
+            bool                isLatchValid;           /*!< @brief is used to hold the validity of last read position latch */
+            int32_t             velocityCount;          /*!< @brief is used to hold the last calculated position change at one unit time */
+            bool                isVelocityValid;        /*!< @brief is used to hold the validity of last calculated velocity */
+
+            /*! @brief Configures eQEP module.
+            *
+            * This function enables eQEP clock of pwm subsystem, sets quadrature count mode, free running
+            * position counter, index latch at rising edge and unit time latch.
+            */
+            void                initialize(uint64_t unitTime, timeType tType);
+
+            /*! @brief Reads new unit time latch if there is.
+            *
+            * @return True if velocity value is valid, else false.
+            */
+            bool                updateVelocity();
+
+        public:
+            /*!
+            * This enum is used to define EQEP debugging flags.
+            */
+            enum flags          {   mapErr          = 0,    /*!< enumeration for @a errorEQEP::mapError status */
+                                    velocityErr     = 1,    /*!< enumeration for @a errorEQEP::velocityError status */
+                                    outOfRangeErr   = 2     /*!< enumeration for @a errorEQEP::outOfRange status */
+                                };
+
+            /*! @brief Constructor of BlackEQEP class.
+            *
+            * This function maps the pwm subsystem of selected eQEP module from @b "/dev/mem" and configures
+            * the eQEP module.
+            * @param [in] eqep       eQEP module name (enum)
+            * @param [in] unitTime   velocity calculation period
+            * @param [in] tType      time type of unit time(enum)
+            *
+            * @sa eqepName
+            */
+                                BlackEQEP(eqepName eqep, uint64_t unitTime = 10, timeType tType = milisecond);
+
+            /*! @brief Constructor of BlackEQEP class.
+            *
+            * This function maps the entered register image file instead of @b "/dev/mem". The file must be
+            * at least 4 KB and it must hold the register area of pwm subsystem from its beginning.
+            * @param [in] eqep               eQEP module name (enum)
+            * @param [in] registerImagePath  register image file path
+            * @param [in] unitTime           velocity calculation period
+            * @param [in] tType              time type of unit time(enum)
+            */
+                                BlackEQEP(eqepName eqep, const std::string &registerImagePath, uint64_t unitTime = 10, timeType tType = milisecond);
+
+            /*! @brief Destructor of BlackEQEP class.
+            *
+            * This function unmaps registers and deletes errorEQEP struct pointer. eQEP module keeps running.
+            */
+            virtual             ~BlackEQEP();
+
+            /*! @brief Reads position counter.
+            *
+            * @return position counter value. Counter is free running, so it is interpreted as signed value.
+            */
+            int32_t             getPosition() const;
+
+            /*! @brief Changes position counter.
+            *
+            * @param [in] position   new position counter value
+            */
+            void                setPosition(int32_t position);
+
+            /*! @brief Reads position change at the last complete unit time.
+            *
+            * Unit timer latches position counter at every unit time. This function compares the newest latch
+            * with the previous one which is seen by this function. So it must be called at least once in every
+            * unit time; otherwise the result covers more than one unit time.
+            * @return position change in counts per unit time, or 0 if there isn't two latches yet.
+            */
+            int32_t             getVelocityCount();
+
+            /*! @brief Reads velocity at the last complete unit time.
+            *
+            * @return velocity in counts per second, or 0.0 if there isn't two latches yet.
+            * @sa getVelocityCount()
+            */
+            float               getVelocity();
+
+            /*! @brief Changes unit time of velocity calculation.
+            *
+            * @param [in] unitTime   new unit time
+            * @param [in] tType      time type of unit time(enum)
+            * @return True if unit time is in range of 32 bit unit timer period, else false.
+            */
+            bool                setUnitTime(uint64_t unitTime, timeType tType = milisecond);
+
+            /*! @brief Exports unit time of velocity calculation.
+            *
+            * @return unit time at nanosecond level.
+            */
+            uint64_t            getUnitTime();
+
+            /*! @brief Reads position which is latched at last index event.
+            *
+            * @return index latch register value.
+            */
+            int32_t             getIndexPosition() const;
+
+            /*! @brief Reads position which is latched at index event, if a new index event is occured.
+            *
+            * This function checks index event flag. If it is set, the function reads index latch register and
+            * clears the flag.
+            * @param [out] position  index latch register value
+            * @return True if there is a new index event, else false.
+            */
+            bool                readIndexLatch(int32_t &position);
+
+            /*! @brief Is used for general debugging.
+            *
+            * @return True if any error occured, else false.
+            *
+            * @sa errorEQEP
+            */
+            bool                fail();
+
+            /*! @brief Is used for specific debugging.
+            *
+            * @param [in] f specific error type (enum)
+            * @return Value of @a selected error.
+            *
+            * @sa errorEQEP
+            */
+            bool                fail(BlackEQEP::flags f);
+    };
+    // ############################################ BLACKEQEP DECLARATION ENDS ############################################# //
+
+
+
+
+
+
+
+
+
+
+    /*! @brief Holds one position sample of BlackEQEPSampler class.
+     */
+    struct BlackEQEPSample
+    {
+        uint64_t    timestamp;                  /*!< @brief is used to hold the monotonic sampling time at nanosecond level */
+        int32_t     position;                   /*!< @brief is used to hold the position counter value */
+    };
+
+
+
+
+    // ######################################## BLACKEQEPSAMPLER DECLARATION STARTS ######################################## //
+
+    /*! @brief Streams eQEP position to a ring buffer at fixed rate.
+     *
+     *    This class is derived from BlackPeriodicThread class. At every tick it reads position counter of
+     *    BlackEQEP object with one register read and pushes it to a single producer single consumer ring
+     *    buffer. Consumer thread (for example control loop) pops the samples without locking. If ring buffer
+     *    is full, new sample is dropped and counted.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  BlackLib::BlackEQEP         myEncoder(BlackLib::EQEP2);
+     *  BlackLib::BlackEQEPSampler  mySampler(&myEncoder, 500, BlackLib::microsecond, 1024);
+     *
+     *  mySampler.run();
+     *
+     *  BlackLib::BlackEQEPSample   samples[64];
+     *  size_t count = mySampler.popSamples(samples, 64);
+     *
+     *  mySampler.requestStop();
+     *  WAIT_THREAD_FINISH(&mySampler)
+     * @endcode
+     */
+    class BlackEQEPSampler : public BlackPeriodicThread
+    {
+        public:
+            /*! @brief Constructor of BlackEQEPSampler class.
+            *
+            * @param [in] eqep           sampled BlackEQEP object
+            * @param [in] interval       sampling interval
+            * @param [in] tType          time type of sampling interval(enum)
+            * @param [in] bufferSize     ring buffer capacity, rounded up to power of two
+            */
+                                BlackEQEPSampler(BlackEQEP *eqep, uint64_t interval, timeType tType = microsecond, size_t bufferSize = 1024);
+
+            /*! @brief Destructor of BlackEQEPSampler class.
+            */
+            virtual             ~BlackEQEPSampler();
+
+            /*! @brief Pops the oldest sample from ring buffer.
+            *
+            * @param [out] sample    popped sample
+            * @return True if there is a sample, else false.
+            */
+            bool                popSample(BlackEQEPSample &sample);
+
+            /*! @brief Pops the oldest samples from ring buffer.
+            *
+            * @param [out] samples   destination array
+            * @param [in] maxCount   capacity of destination array
+            * @return number of popped samples.
+            */
+            size_t              popSamples(BlackEQEPSample *samples, size_t maxCount);
+
+            /*! @brief Exports number of samples at ring buffer.
+            */
+            size_t              getAvailableCount();
+
+            /*! @brief Exports number of dropped samples because of full ring buffer.
+            */
+            uint64_t            getDroppedCount();
+
+        private:
+            BlackEQEP           *eqepObject;            /*!< @brief is used to hold the sampled BlackEQEP object */
+            std::vector<BlackEQEPSample> ringBuffer;    /*!< @brief is used to hold the samples */
+            size_t              ringMask;               /*!< @brief is used to hold the ring buffer index mask */
+            volatile size_t     writeIndex;             /*!< @brief is used to hold the producer index, written only by sampler thread */
+            volatile size_t     readIndex;              /*!< @brief is used to hold the consumer index, written only by consumer thread */
+            volatile uint64_t   droppedCount;           /*!< @brief is used to hold the number of dropped samples */
+
+            /*! @brief Reads position and pushes it to ring buffer.
+            */
+            bool                onTickHandler(uint64_t tick);
+    };
+    // ######################################### BLACKEQEPSAMPLER DECLARATION ENDS ######################################### //
+
+
+
+} /* namespace BlackLib */
+
+#endif /* BLACKEQEP_H_ */
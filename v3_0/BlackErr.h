@@ -451,6 +451,217 @@ namespace BlackLib
 
 
 
+
+    /*! @brief Holds BlackPWMChip errors.
+     *
+     *    This struct holds errors of pwm outputs which are controlled over the generic pwm
+     *    class (/sys/class/pwm) interface.
+     */
+    struct errorPWMChip
+    {
+        /*! @brief @b pwmchip directory finding error.
+        *
+        *  Its value can change, when resolving pwmchip of selected pwm output, at@n
+        *  @li BlackPWMChip()
+        *
+        *  function in BlackPWMChip class.
+        *  @sa BlackPWMChip::BlackPWMChip()
+        */
+        bool chipError;
+
+        /*! @brief @b Export @b file opening error.
+        *
+        *  Its value can change, when exporting pwm channel, at@n
+        *  @li BlackPWMChip()
+        *
+        *  function in BlackPWMChip class.
+        *  @sa BlackPWMChip::BlackPWMChip()
+        */
+        bool exportError;
+
+        /*! @brief @b Period @b file reading/writing error.
+        *
+        *  Its value can change, when accessing pwm's period file, at@n
+        *  @li getPeriodValue()
+        *  @li getNumericPeriodValue()
+        *  @li setPeriodTime()
+        *
+        *  functions in BlackPWMChip class.
+        *  @sa BlackPWMChip::getPeriodValue()
+        *  @sa BlackPWMChip::getNumericPeriodValue()
+        *  @sa BlackPWMChip::setPeriodTime()
+        */
+        bool periodFileError;
+
+        /*! @brief @b Duty @b cycle @b file reading/writing error.
+        *
+        *  Its value can change, when accessing pwm's duty_cycle file, at@n
+        *  @li getDutyValue()
+        *  @li getNumericDutyValue()
+        *  @li setDutyPercent()
+        *  @li setSpaceRatioTime()
+        *  @li setLoadRatioTime()
+        *
+        *  functions in BlackPWMChip class.
+        *  @sa BlackPWMChip::getDutyValue()
+        *  @sa BlackPWMChip::getNumericDutyValue()
+        *  @sa BlackPWMChip::setDutyPercent()
+        *  @sa BlackPWMChip::setSpaceRatioTime()
+        *  @sa BlackPWMChip::setLoadRatioTime()
+        */
+        bool dutyFileError;
+
+        /*! @brief @b Enable @b file reading/writing error.
+        *
+        *  Its value can change, when accessing pwm's enable file, at@n
+        *  @li getRunValue()
+        *  @li setRunState()
+        *
+        *  functions in BlackPWMChip class.
+        *  @sa BlackPWMChip::getRunValue()
+        *  @sa BlackPWMChip::setRunState()
+        */
+        bool enableFileError;
+
+        /*! @brief @b Polarity @b file reading/writing error.
+        *
+        *  Its value can change, when accessing pwm's polarity file, at@n
+        *  @li getPolarityValue()
+        *  @li setPolarity()
+        *
+        *  functions in BlackPWMChip class.
+        *  @sa BlackPWMChip::getPolarityValue()
+        *  @sa BlackPWMChip::setPolarity()
+        */
+        bool polarityFileError;
+
+        /*! @brief Out of range value error.
+        *
+        *  Its value can change, when setting some variables of pwm, at@n
+        *  @li setDutyPercent()
+        *  @li setPeriodTime()
+        *  @li setSpaceRatioTime()
+        *  @li setLoadRatioTime()
+        *
+        *  functions in BlackPWMChip class.
+        */
+        bool outOfRange;
+
+        /*! @brief errorPWMChip struct's constructor.
+         *
+         *  This function clears all flags.
+         */
+        errorPWMChip()
+        {
+            chipError           = false;
+            exportError         = false;
+            periodFileError     = false;
+            dutyFileError       = false;
+            enableFileError     = false;
+            polarityFileError   = false;
+            outOfRange          = false;
+        }
+    };
+
+
+
+
+    /*! @brief Holds BlackCapture errors.
+     *
+     *    This struct holds errors of eCAP modules which are accessed over memory-mapped registers.
+     */
+    struct errorCapture
+    {
+        /*! @brief @b Register @b mapping error.
+        *
+        *  Its value can change, when mapping registers of eCAP module, at@n
+        *  @li BlackCapture()
+        *
+        *  function in BlackCapture class.
+        *  @sa BlackCapture::BlackCapture()
+        */
+        bool mapError;
+
+        /*! @brief @b Capture @b value error.
+        *
+        *  Its value can change, when there isn't enough captured edges for calculation, at@n
+        *  @li readCapture()
+        *  @li getPeriodTime()
+        *  @li getHighTime()
+        *  @li getFrequency()
+        *  @li getDutyPercent()
+        *
+        *  functions in BlackCapture class.
+        *  @sa BlackCapture::readCapture()
+        */
+        bool captureError;
+
+        /*! @brief errorCapture struct's constructor.
+         *
+         *  This function clears all flags.
+         */
+        errorCapture()
+        {
+            mapError        = false;
+            captureError    = false;
+        }
+    };
+
+
+
+
+    /*! @brief Holds BlackEQEP errors.
+     *
+     *    This struct holds errors of eQEP modules which are accessed over memory-mapped registers.
+     */
+    struct errorEQEP
+    {
+        /*! @brief @b Register @b mapping error.
+        *
+        *  Its value can change, when mapping registers of eQEP module, at@n
+        *  @li BlackEQEP()
+        *
+        *  function in BlackEQEP class.
+        *  @sa BlackEQEP::BlackEQEP()
+        */
+        bool mapError;
+
+        /*! @brief @b Velocity @b calculation error.
+        *
+        *  Its value can change, when there isn't two position latches for calculation, at@n
+        *  @li getVelocity()
+        *  @li getVelocityCount()
+        *
+        *  functions in BlackEQEP class.
+        *  @sa BlackEQEP::getVelocity()
+        */
+        bool velocityError;
+
+        /*! @brief Out of range value error.
+        *
+        *  Its value can change, when setting unit time, at@n
+        *  @li setUnitTime()
+        *
+        *  function in BlackEQEP class.
+        *  @sa BlackEQEP::setUnitTime()
+        */
+        bool outOfRange;
+
+        /*! @brief errorEQEP struct's constructor.
+         *
+         *  This function clears all flags.
+         */
+        errorEQEP()
+        {
+            mapError        = false;
+            velocityError   = false;
+            outOfRange      = false;
+        }
+    };
+
+
+
+
     /*! @brief Holds BlackCoreGPIO errors.
      *
      *    This struct holds GPIO core errors and includes pointer of errorCore struct.
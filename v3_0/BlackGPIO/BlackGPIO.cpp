@@ -173,6 +173,7 @@ namespace BlackLib
         this->workMode      = wm;
         this->gpioErrors    = new errorGPIO( this->getErrorsFromCoreGPIO() );
         this->valuePath     = this->getValueFilePath();
+        this->gpioWriteMode = DirectWrite;
     }
 
     BlackGPIO::~BlackGPIO()
@@ -308,29 +309,19 @@ namespace BlackLib
         return this->pinDirection;
     }
 
-    bool        BlackGPIO::setValue(digitalValue status)
+    bool        BlackGPIO::writeToFile(digitalValue status)
     {
-        if( !(this->pinDirection == output) )
-        {
-            this->gpioErrors->writeError = true;
-            this->gpioErrors->forcingError = true;
-            return false;
-        }
-
-
-
-        this->gpioErrors->forcingError = false;
-
         if( this->workMode == SecureMode )
         {
             if( ! this->isReady())
             {
                 this->gpioErrors->writeError = true;
+                this->valueShadow.invalidate();
                 return false;
             }
         }
 
-
+        this->shadowStatistics.writeCount++;
 
         std::ofstream valueFile;
         valueFile.open(this->valuePath.c_str(), std::ios::out);
@@ -338,6 +329,7 @@ namespace BlackLib
         {
             valueFile.close();
             this->gpioErrors->writeError = true;
+            this->valueShadow.invalidate();
             return false;
         }
         else
@@ -353,11 +345,45 @@ namespace BlackLib
 
             valueFile.close();
             this->gpioErrors->writeError = false;
+            this->valueShadow.setWritten(static_cast<int>(status));
             return true;
         }
     }
 
+    bool        BlackGPIO::requestWrite(digitalValue status)
+    {
+        this->shadowStatistics.requestCount++;
+
+        if( this->gpioWriteMode == DeferredWrite )
+        {
+            this->valueShadow.setPending(static_cast<int>(status), this->shadowStatistics);
+            return true;
+        }
+
+        if( this->gpioWriteMode == ShadowWrite and this->valueShadow.isUnchanged(static_cast<int>(status)) )
+        {
+            this->shadowStatistics.unchangedCount++;
+            return true;
+        }
+
+        return this->writeToFile(status);
+    }
+
+    bool        BlackGPIO::setValue(digitalValue status)
+    {
+        if( !(this->pinDirection == output) )
+        {
+            this->gpioErrors->writeError = true;
+            this->gpioErrors->forcingError = true;
+            return false;
+        }
+
+
+
+        this->gpioErrors->forcingError = false;
 
+        return this->requestWrite(status);
+    }
 
     bool        BlackGPIO::isHigh()
     {
@@ -373,7 +399,11 @@ namespace BlackLib
         else
         {
             this->gpioErrors->forcingError = false;
-            if( (this->getNumericValue() == 1) )
+            if( this->valueShadow.hasPending() )
+            {
+                this->setValue( (this->valueShadow.getPending() == 1) ? low : high );
+            }
+            else if( (this->getNumericValue() == 1) )
             {
                 this->setValue(low);
             }
@@ -395,6 +425,55 @@ namespace BlackLib
         return this->workMode;
     }
 
+    void        BlackGPIO::setWriteMode(writeMode mode)
+    {
+        if( this->gpioWriteMode == DeferredWrite and mode != DeferredWrite )
+        {
+            this->commit();
+        }
+
+        this->gpioWriteMode = mode;
+    }
+
+    writeMode   BlackGPIO::getWriteMode()
+    {
+        return this->gpioWriteMode;
+    }
+
+    bool        BlackGPIO::commit()
+    {
+        if( not this->valueShadow.hasPending() )
+        {
+            return true;
+        }
+
+        int value = this->valueShadow.getPending();
+        this->valueShadow.clearPending();
+
+        if( this->valueShadow.isUnchanged(value) )
+        {
+            this->shadowStatistics.unchangedCount++;
+            return true;
+        }
+
+        return this->writeToFile( (value == 1) ? high : low );
+    }
+
+    BlackShadowStatistics BlackGPIO::getShadowStatistics()
+    {
+        return this->shadowStatistics;
+    }
+
+    void        BlackGPIO::resetShadowStatistics()
+    {
+        this->shadowStatistics = BlackShadowStatistics();
+    }
+
+    void        BlackGPIO::invalidateShadow()
+    {
+        this->valueShadow.invalidate();
+    }
+
 
 
     bool        BlackGPIO::fail()
@@ -506,40 +585,8 @@ namespace BlackLib
 
         this->gpioErrors->forcingError = false;
 
-        if( this->workMode == SecureMode )
-        {
-            if( ! this->isReady())
-            {
-                this->gpioErrors->writeError = true;
-                return *this;
-            }
-        }
-
-
-
-        std::ofstream valueFile;
-        valueFile.open(this->valuePath.c_str(), std::ios::out);
-        if(valueFile.fail())
-        {
-            valueFile.close();
-            this->gpioErrors->writeError = true;
-            return *this;
-        }
-        else
-        {
-            if( value == high )
-            {
-                valueFile << "1";
-            }
-            else
-            {
-                valueFile << "0";
-            }
-
-            valueFile.close();
-            this->gpioErrors->writeError = false;
-            return *this;
-        }
+        this->requestWrite(value);
+        return *this;
     }
 
 
@@ -310,6 +310,9 @@ namespace BlackLib
             direction       pinDirection;                   /*!< @brief is used to hold the selected GPIO pin direction */
             workingMode     workMode;                       /*!< @brief is used to hold the selected working mode */
             std::string     valuePath;                      /*!< @brief is used to hold the value file path */
+            writeMode       gpioWriteMode;                  /*!< @brief is used to hold the selected write mode */
+            BlackShadowRegister<int> valueShadow;           /*!< @brief is used to hold the last written and pending values of value file */
+            BlackShadowStatistics shadowStatistics;         /*!< @brief is used to hold the write counters of value shadow register */
 
             /*! @brief Checks the export state of GPIO pin.
             *
@@ -337,6 +340,23 @@ namespace BlackLib
             */
             bool            isReady();
 
+            /*! @brief Writes value to value file of GPIO pin.
+            *
+            * If working mode is selected SecureMode, this function checks pin ready state by calling isReady()
+            * function before writing. Then it writes value and saves it to value shadow register.
+            * @return True if writing is successful, else false.
+            */
+            bool            writeToFile(digitalValue status);
+
+            /*! @brief Handles value setting by selected write mode.
+            *
+            * At DirectWrite mode value is written to file. At ShadowWrite mode value is written to file
+            * only if it differs from the last written value. At DeferredWrite mode value is saved as
+            * pending value until commit() function call.
+            * @return True if value is written, skipped or saved as pending successfully, else false.
+            */
+            bool            requestWrite(digitalValue status);
+
 
         public:
 
@@ -617,6 +637,80 @@ namespace BlackLib
             */
             workingMode     getWorkingMode();
 
+            /*! @brief Changes write mode of value file.
+            *
+            * If write mode is changed from DeferredWrite to another mode, pending value is committed
+            * before changing.
+            * @param [in] mode new write mode(enum)
+            *
+            * @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackGPIO myGpio(BlackLib::GPIO_30, BlackLib::output, BlackLib::SecureMode);
+            *
+            *   myGpio.setWriteMode(BlackLib::ShadowWrite);
+            *   myGpio.setValue(BlackLib::high);
+            *   myGpio.setValue(BlackLib::high);        // not written, value is same
+            *
+            *   std::cout << "Avoided writes: " << myGpio.getShadowStatistics().getAvoidedCount() << std::endl;
+            *  @endcode
+            *  @code{.cpp}
+            *   // Possible Output:
+            *   // Avoided writes: 1
+            *  @endcode
+            *
+            * @sa writeMode
+            */
+            void            setWriteMode(writeMode mode);
+
+            /*! @brief Exports write mode of value file.
+            *
+            *  @return BlackLib::writeMode variable.
+            */
+            writeMode       getWriteMode();
+
+            /*! @brief Writes pending value to value file.
+            *
+            * This function is the commit point of DeferredWrite mode. Only the last value since previous
+            * commit is written and if it is equal to last written value, writing is skipped. Getter functions
+            * read value file, so they don't see pending value until this function is called.
+            * @return True if there is no need to write or writing is successful, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackGPIO myGpio(BlackLib::GPIO_30, BlackLib::output, BlackLib::FastMode);
+            *
+            *   myGpio.setWriteMode(BlackLib::DeferredWrite);
+            *   myGpio.setValue(BlackLib::high);
+            *   myGpio.setValue(BlackLib::low);
+            *   myGpio.setValue(BlackLib::high);
+            *   myGpio.commit();                        // writes value file only once
+            *
+            *   std::cout << "Written: " << myGpio.getShadowStatistics().writeCount << std::endl;
+            *  @endcode
+            *  @code{.cpp}
+            *   // Possible Output:
+            *   // Written: 1
+            *  @endcode
+            */
+            bool            commit();
+
+            /*! @brief Exports write counters of value shadow register.
+            *
+            *  @return BlackShadowStatistics struct.
+            */
+            BlackShadowStatistics getShadowStatistics();
+
+            /*! @brief Clears write counters of value shadow register.
+            */
+            void            resetShadowStatistics();
+
+            /*! @brief Forgets the last written value.
+            *
+            * If value file can be changed by another process, this function can be used for forcing the
+            * next setValue() call to write file.
+            */
+            void            invalidateShadow();
+
 
             /*! @brief Is used for general debugging.
             *
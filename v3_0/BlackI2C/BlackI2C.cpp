@@ -35,12 +35,16 @@
 namespace BlackLib
 {
 
+    pthread_mutex_t BlackI2C::descriptorMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
     BlackI2C::BlackI2C(i2cName i2c, unsigned int i2cDeviceAddress)
     {
         this->i2cPortPath   = "/dev/i2c-" + tostr(static_cast<int>(i2c));
         this->i2cDevAddress = i2cDeviceAddress;
         this->i2cFD         = -1;
         this->isOpenFlag    = false;
+        this->descriptor    = NULL;
 
         this->i2cErrors     = new errorI2C( this->getErrorsFromCore() );
     }
@@ -77,18 +81,50 @@ namespace BlackLib
 
     bool    BlackI2C::setSlave()
     {
+        if( this->descriptor != NULL and this->descriptor->boundAddress == static_cast<int>(this->i2cDevAddress) )
+        {
+            this->statistics.skippedBindCount++;
+            this->i2cErrors->setSlaveError = false;
+            return true;
+        }
+
+        this->statistics.bindCount++;
+
         if( ::ioctl(this->i2cFD, I2C_SLAVE, this->i2cDevAddress) < 0)
         {
+            if( this->descriptor != NULL ) { this->descriptor->boundAddress = -1; }
             this->i2cErrors->setSlaveError = true;
             return false;
         }
         else
         {
+            if( this->descriptor != NULL ) { this->descriptor->boundAddress = static_cast<int>(this->i2cDevAddress); }
             this->i2cErrors->setSlaveError = false;
             return true;
         }
     }
 
+    void    BlackI2C::lockDescriptor()
+    {
+        if( this->descriptor != NULL ) { pthread_mutex_lock( &(this->descriptor->mutex) ); }
+    }
+
+    void    BlackI2C::unlockDescriptor()
+    {
+        if( this->descriptor != NULL ) { pthread_mutex_unlock( &(this->descriptor->mutex) ); }
+    }
+
+    bool    BlackI2C::submitMessages(BlackI2CTransaction &transaction)
+    {
+        transaction.setOwnAddress( static_cast<uint16_t>(this->i2cDevAddress) );
+
+        i2c_rdwr_ioctl_data package;
+        package.msgs    = transaction.getMessages();
+        package.nmsgs   = static_cast<uint32_t>(transaction.getMessageCount());
+
+        return ( ::ioctl(this->i2cFD, I2C_RDWR, &package) == static_cast<int>(package.nmsgs) );
+    }
+
     bool    BlackI2C::loadDeviceTree()
     {
         return false;
@@ -109,6 +145,7 @@ namespace BlackLib
         if( (openMode & Truncate)   == Truncate     ){  flags |= O_TRUNC;   }
         if( (openMode & NonBlock)   == NonBlock     ){  flags |= O_NONBLOCK;}
 
+        if( this->descriptor != NULL ) { this->close(); }
 
         this->i2cFD = ::open(this->i2cPortPath.c_str(), flags);
 
@@ -121,6 +158,14 @@ namespace BlackLib
         }
         else
         {
+            this->descriptor                = new sharedDescriptor;
+            this->descriptor->fd            = this->i2cFD;
+            this->descriptor->boundAddress  = -1;
+            this->descriptor->userCount     = 1;
+            this->descriptor->functions     = 0;
+            ::ioctl(this->i2cFD, I2C_FUNCS, &(this->descriptor->functions));
+            pthread_mutex_init( &(this->descriptor->mutex), NULL );
+
             this->isOpenFlag = true;
             this->i2cErrors->openError = false;
             this->setSlave();
@@ -128,9 +173,62 @@ namespace BlackLib
         }
     }
 
+    bool    BlackI2C::open(BlackI2C &owner)
+    {
+        if( &owner == this ) { return this->isOpenFlag; }
+
+        if( this->descriptor != NULL ) { this->close(); }
+
+        pthread_mutex_lock( &descriptorMutex );
+        if( owner.descriptor == NULL )
+        {
+            pthread_mutex_unlock( &descriptorMutex );
+            this->isOpenFlag = false;
+            this->i2cErrors->openError = true;
+            return false;
+        }
+
+        this->descriptor = owner.descriptor;
+        this->descriptor->userCount++;
+        pthread_mutex_unlock( &descriptorMutex );
+
+        this->i2cFD         = this->descriptor->fd;
+        this->i2cPortPath   = owner.i2cPortPath;
+        this->isOpenFlag    = true;
+        this->i2cErrors->openError = false;
+        return true;
+    }
+
     bool    BlackI2C::close()
     {
-        if( ::close(this->i2cFD) < 0 )
+        if( this->descriptor == NULL )
+        {
+            if( this->i2cFD < 0 ) { return true; }
+        }
+        else
+        {
+            pthread_mutex_lock( &descriptorMutex );
+            bool isLastUser = ( --(this->descriptor->userCount) == 0 );
+            sharedDescriptor *released = this->descriptor;
+            this->descriptor = NULL;
+            pthread_mutex_unlock( &descriptorMutex );
+
+            if( not isLastUser )
+            {
+                this->i2cFD = -1;
+                this->i2cErrors->closeError = false;
+                this->isOpenFlag = false;
+                return true;
+            }
+
+            pthread_mutex_destroy( &(released->mutex) );
+            delete released;
+        }
+
+        int fd = this->i2cFD;
+        this->i2cFD = -1;
+
+        if( ::close(fd) < 0 )
         {
             this->i2cErrors->closeError = true;
             return false;
@@ -150,12 +248,15 @@ namespace BlackLib
 
     bool    BlackI2C::writeByte(uint8_t registerAddr, uint8_t value)
     {
-        this->setSlave();
-
         i2c_smbus_data writeFromThis;
         writeFromThis.byte = value;
 
-        if( this->useSmbusIOCTL(output, registerAddr, SMBUS_BYTE_DATA, writeFromThis) )
+        this->lockDescriptor();
+        this->setSlave();
+        bool isWritten = this->useSmbusIOCTL(output, registerAddr, SMBUS_BYTE_DATA, writeFromThis);
+        this->unlockDescriptor();
+
+        if( isWritten )
         {
             this->i2cErrors->writeError = false;
             return true;
@@ -169,10 +270,14 @@ namespace BlackLib
 
     uint8_t BlackI2C::readByte(uint8_t registerAddr)
     {
+        i2c_smbus_data readToThis;
+
+        this->lockDescriptor();
         this->setSlave();
+        bool isRead = this->useSmbusIOCTL(input, registerAddr, SMBUS_BYTE_DATA, readToThis);
+        this->unlockDescriptor();
 
-        i2c_smbus_data readToThis;
-        if( this->useSmbusIOCTL(input, registerAddr, SMBUS_BYTE_DATA, readToThis) )
+        if( isRead )
         {
             this->i2cErrors->readError = false;
             return readToThis.byte;
@@ -188,12 +293,15 @@ namespace BlackLib
 
     bool    BlackI2C::writeWord(uint8_t registerAddr, uint16_t value)
     {
-        this->setSlave();
-
         i2c_smbus_data writeFromThis;
         writeFromThis.word = value;
 
-        if( this->useSmbusIOCTL(output, registerAddr, SMBUS_WORD_DATA, writeFromThis) )
+        this->lockDescriptor();
+        this->setSlave();
+        bool isWritten = this->useSmbusIOCTL(output, registerAddr, SMBUS_WORD_DATA, writeFromThis);
+        this->unlockDescriptor();
+
+        if( isWritten )
         {
             this->i2cErrors->writeError = false;
             return true;
@@ -207,11 +315,14 @@ namespace BlackLib
 
     uint16_t BlackI2C::readWord(uint8_t registerAddr)
     {
-        this->setSlave();
-
         i2c_smbus_data readToThis;
 
-        if( this->useSmbusIOCTL(input, registerAddr, SMBUS_WORD_DATA, readToThis) )
+        this->lockDescriptor();
+        this->setSlave();
+        bool isRead = this->useSmbusIOCTL(input, registerAddr, SMBUS_WORD_DATA, readToThis);
+        this->unlockDescriptor();
+
+        if( isRead )
         {
             this->i2cErrors->readError = false;
             return readToThis.word;
@@ -228,8 +339,6 @@ namespace BlackLib
 
     bool    BlackI2C::writeBlock(uint8_t registerAddr, uint8_t *writeBuffer, size_t bufferSize)
     {
-        this->setSlave();
-
         if( bufferSize > 32 )
         {
             bufferSize = 32;
@@ -242,7 +351,12 @@ namespace BlackLib
         memcpy( &(writeFromThis.block[1]), writeBuffer, bufferSize);
         writeFromThis.block[0] = bufferSize;
 
-        if( this->useSmbusIOCTL(output, registerAddr, SMBUS_I2C_BLOCK_DATA, writeFromThis) )
+        this->lockDescriptor();
+        this->setSlave();
+        bool isWritten = this->useSmbusIOCTL(output, registerAddr, SMBUS_I2C_BLOCK_DATA, writeFromThis);
+        this->unlockDescriptor();
+
+        if( isWritten )
         {
             this->i2cErrors->writeError = false;
             return true;
@@ -256,7 +370,6 @@ namespace BlackLib
 
     uint8_t BlackI2C::readBlock(uint8_t registerAddr, uint8_t *readBuffer, size_t bufferSize)
     {
-        this->setSlave();
         if( bufferSize > 32 )
         {
             bufferSize = 32;
@@ -265,7 +378,12 @@ namespace BlackLib
         i2c_smbus_data readToThis;
         readToThis.block[0] = bufferSize;
 
-        if( this->useSmbusIOCTL(input, registerAddr, SMBUS_I2C_BLOCK_DATA, readToThis) )
+        this->lockDescriptor();
+        this->setSlave();
+        bool isRead = this->useSmbusIOCTL(input, registerAddr, SMBUS_I2C_BLOCK_DATA, readToThis);
+        this->unlockDescriptor();
+
+        if( isRead )
         {
             this->i2cErrors->readError = false;
             memcpy(readBuffer, &(readToThis.block[1]), bufferSize);
@@ -283,8 +401,12 @@ namespace BlackLib
 
     bool    BlackI2C::writeLine(uint8_t *writeBuffer, size_t bufferSize)
     {
+        this->lockDescriptor();
         this->setSlave();
-        if( ::write(this->i2cFD, writeBuffer, bufferSize) < 0 )
+        ssize_t writeCount = ::write(this->i2cFD, writeBuffer, bufferSize);
+        this->unlockDescriptor();
+
+        if( writeCount < 0 )
         {
             this->i2cErrors->writeError = true;
             return false;
@@ -298,25 +420,200 @@ namespace BlackLib
 
     bool    BlackI2C::readLine(uint8_t *readBuffer, size_t bufferSize)
     {
+        this->lockDescriptor();
+        this->setSlave();
+        ssize_t readCount = ::read(this->i2cFD, readBuffer, bufferSize);
+        this->unlockDescriptor();
+
+        if( readCount < 0 )
+        {
+            this->i2cErrors->readError = true;
+            return false;
+        }
+        else
+        {
+            this->i2cErrors->readError = false;
+            return true;
+        }
+    }
+
+    bool    BlackI2C::writeLine(const BlackBuffer &writeBuffer)
+    {
+        return this->writeLine(writeBuffer.getData(), writeBuffer.getLength());
+    }
+
+    bool    BlackI2C::readLine(BlackBuffer &readBuffer, size_t bufferSize)
+    {
+        if( bufferSize > readBuffer.getCapacity() )
+        {
+            this->i2cErrors->readError = true;
+            return false;
+        }
+
+        this->lockDescriptor();
         this->setSlave();
-        if( ::read(this->i2cFD, readBuffer, bufferSize) < 0 )
+        ssize_t readCount = ::read(this->i2cFD, readBuffer.getData(), bufferSize);
+        this->unlockDescriptor();
+
+        if( readCount < 0 )
         {
             this->i2cErrors->readError = true;
+            readBuffer.setLength(0);
             return false;
         }
         else
         {
             this->i2cErrors->readError = false;
+            readBuffer.setLength( static_cast<size_t>(readCount) );
             return true;
         }
     }
 
 
 
+    bool    BlackI2C::transfer(BlackI2CTransaction &transaction)
+    {
+        bool hasRead    = transaction.hasMessage(true);
+        bool hasWrite   = transaction.hasMessage(false);
+        size_t count    = transaction.getMessageCount();
+
+        bool isValid    = ( count > 0 and count <= I2C_MAX_MESSAGE_COUNT );
+        for( size_t i = 0 ; isValid and i < count ; i++ )
+        {
+            isValid = ( transaction.getMessage(i).len <= I2C_MAX_MESSAGE_LENGTH );
+        }
+
+        bool isTransferred = false;
+        if( isValid )
+        {
+            this->lockDescriptor();
+            isTransferred = this->submitMessages(transaction);
+            this->unlockDescriptor();
+        }
+
+        if( hasRead  ) { this->i2cErrors->readError  = not isTransferred; }
+        if( hasWrite ) { this->i2cErrors->writeError = not isTransferred; }
+        return isTransferred;
+    }
+
+
+
+    bool    BlackI2C::writeLongBlock(uint8_t registerAddr, const uint8_t *writeBuffer, size_t bufferSize, i2cBlockMode blockMode)
+    {
+        bool isIncrement = ( blockMode == I2cIncrementRegister );
+
+        if( isIncrement and static_cast<size_t>(registerAddr) + bufferSize > 0x100 )
+        {
+            this->i2cErrors->writeError = true;
+            return false;
+        }
+
+        this->lockDescriptor();
+
+        bool canContinue = ( this->descriptor != NULL and (this->descriptor->functions & I2C_FUNC_NOSTART) != 0 );
+        bool isWritten   = true;
+        size_t offset    = 0;
+
+        do
+        {
+            this->blockTransaction.clear();
+
+            if( canContinue )
+            {
+                // register message of every request selects the register of its first byte
+                this->blockRegister = static_cast<uint8_t>( isIncrement ? registerAddr + offset : registerAddr );
+                this->blockTransaction.addWrite(&(this->blockRegister), 1);
+
+                while( offset < bufferSize and this->blockTransaction.getMessageCount() < I2C_MAX_MESSAGE_COUNT )
+                {
+                    size_t length = std::min(bufferSize - offset, I2C_MAX_MESSAGE_LENGTH);
+                    this->blockTransaction.addWrite(writeBuffer + offset, static_cast<uint16_t>(length), I2C_M_NOSTART);
+                    offset += length;
+                }
+            }
+            else
+            {
+                const size_t chunkSize  = I2C_MAX_MESSAGE_LENGTH - 1;
+                size_t messageCount     = std::min( (bufferSize - offset + chunkSize - 1) / chunkSize, I2C_MAX_MESSAGE_COUNT );
+                if( messageCount == 0 ) { messageCount = 1; }
+
+                size_t batchLength      = std::min(bufferSize - offset, messageCount * chunkSize);
+                this->blockBuffer.resize(batchLength + messageCount);
+
+                uint8_t *cursor = &(this->blockBuffer[0]);
+                for( size_t i = 0 ; i < messageCount ; i++ )
+                {
+                    size_t length = std::min(bufferSize - offset, chunkSize);
+
+                    cursor[0] = static_cast<uint8_t>( isIncrement ? registerAddr + offset : registerAddr );
+                    memcpy(cursor + 1, writeBuffer + offset, length);
+                    this->blockTransaction.addWrite(cursor, static_cast<uint16_t>(length + 1));
+
+                    cursor += length + 1;
+                    offset += length;
+                }
+            }
+
+            isWritten = this->submitMessages(this->blockTransaction);
+        }
+        while( isWritten and offset < bufferSize );
+
+        this->unlockDescriptor();
+
+        this->i2cErrors->writeError = not isWritten;
+        return isWritten;
+    }
+
+    bool    BlackI2C::readLongBlock(uint8_t registerAddr, uint8_t *readBuffer, size_t bufferSize)
+    {
+        this->lockDescriptor();
+
+        bool isRead     = true;
+        size_t offset   = 0;
+
+        this->blockTransaction.clear();
+        this->blockTransaction.addWrite(&registerAddr, 1);
+
+        do
+        {
+            while( offset < bufferSize and this->blockTransaction.getMessageCount() < I2C_MAX_MESSAGE_COUNT )
+            {
+                size_t length = std::min(bufferSize - offset, I2C_MAX_MESSAGE_LENGTH);
+                this->blockTransaction.addRead(readBuffer + offset, static_cast<uint16_t>(length));
+                offset += length;
+            }
+
+            isRead = this->submitMessages(this->blockTransaction);
+            this->blockTransaction.clear();
+        }
+        while( isRead and offset < bufferSize );
+
+        this->unlockDescriptor();
+
+        this->i2cErrors->readError = not isRead;
+        return isRead;
+    }
+
+    unsigned long BlackI2C::getFunctions()
+    {
+        return ( this->descriptor == NULL ) ? 0 : this->descriptor->functions;
+    }
+
+
+
     void    BlackI2C::setDeviceAddress(unsigned int newDeviceAddr)
     {
+        this->lockDescriptor();
         this->i2cDevAddress = newDeviceAddr;
         this->setSlave();
+        this->unlockDescriptor();
+    }
+
+    void    BlackI2C::selectDeviceAddress(unsigned int newDeviceAddr)
+    {
+        this->lockDescriptor();
+        this->i2cDevAddress = newDeviceAddr;
+        this->unlockDescriptor();
     }
 
     int     BlackI2C::getDeviceAddress()
@@ -324,6 +621,16 @@ namespace BlackLib
         return this->i2cDevAddress;
     }
 
+    BlackI2CStatistics BlackI2C::getStatistics()
+    {
+        return this->statistics;
+    }
+
+    void    BlackI2C::resetStatistics()
+    {
+        this->statistics = BlackI2CStatistics();
+    }
+
 
 
 
@@ -36,15 +36,19 @@
 
 
 #include "../BlackCore.h"
+#include "../BlackBufferPool/BlackBufferPool.h"
 #include <iostream>
 
+#include <algorithm>
 #include <cstring>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <cstdint>
 #include <unistd.h>
 
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/ioctl.h>
 #include <linux/i2c.h>
 #include <linux/i2c-dev.h>
@@ -74,6 +78,211 @@ namespace BlackLib
                                 SMBUS_I2C_BLOCK_DATA    = 8
                             };
 
+    /*!
+    * This enum is used for selecting register behaviour of long block writes.
+    */
+    enum i2cBlockMode       {   I2cFixedRegister        = 0,    /*!< all data goes to one register, like a fifo or the data register of a display */
+                                I2cIncrementRegister    = 1     /*!< data goes to consecutive registers, like the register map of a sensor */
+                            };
+
+
+    const size_t            I2C_MAX_MESSAGE_COUNT       = I2C_RDWR_IOCTL_MAX_MSGS;  //!< Maximum message count of one I2C_RDWR request
+    const size_t            I2C_MAX_MESSAGE_LENGTH      = 8192;                     //!< Maximum length of one i2c message which is accepted by i2c-dev
+    const uint16_t          I2C_OWN_ADDRESS             = 0xFFFF;                   //!< Message address placeholder, it is replaced with device address of BlackI2C object
+
+
+
+
+
+
+
+    // ######################################### BLACKI2CTRANSACTION DECLARATION STARTS ######################################## //
+
+    /*! @brief Holds messages of a combined i2c transfer.
+     *
+     *    This class builds a list of i2c messages. Every message has its own slave address, flags, buffer and
+     *    length. The whole list is sent to kernel with one @b I2C_RDWR request by BlackI2C::transfer(BlackI2CTransaction&)
+     *    function, so messages are separated with repeated start conditions and only one stop condition is
+     *    generated at the end of list. Slave address doesn't have to be bound with I2C_SLAVE request for this.
+     *
+     *    Buffers are not copied, so they must be valid until the transfer is finished.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  uint8_t registerAddr = 0x3B;
+     *  uint8_t values[14];
+     *
+     *  BlackLib::BlackI2CTransaction transaction;
+     *  transaction.addWrite(&registerAddr, 1)
+     *             .addRead(values, sizeof(values));       // repeated start, then read
+     *
+     *  myI2c.transfer(transaction);
+     * @endcode
+     */
+    class BlackI2CTransaction
+    {
+        private:
+            std::vector<i2c_msg> messages;              /*!< @brief is used to hold the kernel message packages */
+            std::vector<bool>    ownAddress;            /*!< @brief is used to hold which messages use device address of BlackI2C object */
+
+        public:
+            /*! @brief Default constructor of BlackI2CTransaction class.
+            *
+            *  This function reserves place for a few messages.
+            */
+            BlackI2CTransaction()
+            {
+                messages.reserve(4);
+                ownAddress.reserve(4);
+            }
+
+            /*! @brief Appends a message to the transaction.
+            *
+            * @param [in] address          slave address of message, I2C_OWN_ADDRESS for device address of BlackI2C object
+            * @param [in] flags            message flags like I2C_M_RD, I2C_M_TEN, I2C_M_NOSTART or I2C_M_IGNORE_NAK
+            * @param [in,out] buffer       data buffer pointer
+            * @param [in] length           message length in bytes, it must be less than or equal to I2C_MAX_MESSAGE_LENGTH
+            * @return reference of transaction for chaining.
+            */
+            BlackI2CTransaction& addMessage(uint16_t address, uint16_t flags, uint8_t *buffer, uint16_t length)
+            {
+                i2c_msg message;
+
+                message.addr    = (address == I2C_OWN_ADDRESS) ? 0 : address;
+                message.flags   = flags;
+                message.len     = length;
+                message.buf     = buffer;
+
+                messages.push_back(message);
+                ownAddress.push_back(address == I2C_OWN_ADDRESS);
+                return *this;
+            }
+
+            /*! @brief Appends a write message to the transaction.
+            *
+            * @param [in] writeBuffer      data buffer pointer
+            * @param [in] length           message length in bytes
+            * @param [in] flags            additional message flags
+            * @param [in] address          slave address of message
+            * @return reference of transaction for chaining.
+            */
+            BlackI2CTransaction& addWrite(const uint8_t *writeBuffer, uint16_t length, uint16_t flags = 0,
+                                          uint16_t address = I2C_OWN_ADDRESS)
+            {
+                return addMessage(address, flags & ~I2C_M_RD, const_cast<uint8_t*>(writeBuffer), length);
+            }
+
+            /*! @brief Appends a read message to the transaction.
+            *
+            * @param [out] readBuffer      read buffer pointer
+            * @param [in] length           message length in bytes
+            * @param [in] flags            additional message flags
+            * @param [in] address          slave address of message
+            * @return reference of transaction for chaining.
+            */
+            BlackI2CTransaction& addRead(uint8_t *readBuffer, uint16_t length, uint16_t flags = 0,
+                                         uint16_t address = I2C_OWN_ADDRESS)
+            {
+                return addMessage(address, flags | I2C_M_RD, readBuffer, length);
+            }
+
+            /*! @brief Removes all messages. Reserved memory is kept for reusing.
+            */
+            void clear()
+            {
+                messages.clear();
+                ownAddress.clear();
+            }
+
+            /*! @brief Exports message count.
+            */
+            size_t getMessageCount() const
+            {
+                return messages.size();
+            }
+
+            /*! @brief Exports sum of message lengths.
+            */
+            size_t getTotalLength() const
+            {
+                size_t total = 0;
+                for( size_t i = 0 ; i < messages.size() ; i++ )
+                {
+                    total += messages[i].len;
+                }
+                return total;
+            }
+
+            /*! @brief Checks whether the transaction has a message in selected direction.
+            *
+            * @param [in] isRead           true for read messages, false for write messages
+            */
+            bool hasMessage(bool isRead) const
+            {
+                for( size_t i = 0 ; i < messages.size() ; i++ )
+                {
+                    if( ((messages[i].flags & I2C_M_RD) != 0) == isRead ) { return true; }
+                }
+                return false;
+            }
+
+            /*! @brief Exports kernel message package of selected message.
+            */
+            i2c_msg& getMessage(size_t index)
+            {
+                return messages[index];
+            }
+
+            /*! @brief Exports pointer of first kernel message package.
+            *
+            * @return pointer which can be passed to I2C_RDWR request, or NULL if there isn't any message.
+            */
+            i2c_msg* getMessages()
+            {
+                return messages.empty() ? NULL : &messages[0];
+            }
+
+            /*! @brief Writes device address to messages which are added with I2C_OWN_ADDRESS.
+            *
+            * @param [in] address          slave device address
+            */
+            void setOwnAddress(uint16_t address)
+            {
+                for( size_t i = 0 ; i < messages.size() ; i++ )
+                {
+                    if( ownAddress[i] ) { messages[i].addr = address; }
+                }
+            }
+    };
+    // ########################################## BLACKI2CTRANSACTION DECLARATION ENDS ######################################### //
+
+
+
+
+
+
+
+    // ####################################### BLACKI2CSTATISTICS DECLARATION STARTS ######################################## //
+
+    /*! @brief Holds slave address binding counters of BlackI2C class.
+    */
+    struct BlackI2CStatistics
+    {
+        uint64_t    bindCount;          /*!< @brief is used to hold the number of issued I2C_SLAVE requests */
+        uint64_t    skippedBindCount;   /*!< @brief is used to hold the number of I2C_SLAVE requests which are skipped because address is already bound */
+
+        /*! @brief Default constructor of BlackI2CStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackI2CStatistics()
+        {
+            bindCount           = 0;
+            skippedBindCount    = 0;
+        }
+    };
+    // ######################################## BLACKI2CSTATISTICS DECLARATION ENDS ######################################### //
+
 
 
 
@@ -197,6 +406,25 @@ namespace BlackLib
             std::string     i2cPortPath;                /*!< @brief is used to hold the i2c's tty port path */
             bool            isOpenFlag;                 /*!< @brief is used to hold the i2c's tty file's state */
 
+            /*! @brief Holds the state of a file descriptor which can be shared by many BlackI2C objects.
+            */
+            struct sharedDescriptor
+            {
+                int             fd;                     /*!< @brief is used to hold the file descriptor */
+                int             boundAddress;           /*!< @brief is used to hold the slave address which is bound to descriptor, -1 if unknown */
+                uint32_t        userCount;              /*!< @brief is used to hold the number of objects which use descriptor */
+                unsigned long   functions;              /*!< @brief is used to hold the functionality flags of adapter */
+                pthread_mutex_t mutex;                  /*!< @brief is used to serialize binding and transfers of users */
+            };
+
+            sharedDescriptor    *descriptor;            /*!< @brief is used to hold the shared state of file descriptor */
+            BlackI2CStatistics  statistics;             /*!< @brief is used to hold the address binding counters */
+            static pthread_mutex_t descriptorMutex;     /*!< @brief is used to protect user counts of shared descriptors */
+
+            BlackI2CTransaction blockTransaction;       /*!< @brief is used to hold the messages of long block transfers */
+            std::vector<uint8_t> blockBuffer;           /*!< @brief is used to hold the register address and data of long block writes, if adapter can't continue a message */
+            uint8_t             blockRegister;          /*!< @brief is used to hold the register address message of long block writes, if adapter can continue a message */
+
 
 
             /*! @brief Device tree loading is not necessary for using I2C feature.
@@ -224,12 +452,33 @@ namespace BlackLib
 
             /*! @brief Sets slave to device.
             *
-            * This function does ioctl kernel request with "I2C_SLAVE" command.
+            * This function does ioctl kernel request with "I2C_SLAVE" command, only if the device address is
+            * not already bound to the file descriptor. It must be called while the descriptor is locked.
             *
             * @return If kernel request is finished successfully, this function returns true, else false.
             */
             inline bool setSlave();
 
+            /*! @brief Locks the shared descriptor.
+            *
+            * Binding of slave address and the transfer which uses it are done while the descriptor is
+            * locked, so other objects which share the descriptor can't rebind it between them.
+            */
+            inline void lockDescriptor();
+
+            /*! @brief Unlocks the shared descriptor.
+            */
+            inline void unlockDescriptor();
+
+            /*! @brief Sends messages to kernel with "I2C_RDWR" command.
+            *
+            * Messages which are added with I2C_OWN_ADDRESS take device address of this object. It must be called
+            * while the descriptor is locked.
+            *
+            * @return true if all messages are transferred, else false.
+            */
+            inline bool submitMessages(BlackI2CTransaction &transaction);
+
 
 
         public:
@@ -314,6 +563,33 @@ namespace BlackLib
             */
             bool        close();
 
+            /*! @brief Uses the opened file descriptor of another BlackI2C object.
+            *
+            * This function lets objects of different slave devices on the same bus use one file descriptor.
+            * The bound slave address is tracked per descriptor, so I2C_SLAVE request is issued only when
+            * an object which has another address accesses the bus. Accesses of sharing objects are
+            * serialized. The descriptor is closed when its last user is closed.
+            *
+            * @param [in] owner             opened BlackI2C object of the same bus
+            * @return True if owner is open, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *
+            *   BlackLib::BlackI2C  accel(BlackLib::I2C_1, 0x53);
+            *   BlackLib::BlackI2C  gyro(BlackLib::I2C_1, 0x68);
+            *
+            *   accel.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *   gyro.open(accel);
+            *
+            *   accel.readByte(0x00);       // I2C_SLAVE 0x53 was done at open, no ioctl
+            *   gyro.readByte(0x75);        // I2C_SLAVE 0x68
+            *   gyro.readByte(0x3B);        // no I2C_SLAVE
+            *
+            * @endcode
+            */
+            bool        open(BlackI2C &owner);
+
             /*! @brief Writes byte value to i2c smbus.
             *
             * This function writes byte value to i2c smbus. Register address of device and values sent
@@ -604,6 +880,71 @@ namespace BlackLib
             */
             uint8_t     readBlock(uint8_t registerAddr, uint8_t *readBuffer, size_t bufferSize);
 
+            /*! @brief Writes data block of any length to a register.
+            *
+            * Unlike BlackI2C::writeBlock(), this function isn't limited to 32 bytes. It uses "I2C_RDWR" requests and
+            * splits data at adapter limits (I2C_MAX_MESSAGE_LENGTH bytes per message, I2C_MAX_MESSAGE_COUNT messages
+            * per request). If adapter supports I2C_FUNC_NOSTART, register address is sent as a separate message and
+            * data is sent from caller's buffer directly, with continued messages. Otherwise register address and data
+            * are packed into one message for every chunk.
+            *
+            * Data can be split into several bus transactions and every transaction starts with a register address,
+            * so the register of every chunk is selected with @a @b blockMode, and both ways write the same bytes to
+            * the same registers:
+            *   - I2cFixedRegister: every chunk starts with @a @b registerAddr, for a fifo or the data register of a
+            *     display controller. Data length isn't limited.
+            *   - I2cIncrementRegister: every chunk starts with the register of its first byte, for devices which
+            *     increment their register pointer. Block must end at register 0xFF at most.
+            *
+            * @param [in] registerAddr      register address
+            * @param [in] writeBuffer       buffer pointer
+            * @param [in] bufferSize        buffer size
+            * @param [in] blockMode         register behaviour of device (enum)
+            * @return true if all data is written, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackI2C  myDisplay(BlackLib::I2C_1, 0x3C);
+            *   myDisplay.open( BlackLib::ReadWrite );
+            *
+            *   uint8_t frame[1024];
+            *   myDisplay.writeLongBlock(0x40, frame, sizeof(frame));          // one data message
+            * @endcode
+            */
+            bool        writeLongBlock(uint8_t registerAddr, const uint8_t *writeBuffer, size_t bufferSize,
+                                       i2cBlockMode blockMode = I2cFixedRegister);
+
+            /*! @brief Reads data block of any length from a register.
+            *
+            * Unlike BlackI2C::readBlock(), this function isn't limited to 32 bytes. Register address is written, then
+            * data is read after a repeated start directly into caller's buffer. If data is longer than
+            * I2C_MAX_MESSAGE_LENGTH bytes, it is read with consecutive read messages and the device continues from its
+            * internal register pointer. Up to I2C_MAX_MESSAGE_COUNT messages are sent with one "I2C_RDWR" request.
+            *
+            * @param [in] registerAddr      register address
+            * @param [out] readBuffer       buffer pointer
+            * @param [in] bufferSize        buffer size
+            * @return true if whole block is read, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackI2C  myImu(BlackLib::I2C_1, 0x68);
+            *   myImu.open( BlackLib::ReadWrite );
+            *
+            *   uint8_t fifoData[1008];
+            *   myImu.readLongBlock(0x74, fifoData, sizeof(fifoData));         // one bus transaction
+            * @endcode
+            */
+            bool        readLongBlock(uint8_t registerAddr, uint8_t *readBuffer, size_t bufferSize);
+
+            /*! @brief Exports functionality flags of i2c adapter.
+            *
+            * This function returns the value which is read with "I2C_FUNCS" request when the device is opened.
+            *
+            * @return I2C_FUNC_* flags, or 0 if device isn't open.
+            */
+            unsigned long getFunctions();
+
             /*! @brief Read data block from i2c line.
             *
             * This function reads data block from i2c line directly.
@@ -620,6 +961,56 @@ namespace BlackLib
             */
             bool        readLine(uint8_t *readBuffer, size_t bufferSize);
 
+            /*! @brief Writes valid bytes of a pool buffer to i2c line.
+            *
+            * @param [in] writeBuffer       pool buffer, its length is used as data size
+            * @return true writing successfull, else false.
+            *
+            * @sa BlackBufferPool
+            */
+            bool        writeLine(const BlackBuffer &writeBuffer);
+
+            /*! @brief Reads data block from i2c line to a pool buffer.
+            *
+            * Length of buffer is set to the number of received bytes.
+            *
+            * @param [out] readBuffer       pool buffer, its capacity must be enough for data size
+            * @param [in] bufferSize        data size
+            * @return true reading successfull, else false.
+            */
+            bool        readLine(BlackBuffer &readBuffer, size_t bufferSize);
+
+            /*! @brief Transfers a list of messages with one kernel request.
+            *
+            * This function does ioctl kernel request with "I2C_RDWR" command. Messages are separated with
+            * repeated start conditions, so a register pointer write and the following read are done in one
+            * bus transaction. Messages which are added with I2C_OWN_ADDRESS take device address of this object.
+            * Transaction can't have more than I2C_MAX_MESSAGE_COUNT messages and a message can't be longer
+            * than I2C_MAX_MESSAGE_LENGTH bytes.
+            *
+            * @param [in,out] transaction   message list
+            * @return true if all messages are transferred, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackI2C  myI2c(BlackLib::I2C_1, 0x53);
+            *   myI2c.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *
+            *   uint8_t dataStart = 0x32;
+            *   uint8_t axisValues[6];
+            *
+            *   BlackLib::BlackI2CTransaction transaction;
+            *   transaction.addWrite(&dataStart, 1)
+            *              .addRead(axisValues, sizeof(axisValues));
+            *
+            *   bool isRead = myI2c.transfer(transaction);     // S Addr+W 0x32 Sr Addr+R d0..d5 P
+            *
+            * @endcode
+            *
+            * @sa BlackI2CTransaction
+            */
+            bool        transfer(BlackI2CTransaction &transaction);
+
             /*! @brief Changes device address of slave device.
             *
             * This function changes device address of slave device and sets this device to slave.
@@ -648,6 +1039,20 @@ namespace BlackLib
             */
             void        setDeviceAddress(unsigned int newDeviceAddr);
 
+            /*! @brief Changes device address of slave device without binding it.
+            *
+            * This function only stores the new address. Smbus, read and write functions bind the address
+            * with I2C_SLAVE request when they need it, and combined transfers and long block functions
+            * carry the address in every message, so they never need binding. Unlike setDeviceAddress(),
+            * switching between devices which use only combined transfers costs no system call.
+            *
+            * @param [in] newDeviceAddr  new slave device address
+            *
+            * @sa setDeviceAddress()
+            * @sa transfer()
+            */
+            void        selectDeviceAddress(unsigned int newDeviceAddr);
+
             /*! @brief Exports device address of slave device.
             *
             * @return address of current slave device.
@@ -658,6 +1063,16 @@ namespace BlackLib
             */
             int         getDeviceAddress();
 
+            /*! @brief Exports slave address binding counters of this object.
+            *
+            * @return copy of BlackI2CStatistics struct.
+            */
+            BlackI2CStatistics getStatistics();
+
+            /*! @brief Clears slave address binding counters of this object.
+            */
+            void        resetStatistics();
+
             /*! @brief Exports i2c's port path.
             *
             * @return i2c's port path as string.
@@ -0,0 +1,405 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackI2CAsync.h"
+#include "../BlackTime/BlackTime.h"
+#include <algorithm>
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackI2CAsync::BlackI2CAsync(BlackI2CBus &ownerBus)
+    {
+        this->bus               = &ownerBus;
+        this->sliceMessageCount = 1;
+        this->activeRequest     = NULL;
+        this->isFinishRequested = false;
+
+        this->freeRequests.reserve(8);
+
+        pthread_mutex_init( &(this->queueMutex), NULL);
+        pthread_cond_init( &(this->queueCondition), NULL);
+    }
+
+    BlackI2CAsync::~BlackI2CAsync()
+    {
+        this->finish();
+
+        for( uint8_t i = 0 ; i < I2C_PRIORITY_COUNT ; i++ )
+        {
+            while( not this->requestQueues[i].empty() )
+            {
+                asyncRequest *request = this->requestQueues[i].front();
+                this->requestQueues[i].pop_front();
+
+                if( request->future != NULL )
+                {
+                    request->future->complete(false);
+                }
+
+                delete request;
+            }
+        }
+
+        for( size_t i = 0 ; i < this->freeRequests.size() ; i++ )
+        {
+            delete this->freeRequests[i];
+        }
+
+        pthread_cond_destroy( &(this->queueCondition) );
+        pthread_mutex_destroy( &(this->queueMutex) );
+    }
+
+    BlackI2CAsync::asyncRequest *BlackI2CAsync::acquireRequest()
+    {
+        asyncRequest *request = NULL;
+
+        pthread_mutex_lock( &(this->queueMutex) );
+        if( not this->freeRequests.empty() )
+        {
+            request = this->freeRequests.back();
+            this->freeRequests.pop_back();
+        }
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return ( request != NULL ) ? request : new asyncRequest;
+    }
+
+    void BlackI2CAsync::releaseRequest(asyncRequest *request)
+    {
+        request->ownTransaction.clear();
+        this->freeRequests.push_back(request);
+    }
+
+    bool BlackI2CAsync::enqueue(asyncRequest *request, i2cRequestPriority priority)
+    {
+        int priorityClass = static_cast<int>(priority);
+
+        pthread_mutex_lock( &(this->queueMutex) );
+
+        if( this->isFinishRequested or priorityClass < 0 or priorityClass >= I2C_PRIORITY_COUNT )
+        {
+            this->releaseRequest(request);
+            pthread_mutex_unlock( &(this->queueMutex) );
+            return false;
+        }
+
+        if( request->future != NULL )
+        {
+            request->future->reset();
+        }
+
+        request->submitTime     = BlackTime::getMonotonicTime();
+        request->priorityClass  = priorityClass;
+        this->requestQueues[priorityClass].push_back(request);
+
+        if( this->requestQueues[priorityClass].size() > this->statistics[priorityClass].maxQueueDepth )
+        {
+            this->statistics[priorityClass].maxQueueDepth = this->requestQueues[priorityClass].size();
+        }
+
+        pthread_cond_signal( &(this->queueCondition) );
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return true;
+    }
+
+    bool BlackI2CAsync::submit(BlackI2CBusDevice &device, BlackI2CTransaction &transaction, i2cRequestPriority priority,
+                               BlackFuture *future, bool isPreemptible)
+    {
+        if( device.getBus() != this->bus or transaction.getMessageCount() == 0 )
+        {
+            return false;
+        }
+
+        asyncRequest *request   = this->acquireRequest();
+        request->device         = &device;
+        request->transaction    = &transaction;
+        request->future         = future;
+        request->nextMessage    = 0;
+        request->isPreemptible  = isPreemptible;
+        request->registerAddr   = 0;
+
+        return this->enqueue(request, priority);
+    }
+
+    bool BlackI2CAsync::submitRead(BlackI2CBusDevice &device, uint8_t registerAddr, uint8_t *readBuffer,
+                                   size_t bufferSize, uint16_t chunkLength, i2cRequestPriority priority, BlackFuture *future)
+    {
+        if( device.getBus() != this->bus or readBuffer == NULL or bufferSize == 0 or
+            chunkLength == 0 or chunkLength > I2C_MAX_MESSAGE_LENGTH )
+        {
+            return false;
+        }
+
+        asyncRequest *request   = this->acquireRequest();
+        request->device         = &device;
+        request->transaction    = &(request->ownTransaction);
+        request->future         = future;
+        request->nextMessage    = 0;
+        request->isPreemptible  = true;
+        request->registerAddr   = registerAddr;
+
+        request->transaction->addWrite(&(request->registerAddr), 1);
+
+        for( size_t offset = 0 ; offset < bufferSize ; offset += chunkLength )
+        {
+            size_t length = std::min(bufferSize - offset, static_cast<size_t>(chunkLength));
+            request->transaction->addRead(readBuffer + offset, static_cast<uint16_t>(length));
+        }
+
+        return this->enqueue(request, priority);
+    }
+
+    bool BlackI2CAsync::setSliceMessageCount(size_t messageCount)
+    {
+        if( messageCount == 0 or messageCount > I2C_MAX_MESSAGE_COUNT )
+        {
+            return false;
+        }
+
+        pthread_mutex_lock( &(this->queueMutex) );
+        this->sliceMessageCount = messageCount;
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return true;
+    }
+
+    size_t BlackI2CAsync::getPendingCount(i2cRequestPriority priority)
+    {
+        int priorityClass = static_cast<int>(priority);
+
+        if( priorityClass < 0 or priorityClass >= I2C_PRIORITY_COUNT )
+        {
+            return 0;
+        }
+
+        pthread_mutex_lock( &(this->queueMutex) );
+        size_t temp = this->requestQueues[priorityClass].size();
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return temp;
+    }
+
+    BlackI2CAsyncStatistics BlackI2CAsync::getStatistics(i2cRequestPriority priority)
+    {
+        int priorityClass = static_cast<int>(priority);
+
+        if( priorityClass < 0 or priorityClass >= I2C_PRIORITY_COUNT )
+        {
+            return BlackI2CAsyncStatistics();
+        }
+
+        pthread_mutex_lock( &(this->queueMutex) );
+        BlackI2CAsyncStatistics temp = this->statistics[priorityClass];
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return temp;
+    }
+
+    void BlackI2CAsync::resetStatistics()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        for( uint8_t i = 0 ; i < I2C_PRIORITY_COUNT ; i++ )
+        {
+            this->statistics[i] = BlackI2CAsyncStatistics();
+        }
+        pthread_mutex_unlock( &(this->queueMutex) );
+    }
+
+    void BlackI2CAsync::finish()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        this->isFinishRequested = true;
+        pthread_cond_broadcast( &(this->queueCondition) );
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        // flag stays set, so later submits fail instead of waiting for a thread which doesn't exist
+        this->waitUntilFinish();
+    }
+
+    bool BlackI2CAsync::isBlocked(const asyncRequest *request)
+    {
+        for( uint8_t i = 0 ; i < I2C_PRIORITY_COUNT ; i++ )
+        {
+            if( this->requestQueues[i].empty() )
+            {
+                continue;
+            }
+
+            const asyncRequest *suspended = this->requestQueues[i].front();
+
+            if( suspended != request and suspended->nextMessage > 0 and
+                suspended->device->getAddress() == request->device->getAddress() )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    int BlackI2CAsync::selectClass()
+    {
+        for( uint8_t i = 0 ; i < I2C_PRIORITY_COUNT ; i++ )
+        {
+            if( not this->requestQueues[i].empty() and not this->isBlocked( this->requestQueues[i].front() ) )
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    bool BlackI2CAsync::sendSlice(asyncRequest *request)
+    {
+        BlackI2CTransaction *transaction    = request->transaction;
+        size_t count                        = transaction->getMessageCount();
+
+        if( not request->isPreemptible )
+        {
+            request->nextMessage = count;
+            return request->device->transfer(*transaction);
+        }
+
+        transaction->setOwnAddress( request->device->getAddress() );
+
+        size_t first    = request->nextMessage;
+        size_t last     = std::min(first + this->sliceMessageCount, count);
+
+        // a write message is kept together with the next message, so register pointer writes aren't separated
+        while( last < count and last - first < I2C_MAX_MESSAGE_COUNT and
+               (transaction->getMessage(last - 1).flags & I2C_M_RD) == 0 )
+        {
+            ++last;
+        }
+
+        this->slice.clear();
+        for( size_t i = first ; i < last ; i++ )
+        {
+            const i2c_msg &message = transaction->getMessage(i);
+            this->slice.addMessage(message.addr, message.flags, message.buf, message.len);
+        }
+
+        request->nextMessage = last;
+
+        BlackI2C *port = this->bus->lock();
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool isTransferred = port->transfer(this->slice);
+        this->bus->unlock();
+
+        return isTransferred;
+    }
+
+    void BlackI2CAsync::onStartHandler()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+
+        while( true )
+        {
+            int priorityClass = this->selectClass();
+
+            while( priorityClass < 0 and not this->isFinishRequested )
+            {
+                pthread_cond_wait( &(this->queueCondition), &(this->queueMutex) );
+                priorityClass = this->selectClass();
+            }
+
+            if( priorityClass < 0 )
+            {
+                break;
+            }
+
+            asyncRequest *request = this->requestQueues[priorityClass].front();
+
+            if( this->activeRequest != NULL and this->activeRequest != request )
+            {
+                ++(this->statistics[ this->activeRequest->priorityClass ].preemptedCount);
+                this->activeRequest = NULL;
+            }
+
+            pthread_mutex_unlock( &(this->queueMutex) );
+
+            bool isTransferred  = this->sendSlice(request);
+            bool isFinished     = ( not isTransferred or request->nextMessage >= request->transaction->getMessageCount() );
+
+            pthread_mutex_lock( &(this->queueMutex) );
+
+            BlackI2CAsyncStatistics &stat = this->statistics[priorityClass];
+            ++(stat.sliceCount);
+
+            if( not isFinished )
+            {
+                this->activeRequest = request;
+                continue;
+            }
+
+            if( this->activeRequest == request )
+            {
+                this->activeRequest = NULL;
+            }
+
+            this->requestQueues[priorityClass].pop_front();
+
+            uint64_t latency = BlackTime::getMonotonicTime() - request->submitTime;
+            stat.totalLatency += latency;
+            ++(stat.completedCount);
+
+            if( latency > stat.maxLatency ) { stat.maxLatency = latency; }
+            if( not isTransferred )         { ++(stat.failedCount); }
+
+            pthread_mutex_unlock( &(this->queueMutex) );
+
+            if( request->future != NULL )
+            {
+                request->future->complete(isTransferred);
+            }
+
+            pthread_mutex_lock( &(this->queueMutex) );
+            this->releaseRequest(request);
+        }
+
+        pthread_mutex_unlock( &(this->queueMutex) );
+    }
+
+
+
+} /* namespace BlackLib */
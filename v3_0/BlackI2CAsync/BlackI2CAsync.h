@@ -0,0 +1,339 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKI2CASYNC_H_
+#define BLACKI2CASYNC_H_
+
+#include "../BlackI2CBus/BlackI2CBus.h"
+#include "../BlackThread/BlackThread.h"
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting priority class of asynchronous i2c requests.
+    */
+    enum i2cRequestPriority {   I2cHighPriority         = 0,    /*!< safety critical requests, they are run first */
+                                I2cNormalPriority       = 1,
+                                I2cLowPriority          = 2     /*!< bulk transfers like memory dumps */
+                            };
+
+    const uint8_t           I2C_PRIORITY_COUNT          = 3;    //!< Number of priority classes of BlackI2CAsync
+
+
+
+
+
+    // ##################################### BLACKI2CASYNCSTATISTICS DECLARATION STARTS ###################################### //
+
+    /*! @brief Holds counters of a priority class of BlackI2CAsync class.
+    *
+    *    Latency is measured from submission to completion of request. All time values are at
+    *    nanosecond (ns) level.
+    */
+    struct BlackI2CAsyncStatistics
+    {
+        uint64_t    completedCount;     /*!< @brief is used to hold the number of completed requests */
+        uint64_t    failedCount;        /*!< @brief is used to hold the number of failed requests */
+        uint64_t    sliceCount;         /*!< @brief is used to hold the number of I2C_RDWR requests */
+        uint64_t    preemptedCount;     /*!< @brief is used to hold the number of times which requests of this class are suspended for a higher class */
+        uint64_t    maxLatency;         /*!< @brief is used to hold the maximum latency */
+        uint64_t    totalLatency;       /*!< @brief is used to hold the sum of latencies */
+        size_t      maxQueueDepth;      /*!< @brief is used to hold the maximum number of waiting requests */
+
+        /*! @brief Default constructor of BlackI2CAsyncStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackI2CAsyncStatistics()
+        {
+            completedCount  = 0;
+            failedCount     = 0;
+            sliceCount      = 0;
+            preemptedCount  = 0;
+            maxLatency      = 0;
+            totalLatency    = 0;
+            maxQueueDepth   = 0;
+        }
+
+        /*! @brief Calculates average latency.
+         *
+         *  @return average latency at nanosecond level.
+         */
+        uint64_t getAverageLatency() const
+        {
+            return ( (completedCount == 0) ? 0 : (totalLatency / completedCount) );
+        }
+    };
+    // ###################################### BLACKI2CASYNCSTATISTICS DECLARATION ENDS ####################################### //
+
+
+
+
+
+
+
+
+
+
+    // ########################################## BLACKI2CASYNC DECLARATION STARTS ########################################### //
+
+    /*! @brief Executes i2c requests of a bus at a dedicated worker thread, by priority.
+     *
+     *    This class is used for sending i2c transactions without blocking the caller. Requests are queued
+     *    with submit() function in one of three priority classes and completion is reported with BlackFuture
+     *    handles. The worker thread always runs the oldest request of the highest non-empty class, so a high
+     *    priority request waits at most for the slice of bus traffic which is in progress.
+     *
+     *    Requests which are submitted as preemptible are sent in slices of messages. After every slice the
+     *    worker checks the queues again, and if a request of a higher class is waiting, the long request is
+     *    suspended at a message boundary and resumed later. A write message is never separated from the next
+     *    message, so a register pointer write and its data read stay in one slice. Slices are separate bus
+     *    transactions, so consecutive read messages of a preemptible request must be continuable after a stop
+     *    condition, like the current address reads of serial memories. Requests of the device which has a
+     *    suspended request are not allowed to preempt it, so its internal address pointer isn't disturbed.
+     *    Non-preemptible requests are sent with one I2C_RDWR request.
+     *
+     *    submitRead() builds a preemptible block read with read messages of selected chunk length, so even
+     *    one long memory dump doesn't keep the bus for longer than one chunk.
+     *
+     *    Transaction objects, their buffers and future handles must stay valid until the request is completed.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myI2cAsyncProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackI2CAsync/BlackI2CAsync.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackI2CBus       bus(BlackLib::I2C_1);
+     *      BlackLib::BlackI2CBusDevice eeprom(bus, 0x50);
+     *      BlackLib::BlackI2CBusDevice currentSensor(bus, 0x40);
+     *
+     *      BlackLib::BlackI2CAsync     worker(bus);
+     *      worker.run();
+     *
+     *      uint8_t dump[4096];
+     *      BlackLib::BlackFuture dumpDone;
+     *      worker.submitRead(eeprom, 0x00, dump, sizeof(dump), 64, BlackLib::I2cLowPriority, &dumpDone);
+     *
+     *      uint8_t currentReg = 0x04;
+     *      uint8_t current[2];
+     *      BlackLib::BlackI2CTransaction currentRead;
+     *      currentRead.addWrite(&currentReg, 1).addRead(current, sizeof(current));
+     *
+     *      BlackLib::BlackFuture currentDone;
+     *      worker.submit(currentSensor, currentRead, BlackLib::I2cHighPriority, &currentDone);
+     *
+     *      if( currentDone.wait() )                        // doesn't wait for the whole dump
+     *      {
+     *          std::cout << "Current: " << ((current[0] << 8) | current[1]) << std::endl;
+     *      }
+     *
+     *      dumpDone.wait();
+     *      worker.finish();
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackI2CAsync : public BlackThread
+    {
+        private:
+
+            /*! @brief Holds one queued request.
+            */
+            struct asyncRequest
+            {
+                BlackI2CBusDevice          *device;             /*!< @brief is used to hold the target device */
+                BlackI2CTransaction        *transaction;        /*!< @brief is used to hold the queued transaction */
+                BlackFuture                *future;             /*!< @brief is used to hold the completion handle, can be NULL */
+                uint64_t                    submitTime;         /*!< @brief is used to hold the monotonic time of submission */
+                int                         priorityClass;      /*!< @brief is used to hold the priority class index */
+                size_t                      nextMessage;        /*!< @brief is used to hold the index of the first message which isn't sent */
+                bool                        isPreemptible;      /*!< @brief is used to hold whether the request can be sent in slices */
+                uint8_t                     registerAddr;       /*!< @brief is used to hold the register address of block reads */
+                BlackI2CTransaction         ownTransaction;     /*!< @brief is used to hold the messages of block reads, it keeps its capacity while the request is reused */
+            };
+
+            BlackI2CBus                    *bus;                                    /*!< @brief is used to hold the bus of requests */
+            std::deque<asyncRequest*>       requestQueues[I2C_PRIORITY_COUNT];      /*!< @brief is used to hold the waiting requests of every class */
+            BlackI2CTransaction             slice;                                  /*!< @brief is used to hold the messages of current slice */
+            BlackI2CAsyncStatistics         statistics[I2C_PRIORITY_COUNT];         /*!< @brief is used to hold the counters of every class */
+            pthread_mutex_t                 queueMutex;                             /*!< @brief is used to protect the queues and the counters */
+            pthread_cond_t                  queueCondition;                         /*!< @brief is used to wake up the worker thread */
+            size_t                          sliceMessageCount;                      /*!< @brief is used to hold the message count of slices */
+            std::vector<asyncRequest*>      freeRequests;                           /*!< @brief is used to hold the completed requests which are reused by next submissions */
+            asyncRequest                   *activeRequest;                          /*!< @brief is used to hold the partially sent request which was served last, NULL if there isn't */
+            bool                            isFinishRequested;                      /*!< @brief is used to hold the finish request of worker */
+
+            /*! @brief Takes a request from the pool of completed requests.
+            *
+            * A new request is allocated only if the pool is empty, so steady traffic doesn't allocate.
+            */
+            asyncRequest                   *acquireRequest();
+
+            /*! @brief Returns a request to the pool.
+            *
+            * This function must be called while the queue mutex is locked.
+            */
+            void                            releaseRequest(asyncRequest *request);
+
+            /*! @brief Adds a request to the queue of its class.
+            *
+            * Request is returned to the pool if it is rejected.
+            */
+            bool                            enqueue(asyncRequest *request, i2cRequestPriority priority);
+
+            /*! @brief Selects the class whose front request will be served.
+            *
+            * This function must be called while the queue mutex is locked.
+            *
+            * @return class index, or -1 if all queues are empty.
+            */
+            int                             selectClass();
+
+            /*! @brief Sends the next slice of a request.
+            *
+            * @return true if slice is transferred, else false.
+            */
+            bool                            sendSlice(asyncRequest *request);
+
+            /*! @brief Checks whether a request targets the device of a suspended request of another class.
+            *
+            * This function must be called while the queue mutex is locked.
+            */
+            bool                            isBlocked(const asyncRequest *request);
+
+            /*! @brief Thread's start handler function.
+            *
+            *  This function waits for requests and executes them until finish is requested and
+            *  the queues are empty. Users should not call this function directly.
+            */
+            void                            onStartHandler();
+
+
+
+        public:
+
+            /*! @brief Constructor of BlackI2CAsync class.
+            *
+            * Worker thread is started with run() function; requests which are submitted before, wait in the queues.
+            *
+            * @param [in] ownerBus          bus which requests are sent to
+            */
+                                            BlackI2CAsync(BlackI2CBus &ownerBus);
+
+            /*! @brief Destructor of BlackI2CAsync class.
+            *
+            * This function executes the waiting requests and waits the worker thread.
+            */
+            virtual                         ~BlackI2CAsync();
+
+            /*! @brief Queues a transaction.
+            *
+            * This function returns immediately. If future handle is passed, it is marked as pending and it is
+            * completed after the whole transaction is sent.
+            *
+            * @param [in] device            target device, it must be a device of the bus of worker
+            * @param [in] transaction       transaction which will be sent, messages with I2C_OWN_ADDRESS take address of device
+            * @param [in] priority          priority class
+            * @param [in] future            completion handle, can be NULL
+            * @param [in] isPreemptible     true if transaction can be sent in slices
+            * @return true if transaction is queued, else false.
+            */
+            bool                            submit(BlackI2CBusDevice &device, BlackI2CTransaction &transaction,
+                                                   i2cRequestPriority priority = I2cNormalPriority,
+                                                   BlackFuture *future = NULL, bool isPreemptible = false);
+
+            /*! @brief Queues a preemptible block read.
+            *
+            * Register address is written and data is read with read messages of chunk length. Every chunk
+            * is a preemption point.
+            *
+            * @param [in] device            target device, it must be a device of the bus of worker
+            * @param [in] registerAddr      first register or memory address
+            * @param [out] readBuffer       buffer pointer
+            * @param [in] bufferSize        buffer size
+            * @param [in] chunkLength       length of read messages, it must be less than or equal to I2C_MAX_MESSAGE_LENGTH
+            * @param [in] priority          priority class
+            * @param [in] future            completion handle, can be NULL
+            * @return true if block read is queued, else false.
+            */
+            bool                            submitRead(BlackI2CBusDevice &device, uint8_t registerAddr, uint8_t *readBuffer,
+                                                       size_t bufferSize, uint16_t chunkLength,
+                                                       i2cRequestPriority priority = I2cLowPriority, BlackFuture *future = NULL);
+
+            /*! @brief Changes the minimum message count of slices of preemptible requests.
+            *
+            * @param [in] messageCount      message count, it must be between 1 and I2C_MAX_MESSAGE_COUNT
+            * @return true if message count is valid, else false.
+            */
+            bool                            setSliceMessageCount(size_t messageCount);
+
+            /*! @brief Exports the number of waiting requests of a class.
+            *
+            */
+            size_t                          getPendingCount(i2cRequestPriority priority);
+
+            /*! @brief Exports the counters of a class.
+            *
+            * @return copy of BlackI2CAsyncStatistics struct.
+            */
+            BlackI2CAsyncStatistics         getStatistics(i2cRequestPriority priority);
+
+            /*! @brief Clears the counters of all classes.
+            *
+            */
+            void                            resetStatistics();
+
+            /*! @brief Executes the waiting requests and finishes the worker thread.
+            *
+            * This function blocks the caller until the worker thread is finished. New requests
+            * are rejected after this function is called, submit functions return false.
+            */
+            void                            finish();
+    };
+    // ########################################### BLACKI2CASYNC DECLARATION ENDS ############################################ //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKI2CASYNC_H_ */
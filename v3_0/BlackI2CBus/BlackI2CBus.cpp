@@ -0,0 +1,359 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackI2CBus.h"
+#include <algorithm>
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackI2CBus::BlackI2CBus(i2cName bus, uint openMode)
+    {
+        this->busName       = bus;
+        this->portOpenMode  = openMode;
+        this->port          = NULL;
+
+        pthread_mutex_init( &(this->busMutex), NULL);
+        pthread_mutex_init( &(this->queueMutex), NULL);
+    }
+
+    BlackI2CBus::~BlackI2CBus()
+    {
+        if( this->port != NULL )
+        {
+            delete this->port;
+        }
+
+        pthread_mutex_destroy( &(this->queueMutex) );
+        pthread_mutex_destroy( &(this->busMutex) );
+    }
+
+    BlackI2C *BlackI2CBus::getPort()
+    {
+        if( this->port == NULL )
+        {
+            this->port = new BlackI2C(this->busName, 0);
+        }
+
+        if( not this->port->isOpen() )
+        {
+            if( not this->port->open(this->portOpenMode) )
+            {
+                return NULL;
+            }
+        }
+
+        return this->port;
+    }
+
+    void BlackI2CBus::selectAddress(uint16_t address)
+    {
+        if( this->port->getDeviceAddress() != static_cast<int>(address) )
+        {
+            ++(this->statistics.addressSwitchCount);
+            this->port->selectDeviceAddress(address);
+        }
+    }
+
+    BlackI2C *BlackI2CBus::lock(const BlackI2CBusDevice &device)
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+
+        if( this->getPort() == NULL )
+        {
+            pthread_mutex_unlock( &(this->busMutex) );
+            return NULL;
+        }
+
+        ++(this->statistics.transferCount);
+        this->selectAddress( device.getAddress() );
+
+        return this->port;
+    }
+
+    BlackI2C *BlackI2CBus::lock()
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+
+        if( this->getPort() == NULL )
+        {
+            pthread_mutex_unlock( &(this->busMutex) );
+            return NULL;
+        }
+
+        ++(this->statistics.transferCount);
+        return this->port;
+    }
+
+    void BlackI2CBus::unlock()
+    {
+        pthread_mutex_unlock( &(this->busMutex) );
+    }
+
+    void BlackI2CBus::enqueue(const BlackI2CBusDevice &device, BlackI2CTransaction &transaction)
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+
+        queuedTransaction item;
+        item.address        = device.getAddress();
+        item.order          = this->pending.size();
+        item.transaction    = &transaction;
+
+        this->pending.push_back(item);
+
+        pthread_mutex_unlock( &(this->queueMutex) );
+    }
+
+    bool BlackI2CBus::flush()
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+
+        pthread_mutex_lock( &(this->queueMutex) );
+        this->running.swap(this->pending);
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        if( this->running.empty() )
+        {
+            pthread_mutex_unlock( &(this->busMutex) );
+            return true;
+        }
+
+        if( this->getPort() == NULL )
+        {
+            this->statistics.failedCount += this->running.size();
+            this->running.clear();
+            pthread_mutex_unlock( &(this->busMutex) );
+            return false;
+        }
+
+        // groups are run in address order, starting with the group of currently bound address
+        std::sort(this->running.begin(), this->running.end());
+
+        queuedTransaction current;
+        current.address = static_cast<uint16_t>( this->port->getDeviceAddress() );
+        current.order   = 0;
+
+        std::vector<queuedTransaction>::iterator first = std::lower_bound(this->running.begin(), this->running.end(), current);
+        std::rotate(this->running.begin(), first, this->running.end());
+
+        bool isAllTransferred = true;
+        for( size_t i = 0 ; i < this->running.size() ; i++ )
+        {
+            ++(this->statistics.transferCount);
+            ++(this->statistics.queuedCount);
+            this->selectAddress( this->running[i].address );
+
+            if( not this->port->transfer( *(this->running[i].transaction) ) )
+            {
+                ++(this->statistics.failedCount);
+                isAllTransferred = false;
+            }
+        }
+
+        this->running.clear();
+
+        pthread_mutex_unlock( &(this->busMutex) );
+        return isAllTransferred;
+    }
+
+    size_t BlackI2CBus::getPendingCount()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        size_t count = this->pending.size();
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return count;
+    }
+
+    i2cName BlackI2CBus::getBusName()
+    {
+        return this->busName;
+    }
+
+    BlackI2CBusStatistics BlackI2CBus::getStatistics()
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+        BlackI2CBusStatistics temp = this->statistics;
+        pthread_mutex_unlock( &(this->busMutex) );
+
+        return temp;
+    }
+
+    void BlackI2CBus::resetStatistics()
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+        this->statistics = BlackI2CBusStatistics();
+        pthread_mutex_unlock( &(this->busMutex) );
+    }
+
+
+
+
+
+
+
+
+
+    BlackI2CBusDevice::BlackI2CBusDevice(BlackI2CBus &ownerBus, uint16_t deviceAddress)
+    {
+        this->bus       = &ownerBus;
+        this->address   = deviceAddress;
+    }
+
+    uint16_t BlackI2CBusDevice::getAddress() const
+    {
+        return this->address;
+    }
+
+    BlackI2CBus *BlackI2CBusDevice::getBus() const
+    {
+        return this->bus;
+    }
+
+    bool BlackI2CBusDevice::writeByte(uint8_t registerAddr, uint8_t value)
+    {
+        BlackI2C *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->writeByte(registerAddr, value);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackI2CBusDevice::readByte(uint8_t registerAddr, uint8_t &value)
+    {
+        BlackI2C *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        value       = port->readByte(registerAddr);
+        bool result = not port->fail(BlackI2C::readErr);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackI2CBusDevice::writeWord(uint8_t registerAddr, uint16_t value)
+    {
+        BlackI2C *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->writeWord(registerAddr, value);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackI2CBusDevice::readWord(uint8_t registerAddr, uint16_t &value)
+    {
+        BlackI2C *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        value       = port->readWord(registerAddr);
+        bool result = not port->fail(BlackI2C::readErr);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackI2CBusDevice::writeBlock(uint8_t registerAddr, const uint8_t *writeBuffer, size_t bufferSize, i2cBlockMode blockMode)
+    {
+        BlackI2C *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->writeLongBlock(registerAddr, writeBuffer, bufferSize, blockMode);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackI2CBusDevice::readBlock(uint8_t registerAddr, uint8_t *readBuffer, size_t bufferSize)
+    {
+        BlackI2C *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->readLongBlock(registerAddr, readBuffer, bufferSize);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackI2CBusDevice::transfer(BlackI2CTransaction &transaction)
+    {
+        BlackI2C *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->transfer(transaction);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    void BlackI2CBusDevice::enqueue(BlackI2CTransaction &transaction)
+    {
+        this->bus->enqueue(*this, transaction);
+    }
+
+
+
+} /* namespace BlackLib */
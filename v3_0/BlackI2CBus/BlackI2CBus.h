@@ -0,0 +1,359 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKI2CBUS_H_
+#define BLACKI2CBUS_H_
+
+#include "../BlackI2C/BlackI2C.h"
+
+#include <pthread.h>
+#include <vector>
+
+
+
+
+namespace BlackLib
+{
+
+    // ###################################### BLACKI2CBUSSTATISTICS DECLARATION STARTS ####################################### //
+
+    /*! @brief Holds counters of BlackI2CBus class.
+    */
+    struct BlackI2CBusStatistics
+    {
+        uint64_t    transferCount;          /*!< @brief is used to hold the number of locked bus accesses */
+        uint64_t    addressSwitchCount;     /*!< @brief is used to hold the number of accesses which use another slave address than the previous one */
+        uint64_t    queuedCount;            /*!< @brief is used to hold the number of transactions which are run by flush() */
+        uint64_t    failedCount;            /*!< @brief is used to hold the number of queued transactions which are failed */
+
+        /*! @brief Default constructor of BlackI2CBusStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackI2CBusStatistics()
+        {
+            transferCount       = 0;
+            addressSwitchCount  = 0;
+            queuedCount         = 0;
+            failedCount         = 0;
+        }
+    };
+    // ####################################### BLACKI2CBUSSTATISTICS DECLARATION ENDS ######################################## //
+
+
+
+
+
+    class BlackI2CBusDevice;
+
+    // ########################################### BLACKI2CBUS DECLARATION STARTS ############################################ //
+
+    /*! @brief Shares one i2c adapter between many devices and threads.
+     *
+     *    This class opens the i2c-dev file of adapter only once, when the first device is used, so all
+     *    devices of the bus use one file descriptor. Switching devices only changes the stored slave address.
+     *    I2C_SLAVE request is issued only by smbus, read and write functions, and only if another address
+     *    is bound to descriptor. Combined transfers and block functions carry the address in every message,
+     *    so they never bind it.
+     *
+     *    Every access is done while the bus lock is held, so slave address of one device can't be changed
+     *    by another thread in the middle of its transfer. The lock is a plain mutex, which costs one atomic
+     *    operation when it isn't contended.
+     *
+     *    Transactions can also be queued with BlackI2CBusDevice::enqueue() and run with flush(). flush()
+     *    takes the lock once for the whole batch and runs transactions grouped by slave address, starting
+     *    with the currently selected address. Transactions of the same device keep their order, transactions
+     *    of different devices may be reordered.
+     *
+     *    Devices are represented with lightweight BlackI2CBusDevice objects.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myI2cBusProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackI2CBus/BlackI2CBus.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackI2CBus       bus(BlackLib::I2C_1);
+     *
+     *      BlackLib::BlackI2CBusDevice accel(bus, 0x53);
+     *      BlackLib::BlackI2CBusDevice gyro(bus, 0x68);
+     *
+     *      uint8_t accelReg = 0x32, gyroReg = 0x43;
+     *      uint8_t accelData[6], gyroData[6];
+     *
+     *      BlackLib::BlackI2CTransaction accelRead, gyroRead;
+     *      accelRead.addWrite(&accelReg, 1).addRead(accelData, sizeof(accelData));
+     *      gyroRead.addWrite(&gyroReg, 1).addRead(gyroData, sizeof(gyroData));
+     *
+     *      accel.enqueue(accelRead);
+     *      gyro.enqueue(gyroRead);
+     *      accel.enqueue(accelRead);
+     *      bus.flush();                                            // accel, accel, gyro
+     *
+     *      std::cout << "Address switches: " << bus.getStatistics().addressSwitchCount << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackI2CBus
+    {
+        private:
+            /*! @brief Holds a queued transaction.
+            */
+            struct queuedTransaction
+            {
+                uint16_t                address;            /*!< @brief is used to hold the slave address of device */
+                size_t                  order;              /*!< @brief is used to hold the queueing order */
+                BlackI2CTransaction    *transaction;        /*!< @brief is used to hold the queued transaction */
+
+                /*! @brief Compares queued transactions by address, then by queueing order.
+                */
+                bool operator<(const queuedTransaction &other) const
+                {
+                    return (address != other.address) ? (address < other.address) : (order < other.order);
+                }
+            };
+
+            i2cName                 busName;                /*!< @brief is used to hold the i2c adapter name */
+            uint                    portOpenMode;           /*!< @brief is used to hold the open mode of i2c-dev file */
+            BlackI2C               *port;                   /*!< @brief is used to hold the i2c-dev object of adapter */
+            BlackI2CBusStatistics   statistics;             /*!< @brief is used to hold the counters of bus */
+            pthread_mutex_t         busMutex;               /*!< @brief is used to serialize the bus accesses */
+            pthread_mutex_t         queueMutex;             /*!< @brief is used to protect the queue */
+            std::vector<queuedTransaction> pending;         /*!< @brief is used to hold the queued transactions */
+            std::vector<queuedTransaction> running;         /*!< @brief is used to hold the transactions of current flush */
+
+            /*! @brief Opens the i2c-dev file if it isn't opened yet.
+            *
+            * This function must be called while the bus lock is held.
+            */
+            BlackI2C               *getPort();
+
+            /*! @brief Selects slave address of device, binding is left to the functions which need it.
+            *
+            * This function must be called while the bus lock is held.
+            */
+            void                    selectAddress(uint16_t address);
+
+        public:
+
+            /*! @brief Constructor of BlackI2CBus class.
+            *
+            * This function doesn't open any file. I2c-dev file is opened at first access.
+            *
+            * @param [in] bus               i2c adapter name (enum)
+            * @param [in] openMode          open mode of i2c-dev file
+            */
+                                    BlackI2CBus(i2cName bus, uint openMode = ReadWrite);
+
+            /*! @brief Destructor of BlackI2CBus class.
+            *
+            * This function closes the i2c-dev file. Devices of this bus must not be used after.
+            */
+            virtual                 ~BlackI2CBus();
+
+            /*! @brief Locks the bus for a device and selects its slave address.
+            *
+            * If this function returns a valid pointer, unlock() function must be called after the access.
+            * Users can use the returned object for a group of transfers which must not be interleaved with
+            * other threads. Device address of returned object must not be changed directly.
+            *
+            * @param [in] device            device which accesses the bus
+            * @return pointer of i2c-dev object, or NULL if the file can't open. In error case, the bus is not locked.
+            */
+            BlackI2C               *lock(const BlackI2CBusDevice &device);
+
+            /*! @brief Locks the bus without binding a slave address.
+            *
+            * This function is used for combined transactions whose messages carry their own slave
+            * addresses, so no I2C_SLAVE request is needed. If this function returns a valid pointer,
+            * unlock() function must be called after the access.
+            *
+            * @return pointer of i2c-dev object, or NULL if the file can't open. In error case, the bus is not locked.
+            */
+            BlackI2C               *lock();
+
+            /*! @brief Releases the bus lock.
+            *
+            */
+            void                    unlock();
+
+            /*! @brief Adds a transaction of a device to the queue.
+            *
+            * Transaction isn't copied, so it and its buffers must be valid until flush() returns.
+            *
+            * @param [in] device            device which owns the transaction
+            * @param [in] transaction       message list, messages with I2C_OWN_ADDRESS take address of device
+            */
+            void                    enqueue(const BlackI2CBusDevice &device, BlackI2CTransaction &transaction);
+
+            /*! @brief Runs queued transactions.
+            *
+            * The bus is locked once and transactions are run grouped by slave address.
+            *
+            * @return true if all transactions are transferred, else false.
+            */
+            bool                    flush();
+
+            /*! @brief Exports the number of queued transactions.
+            *
+            */
+            size_t                  getPendingCount();
+
+            /*! @brief Exports adapter name.
+            *
+            */
+            i2cName                 getBusName();
+
+            /*! @brief Exports the counters of bus.
+            *
+            * @return copy of BlackI2CBusStatistics struct.
+            */
+            BlackI2CBusStatistics   getStatistics();
+
+            /*! @brief Clears the counters of bus.
+            *
+            */
+            void                    resetStatistics();
+    };
+    // ############################################ BLACKI2CBUS DECLARATION ENDS ############################################# //
+
+
+
+
+
+
+
+
+
+
+    // ######################################## BLACKI2CBUSDEVICE DECLARATION STARTS ######################################### //
+
+    /*! @brief Lightweight handle of a device which is connected to a BlackI2CBus.
+     *
+     *    This class holds only the bus pointer and the slave address of device. All transfer functions
+     *    lock the bus, select the address and release the bus after transfer. Objects don't open
+     *    any file, so a handle can be created for every device of the bus cheaply.
+     *
+     *    Example usage is shown in BlackI2CBus class.
+     */
+    class BlackI2CBusDevice
+    {
+        private:
+            BlackI2CBus            *bus;                    /*!< @brief is used to hold the owner bus */
+            uint16_t                address;                /*!< @brief is used to hold the slave address */
+
+        public:
+
+            /*! @brief Constructor of BlackI2CBusDevice class.
+            *
+            * @param [in] ownerBus          bus which the device is connected
+            * @param [in] deviceAddress     slave address of device
+            */
+                                    BlackI2CBusDevice(BlackI2CBus &ownerBus, uint16_t deviceAddress);
+
+            /*! @brief Exports slave address of device.
+            *
+            */
+            uint16_t                getAddress() const;
+
+            /*! @brief Exports owner bus of device.
+            *
+            */
+            BlackI2CBus            *getBus() const;
+
+            /*! @brief Writes byte value to a register.
+            *
+            * @sa BlackI2C::writeByte()
+            */
+            bool                    writeByte(uint8_t registerAddr, uint8_t value);
+
+            /*! @brief Reads byte value from a register.
+            *
+            * @param [in] registerAddr      register address
+            * @param [out] value            read value
+            * @return true if reading successful, else false.
+            *
+            * @sa BlackI2C::readByte()
+            */
+            bool                    readByte(uint8_t registerAddr, uint8_t &value);
+
+            /*! @brief Writes word value to a register.
+            *
+            * @sa BlackI2C::writeWord()
+            */
+            bool                    writeWord(uint8_t registerAddr, uint16_t value);
+
+            /*! @brief Reads word value from a register.
+            *
+            * @param [in] registerAddr      register address
+            * @param [out] value            read value
+            * @return true if reading successful, else false.
+            *
+            * @sa BlackI2C::readWord()
+            */
+            bool                    readWord(uint8_t registerAddr, uint16_t &value);
+
+            /*! @brief Writes data block of any length to a register.
+            *
+            * @sa BlackI2C::writeLongBlock()
+            */
+            bool                    writeBlock(uint8_t registerAddr, const uint8_t *writeBuffer, size_t bufferSize,
+                                               i2cBlockMode blockMode = I2cFixedRegister);
+
+            /*! @brief Reads data block of any length from a register.
+            *
+            * @sa BlackI2C::readLongBlock()
+            */
+            bool                    readBlock(uint8_t registerAddr, uint8_t *readBuffer, size_t bufferSize);
+
+            /*! @brief Sends a combined transaction.
+            *
+            * @sa BlackI2C::transfer(BlackI2CTransaction&)
+            */
+            bool                    transfer(BlackI2CTransaction &transaction);
+
+            /*! @brief Adds a transaction to the queue of bus.
+            *
+            * @sa BlackI2CBus::enqueue()
+            */
+            void                    enqueue(BlackI2CTransaction &transaction);
+    };
+    // ######################################### BLACKI2CBUSDEVICE DECLARATION ENDS ########################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKI2CBUS_H_ */
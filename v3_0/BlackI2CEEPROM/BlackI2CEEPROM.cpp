@@ -0,0 +1,265 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackI2CEEPROM.h"
+#include "../BlackTime/BlackTime.h"
+#include <algorithm>
+
+
+
+
+
+namespace BlackLib
+{
+
+    /*! @brief Memory size, page size and address length of every eepromModel value.
+    */
+    static const struct
+    {
+        uint32_t    size;
+        uint16_t    page;
+        uint8_t     addressLength;
+    } eepromModels[] = {    {   128,   8, 1 },
+                            {   256,   8, 1 },
+                            {   512,  16, 1 },
+                            {  1024,  16, 1 },
+                            {  2048,  16, 1 },
+                            {  4096,  32, 2 },
+                            {  8192,  32, 2 },
+                            { 16384,  64, 2 },
+                            { 32768,  64, 2 },
+                            { 65536, 128, 2 }
+                        };
+
+
+
+    BlackI2CEEPROM::BlackI2CEEPROM(BlackI2C *i2c, eepromModel model)
+    {
+        this->i2cObject         = i2c;
+        this->memorySize        = eepromModels[model].size;
+        this->pageSize          = eepromModels[model].page;
+        this->addressLength     = eepromModels[model].addressLength;
+        this->isCompareEnabled  = true;
+        this->writeTimeout      = 10000000;
+
+        this->pageBuffer.resize(this->pageSize + this->addressLength);
+        this->compareBuffer.resize(this->pageSize);
+    }
+
+    uint16_t BlackI2CEEPROM::getSlaveAddress(uint32_t memoryAddress)
+    {
+        uint16_t slave = static_cast<uint16_t>( this->i2cObject->getDeviceAddress() );
+
+        if( this->addressLength == 1 )
+        {
+            slave |= static_cast<uint16_t>( (memoryAddress >> 8) & 0x07 );
+        }
+
+        return slave;
+    }
+
+    uint8_t BlackI2CEEPROM::fillAddress(uint32_t memoryAddress, uint8_t *buffer)
+    {
+        if( this->addressLength == 1 )
+        {
+            buffer[0] = static_cast<uint8_t>(memoryAddress & 0xFF);
+        }
+        else
+        {
+            buffer[0] = static_cast<uint8_t>((memoryAddress >> 8) & 0xFF);
+            buffer[1] = static_cast<uint8_t>(memoryAddress & 0xFF);
+        }
+
+        return this->addressLength;
+    }
+
+    bool BlackI2CEEPROM::readRange(uint32_t memoryAddress, uint8_t *readBuffer, size_t size)
+    {
+        uint16_t slave = this->getSlaveAddress(memoryAddress);
+
+        this->transaction.clear();
+        this->transaction.addWrite(this->addressBytes, this->fillAddress(memoryAddress, this->addressBytes), 0, slave);
+
+        for( size_t offset = 0 ; offset < size ; offset += I2C_MAX_MESSAGE_LENGTH )
+        {
+            size_t length = std::min(size - offset, I2C_MAX_MESSAGE_LENGTH);
+            this->transaction.addRead(readBuffer + offset, static_cast<uint16_t>(length), 0, slave);
+        }
+
+        return this->i2cObject->transfer(this->transaction);
+    }
+
+    bool BlackI2CEEPROM::waitWriteCycle(uint32_t memoryAddress)
+    {
+        uint16_t slave  = this->getSlaveAddress(memoryAddress);
+        uint8_t length  = this->fillAddress(memoryAddress, this->addressBytes);
+        uint64_t start  = BlackTime::getMonotonicTime();
+
+        while( true )
+        {
+            this->transaction.clear();
+            this->transaction.addWrite(this->addressBytes, length, 0, slave);
+
+            if( this->i2cObject->transfer(this->transaction) )
+            {
+                return true;
+            }
+
+            ++(this->statistics.pollCount);
+
+            if( BlackTime::getMonotonicTime() - start > this->writeTimeout )
+            {
+                return false;
+            }
+        }
+    }
+
+    bool BlackI2CEEPROM::write(uint32_t memoryAddress, const uint8_t *writeBuffer, size_t size)
+    {
+        if( memoryAddress > this->memorySize or size > this->memorySize - memoryAddress )
+        {
+            return false;
+        }
+
+        uint64_t start      = BlackTime::getMonotonicTime();
+        bool isWritten      = true;
+        size_t offset       = 0;
+
+        while( isWritten and offset < size )
+        {
+            uint32_t address    = memoryAddress + static_cast<uint32_t>(offset);
+            size_t length       = std::min(size - offset, static_cast<size_t>(this->pageSize - (address % this->pageSize)));
+
+            if( this->isCompareEnabled and
+                this->readRange(address, &(this->compareBuffer[0]), length) and
+                memcmp(&(this->compareBuffer[0]), writeBuffer + offset, length) == 0 )
+            {
+                ++(this->statistics.pageSkipCount);
+                offset += length;
+                continue;
+            }
+
+            uint8_t headerLength = this->fillAddress(address, &(this->pageBuffer[0]));
+            memcpy(&(this->pageBuffer[headerLength]), writeBuffer + offset, length);
+
+            this->transaction.clear();
+            this->transaction.addWrite(&(this->pageBuffer[0]), static_cast<uint16_t>(headerLength + length), 0,
+                                       this->getSlaveAddress(address));
+
+            isWritten = ( this->i2cObject->transfer(this->transaction) and this->waitWriteCycle(address) );
+
+            if( isWritten )
+            {
+                ++(this->statistics.pageWriteCount);
+                this->statistics.writtenBytes += length;
+                offset += length;
+            }
+        }
+
+        this->statistics.requestedBytes += offset;
+        this->statistics.writeTime      += BlackTime::getMonotonicTime() - start;
+
+        return isWritten;
+    }
+
+    bool BlackI2CEEPROM::read(uint32_t memoryAddress, uint8_t *readBuffer, size_t size)
+    {
+        if( memoryAddress > this->memorySize or size > this->memorySize - memoryAddress )
+        {
+            return false;
+        }
+
+        uint64_t start      = BlackTime::getMonotonicTime();
+        bool isRead         = true;
+        size_t offset       = 0;
+
+        // memories with one address byte select 256 byte blocks with device address
+        const size_t blockSize = (this->addressLength == 1) ? 256 : this->memorySize;
+
+        while( isRead and offset < size )
+        {
+            uint32_t address    = memoryAddress + static_cast<uint32_t>(offset);
+            size_t length       = std::min(size - offset, blockSize - (address % blockSize));
+
+            isRead = this->readRange(address, readBuffer + offset, length);
+
+            if( isRead )
+            {
+                offset += length;
+            }
+        }
+
+        this->statistics.readBytes  += offset;
+        this->statistics.readTime   += BlackTime::getMonotonicTime() - start;
+
+        return isRead;
+    }
+
+    void BlackI2CEEPROM::setCompareBeforeWrite(bool isEnabled)
+    {
+        this->isCompareEnabled = isEnabled;
+    }
+
+    void BlackI2CEEPROM::setWriteTimeout(uint64_t timeout, timeType tType)
+    {
+        switch(tType)
+        {
+            case nanosecond:    { this->writeTimeout = timeout;                  break; }
+            case microsecond:   { this->writeTimeout = timeout * 1000;           break; }
+            case milisecond:    { this->writeTimeout = timeout * 1000000;        break; }
+            case second:        { this->writeTimeout = timeout * 1000000000ULL;  break; }
+            default:            { break; }
+        }
+    }
+
+    uint32_t BlackI2CEEPROM::getSize()
+    {
+        return this->memorySize;
+    }
+
+    uint16_t BlackI2CEEPROM::getPageSize()
+    {
+        return this->pageSize;
+    }
+
+    BlackEEPROMStatistics BlackI2CEEPROM::getStatistics()
+    {
+        return this->statistics;
+    }
+
+    void BlackI2CEEPROM::resetStatistics()
+    {
+        this->statistics = BlackEEPROMStatistics();
+    }
+
+
+
+} /* namespace BlackLib */
@@ -0,0 +1,277 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKI2CEEPROM_H_
+#define BLACKI2CEEPROM_H_
+
+#include "../BlackI2C/BlackI2C.h"
+
+#include <vector>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting the memory size of BlackI2CEEPROM.
+    */
+    enum eepromModel        {   EEPROM_24C01            = 0,    /*!< 128 bytes, 8 byte pages */
+                                EEPROM_24C02            = 1,    /*!< 256 bytes, 8 byte pages */
+                                EEPROM_24C04            = 2,    /*!< 512 bytes, 16 byte pages, block is selected with device address */
+                                EEPROM_24C08            = 3,    /*!< 1 KiB, 16 byte pages, block is selected with device address */
+                                EEPROM_24C16            = 4,    /*!< 2 KiB, 16 byte pages, block is selected with device address */
+                                EEPROM_24C32            = 5,    /*!< 4 KiB, 32 byte pages */
+                                EEPROM_24C64            = 6,    /*!< 8 KiB, 32 byte pages */
+                                EEPROM_24C128           = 7,    /*!< 16 KiB, 64 byte pages */
+                                EEPROM_24C256           = 8,    /*!< 32 KiB, 64 byte pages */
+                                EEPROM_24C512           = 9     /*!< 64 KiB, 128 byte pages */
+                            };
+
+
+
+
+
+    // ###################################### BLACKEEPROMSTATISTICS DECLARATION STARTS ####################################### //
+
+    /*! @brief Holds counters of BlackI2CEEPROM class.
+    *
+    *    All time values are at nanosecond (ns) level. Write time includes compare reads and write cycles.
+    */
+    struct BlackEEPROMStatistics
+    {
+        uint64_t    requestedBytes;         /*!< @brief is used to hold the number of bytes which are passed to write() */
+        uint64_t    writtenBytes;           /*!< @brief is used to hold the number of bytes which are sent with page writes */
+        uint64_t    pageWriteCount;         /*!< @brief is used to hold the number of page writes */
+        uint64_t    pageSkipCount;          /*!< @brief is used to hold the number of page writes which are skipped because content is unchanged */
+        uint64_t    pollCount;              /*!< @brief is used to hold the number of not acknowledged polls while write cycles */
+        uint64_t    writeTime;              /*!< @brief is used to hold the total time of write() calls */
+        uint64_t    readBytes;              /*!< @brief is used to hold the number of bytes which are read with read() */
+        uint64_t    readTime;               /*!< @brief is used to hold the total time of read() calls */
+
+        /*! @brief Default constructor of BlackEEPROMStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackEEPROMStatistics()
+        {
+            requestedBytes  = 0;
+            writtenBytes    = 0;
+            pageWriteCount  = 0;
+            pageSkipCount   = 0;
+            pollCount       = 0;
+            writeTime       = 0;
+            readBytes       = 0;
+            readTime        = 0;
+        }
+
+        /*! @brief Calculates effective write throughput.
+         *
+         *  @return requested bytes per second, skipped pages are counted as written.
+         */
+        double getWriteThroughput() const
+        {
+            return ( (writeTime == 0) ? 0.0 : (requestedBytes * 1000000000.0 / writeTime) );
+        }
+
+        /*! @brief Calculates read throughput.
+         *
+         *  @return read bytes per second.
+         */
+        double getReadThroughput() const
+        {
+            return ( (readTime == 0) ? 0.0 : (readBytes * 1000000000.0 / readTime) );
+        }
+    };
+    // ####################################### BLACKEEPROMSTATISTICS DECLARATION ENDS ######################################## //
+
+
+
+
+
+
+
+
+
+
+    // ########################################## BLACKI2CEEPROM DECLARATION STARTS ########################################## //
+
+    /*! @brief Reads and writes 24Cxx serial EEPROMs.
+     *
+     *    This class splits writes on page boundaries and sends every page part with one maximal page
+     *    write. After a page write, the end of internal write cycle is detected with acknowledge polling:
+     *    the memory doesn't acknowledge its address while it is busy, so address writes are repeated until
+     *    one is acknowledged, instead of sleeping for the worst case write cycle time.
+     *
+     *    If comparing is enabled, every page part is read before writing and it isn't written if its
+     *    content is unchanged. Reading a page is much faster than a write cycle, and unchanged pages
+     *    don't wear the memory.
+     *
+     *    All transfers use I2C_RDWR requests with explicit slave addresses, so block select bits of 24C04,
+     *    24C08 and 24C16 are added to device address of i2c object for every transfer. Reads are done with
+     *    sequential reads and they aren't limited to pages.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myEepromProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackI2CEEPROM/BlackI2CEEPROM.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackI2C  myI2c(BlackLib::I2C_1, 0x50);
+     *      myI2c.open( BlackLib::ReadWrite );
+     *
+     *      BlackLib::BlackI2CEEPROM memory(&myI2c, BlackLib::EEPROM_24C256);
+     *
+     *      uint8_t logRecord[200];
+     *      memory.write(0x0100, logRecord, sizeof(logRecord));     // 4 page writes
+     *
+     *      uint8_t check[200];
+     *      memory.read(0x0100, check, sizeof(check));
+     *
+     *      std::cout << "Write throughput: " << memory.getStatistics().getWriteThroughput() << " B/s" << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackI2CEEPROM
+    {
+        private:
+            BlackI2C               *i2cObject;              /*!< @brief is used to hold the opened i2c device */
+            uint32_t                memorySize;             /*!< @brief is used to hold the memory size in bytes */
+            uint16_t                pageSize;               /*!< @brief is used to hold the page size in bytes */
+            uint8_t                 addressLength;          /*!< @brief is used to hold the byte count of memory address */
+            bool                    isCompareEnabled;       /*!< @brief is used to hold the compare before write state */
+            uint64_t                writeTimeout;           /*!< @brief is used to hold the maximum write cycle time at nanosecond level */
+            std::vector<uint8_t>    pageBuffer;             /*!< @brief is used to hold the address and data of page writes */
+            std::vector<uint8_t>    compareBuffer;          /*!< @brief is used to hold the current content of pages */
+            uint8_t                 addressBytes[2];        /*!< @brief is used to hold the memory address of reads and polls */
+            BlackI2CTransaction     transaction;            /*!< @brief is used to hold the messages of current transfer */
+            BlackEEPROMStatistics   statistics;             /*!< @brief is used to hold the counters */
+
+            /*! @brief Calculates slave address of a memory address.
+            *
+            * Block select bits of small memories are added to device address.
+            */
+            uint16_t                getSlaveAddress(uint32_t memoryAddress);
+
+            /*! @brief Writes memory address bytes to a buffer.
+            *
+            * @return byte count of memory address.
+            */
+            uint8_t                 fillAddress(uint32_t memoryAddress, uint8_t *buffer);
+
+            /*! @brief Reads a range which doesn't cross a block of small memories.
+            *
+            */
+            bool                    readRange(uint32_t memoryAddress, uint8_t *readBuffer, size_t size);
+
+            /*! @brief Waits the end of write cycle with acknowledge polling.
+            *
+            * @return true if memory acknowledges before timeout, else false.
+            */
+            bool                    waitWriteCycle(uint32_t memoryAddress);
+
+        public:
+
+            /*! @brief Constructor of BlackI2CEEPROM class.
+            *
+            * @param [in] i2c               opened i2c device, its device address is the base address of memory
+            * @param [in] model             memory size (enum)
+            */
+                                    BlackI2CEEPROM(BlackI2C *i2c, eepromModel model);
+
+            /*! @brief Writes data to memory.
+            *
+            * Data is split on page boundaries and every part is written with one page write.
+            *
+            * @param [in] memoryAddress     first memory address
+            * @param [in] writeBuffer       data buffer pointer
+            * @param [in] size              data size
+            * @return true if all data is written, else false.
+            */
+            bool                    write(uint32_t memoryAddress, const uint8_t *writeBuffer, size_t size);
+
+            /*! @brief Reads data from memory.
+            *
+            * @param [in] memoryAddress     first memory address
+            * @param [out] readBuffer       buffer pointer
+            * @param [in] size              data size
+            * @return true if all data is read, else false.
+            */
+            bool                    read(uint32_t memoryAddress, uint8_t *readBuffer, size_t size);
+
+            /*! @brief Enables or disables reading pages before writing them.
+            *
+            * It is enabled by default.
+            */
+            void                    setCompareBeforeWrite(bool isEnabled);
+
+            /*! @brief Changes maximum write cycle time.
+            *
+            * Default value is 10 ms.
+            *
+            * @param [in] timeout           maximum write cycle time
+            * @param [in] tType             time type of timeout (enum)
+            */
+            void                    setWriteTimeout(uint64_t timeout, timeType tType = milisecond);
+
+            /*! @brief Exports memory size in bytes.
+            *
+            */
+            uint32_t                getSize();
+
+            /*! @brief Exports page size in bytes.
+            *
+            */
+            uint16_t                getPageSize();
+
+            /*! @brief Exports the counters.
+            *
+            * @return copy of BlackEEPROMStatistics struct.
+            */
+            BlackEEPROMStatistics   getStatistics();
+
+            /*! @brief Clears the counters.
+            *
+            */
+            void                    resetStatistics();
+    };
+    // ########################################### BLACKI2CEEPROM DECLARATION ENDS ########################################### //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKI2CEEPROM_H_ */
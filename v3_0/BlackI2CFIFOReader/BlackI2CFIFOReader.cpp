@@ -0,0 +1,256 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackI2CFIFOReader.h"
+#include "../BlackTime/BlackTime.h"
+#include <algorithm>
+
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+#include <arm_neon.h>
+#endif
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackI2CFIFOReader::BlackI2CFIFOReader(BlackI2C *i2c, const BlackFIFODescription &fifo, uint32_t outputDataRate,
+                                           size_t maxFrameCount)
+    {
+        this->i2cObject         = i2c;
+        this->description       = fifo;
+        this->frameSize         = 2 * static_cast<size_t>(fifo.channelCount);
+        this->maxFrames         = (maxFrameCount == 0) ? 1 : maxFrameCount;
+        this->frameCount        = 0;
+        this->drainCount        = 0;
+
+        if( this->description.countLength < 1 or this->description.countLength > 2 )
+        {
+            this->description.countLength = 2;
+        }
+
+        this->rawBuffer.resize(this->maxFrames * this->frameSize);
+        this->wordBuffer.resize(this->maxFrames * fifo.channelCount);
+
+        this->countTransaction.addWrite(&(this->description.countRegister), 1);
+        this->countTransaction.addRead(this->countBytes, this->description.countLength);
+
+        this->setOutputDataRate(outputDataRate);
+    }
+
+    void BlackI2CFIFOReader::setOutputDataRate(uint32_t outputDataRate)
+    {
+        this->nominalPeriod     = 1000000000ULL / ((outputDataRate == 0) ? 1 : outputDataRate);
+        this->estimatedPeriod   = this->nominalPeriod;
+        this->lastDrainTime     = 0;
+        this->leftoverFrames    = 0;
+    }
+
+    size_t BlackI2CFIFOReader::readFrameCount()
+    {
+        if( this->frameSize == 0 or not this->i2cObject->transfer(this->countTransaction) )
+        {
+            return 0;
+        }
+
+        uint16_t count = this->countBytes[0];
+
+        if( this->description.countLength == 2 )
+        {
+            count = this->description.isCountBigEndian ? static_cast<uint16_t>((this->countBytes[0] << 8) | this->countBytes[1])
+                                                       : static_cast<uint16_t>((this->countBytes[1] << 8) | this->countBytes[0]);
+        }
+
+        count &= this->description.countMask;
+
+        return this->description.isCountInFrames ? count : (count / this->frameSize);
+    }
+
+    void BlackI2CFIFOReader::parseFrames(size_t count, int16_t *const *channels)
+    {
+        const uint8_t  *raw         = &(this->rawBuffer[0]);
+        int16_t        *words       = &(this->wordBuffer[0]);
+        const size_t    wordCount   = count * this->description.channelCount;
+        size_t          i           = 0;
+
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+        // 8 words per step: big endian words only need their bytes reversed at a little endian cpu
+        uint8_t *wordBytes = reinterpret_cast<uint8_t*>(words);
+
+        if( this->description.isDataBigEndian )
+        {
+            for( ; i + 8 <= wordCount ; i += 8 )
+            {
+                vst1q_u8(wordBytes + 2 * i, vrev16q_u8( vld1q_u8(raw + 2 * i) ));
+            }
+        }
+        else
+        {
+            for( ; i + 8 <= wordCount ; i += 8 )
+            {
+                vst1q_u8(wordBytes + 2 * i, vld1q_u8(raw + 2 * i));
+            }
+        }
+#endif
+
+        // contiguous pass over all words, byte order is checked once instead of for every word
+        if( this->description.isDataBigEndian )
+        {
+            for( ; i < wordCount ; i++ )
+            {
+                words[i] = static_cast<int16_t>( (raw[2 * i] << 8) | raw[2 * i + 1] );
+            }
+        }
+        else
+        {
+            for( ; i < wordCount ; i++ )
+            {
+                words[i] = static_cast<int16_t>( (raw[2 * i + 1] << 8) | raw[2 * i] );
+            }
+        }
+
+        const size_t stride = this->description.channelCount;
+        size_t frame        = 0;
+
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+        // 8 frames per step: de-interleaving loads split 3 axis frames directly
+        if( stride == 3 )
+        {
+            for( ; frame + 8 <= count ; frame += 8 )
+            {
+                int16x8x3_t axes = vld3q_s16(words + 3 * frame);
+
+                vst1q_s16(channels[0] + frame, axes.val[0]);
+                vst1q_s16(channels[1] + frame, axes.val[1]);
+                vst1q_s16(channels[2] + frame, axes.val[2]);
+            }
+        }
+        else if( stride == 6 )
+        {
+            // every lane of a 3-way load holds channel k and k+3 alternately, unzipping two loads separates them
+            for( ; frame + 8 <= count ; frame += 8 )
+            {
+                int16x8x3_t first   = vld3q_s16(words + 6 * frame);
+                int16x8x3_t second  = vld3q_s16(words + 6 * frame + 24);
+
+                for( size_t k = 0 ; k < 3 ; k++ )
+                {
+                    int16x8x2_t pair = vuzpq_s16(first.val[k], second.val[k]);
+
+                    vst1q_s16(channels[k] + frame,     pair.val[0]);
+                    vst1q_s16(channels[k + 3] + frame, pair.val[1]);
+                }
+            }
+        }
+#endif
+
+        for( size_t channel = 0 ; channel < stride ; channel++ )
+        {
+            int16_t        *output  = channels[channel];
+            const int16_t  *input   = words + channel;
+
+            for( size_t j = frame ; j < count ; j++ )
+            {
+                output[j] = input[j * stride];
+            }
+        }
+    }
+
+    size_t BlackI2CFIFOReader::drain(int16_t *const *channels, uint64_t *timestamps, size_t maxCount)
+    {
+        size_t available    = this->readFrameCount();
+        uint64_t drainTime  = BlackTime::getMonotonicTime();
+        size_t count        = std::min(available, std::min(maxCount, this->maxFrames));
+
+        if( count == 0 )
+        {
+            return 0;
+        }
+
+        if( not this->i2cObject->readLongBlock(this->description.dataRegister, &(this->rawBuffer[0]), count * this->frameSize) )
+        {
+            return 0;
+        }
+
+        this->parseFrames(count, channels);
+
+        // frames which are produced since the last drain correct the period of sensor's oscillator
+        if( this->lastDrainTime != 0 and available > this->leftoverFrames )
+        {
+            uint64_t measured = (drainTime - this->lastDrainTime) / (available - this->leftoverFrames);
+
+            if( measured > this->nominalPeriod - this->nominalPeriod / 10 and
+                measured < this->nominalPeriod + this->nominalPeriod / 10 )
+            {
+                int64_t difference      = static_cast<int64_t>(measured) - static_cast<int64_t>(this->estimatedPeriod);
+                this->estimatedPeriod   = static_cast<uint64_t>( static_cast<int64_t>(this->estimatedPeriod) + difference / 8 );
+            }
+        }
+
+        if( timestamps != NULL )
+        {
+            const uint64_t period   = this->estimatedPeriod;
+            const uint64_t oldest   = drainTime - (available - 1) * period;
+
+            for( size_t i = 0 ; i < count ; i++ )
+            {
+                timestamps[i] = oldest + i * period;
+            }
+        }
+
+        this->lastDrainTime     = drainTime;
+        this->leftoverFrames    = available - count;
+        this->frameCount       += count;
+        ++(this->drainCount);
+
+        return count;
+    }
+
+    double BlackI2CFIFOReader::getEstimatedRate()
+    {
+        return 1000000000.0 / this->estimatedPeriod;
+    }
+
+    uint64_t BlackI2CFIFOReader::getFrameCount()
+    {
+        return this->frameCount;
+    }
+
+    uint64_t BlackI2CFIFOReader::getDrainCount()
+    {
+        return this->drainCount;
+    }
+
+
+
+} /* namespace BlackLib */
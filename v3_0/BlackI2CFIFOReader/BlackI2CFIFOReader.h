@@ -0,0 +1,227 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKI2CFIFOREADER_H_
+#define BLACKI2CFIFOREADER_H_
+
+#include "../BlackI2C/BlackI2C.h"
+
+#include <vector>
+
+
+
+
+namespace BlackLib
+{
+
+    // ###################################### BLACKFIFODESCRIPTION DECLARATION STARTS ######################################## //
+
+    /*! @brief Describes the fifo registers and frame layout of a sensor.
+    *
+    *    Default values describe MPU-6050 / MPU-9250 family with accelerometer and gyroscope in fifo:
+    *    big endian 13 bit byte count at 0x72, data at 0x74 and six 16 bit big endian channels per frame.
+    */
+    struct BlackFIFODescription
+    {
+        uint8_t     countRegister;          /*!< @brief is used to hold the first register address of fifo count */
+        uint8_t     countLength;            /*!< @brief is used to hold the byte count of fifo count, 1 or 2 */
+        bool        isCountBigEndian;       /*!< @brief is used to hold the byte order of fifo count */
+        uint16_t    countMask;              /*!< @brief is used to hold the valid bits of fifo count */
+        bool        isCountInFrames;        /*!< @brief is used to hold whether fifo count is in frames instead of bytes */
+        uint8_t     dataRegister;           /*!< @brief is used to hold the fifo data register address */
+        uint8_t     channelCount;           /*!< @brief is used to hold the number of 16 bit channels of one frame */
+        bool        isDataBigEndian;        /*!< @brief is used to hold the byte order of channel values */
+
+        /*! @brief Default constructor of BlackFIFODescription struct.
+         *
+         *  This function sets MPU-6050 values.
+         */
+        BlackFIFODescription()
+        {
+            countRegister       = 0x72;
+            countLength         = 2;
+            isCountBigEndian    = true;
+            countMask           = 0x1FFF;
+            isCountInFrames     = false;
+            dataRegister        = 0x74;
+            channelCount        = 6;
+            isDataBigEndian     = true;
+        }
+    };
+    // ####################################### BLACKFIFODESCRIPTION DECLARATION ENDS ######################################### //
+
+
+
+
+
+
+
+
+
+
+    // ######################################## BLACKI2CFIFOREADER DECLARATION STARTS ######################################## //
+
+    /*! @brief Drains the sample fifo of an i2c sensor with burst reads.
+     *
+     *    This class reads the fifo count with one combined transfer, then reads all complete frames with one
+     *    long block read, instead of reading every channel of every sample with separate word reads. Frames
+     *    are parsed in two passes over whole buffers: 16 bit values are assembled from the byte stream, then they
+     *    are de-interleaved into one array per channel (struct of arrays). When the library is compiled with
+     *    NEON support (-mfpu=neon), both passes handle 8 values or frames at a time with NEON instructions:
+     *    bytes are reversed with vrev16, and 3 or 6 channel frames are split with de-interleaving loads.
+     *    Other channel counts and the remaining frames are handled with scalar loops.
+     *
+     *    Fifo doesn't hold timestamps, so a timestamp is reconstructed for every frame. The newest frame is
+     *    assumed to be taken at drain time and older frames are placed backwards with the sample period.
+     *    Sample period is started from the output data rate and it is corrected with the drain times and
+     *    frame counts of consecutive drains, so the drift of sensor's oscillator is followed.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myFifoProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackI2CFIFOReader/BlackI2CFIFOReader.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackI2C  myImu(BlackLib::I2C_1, 0x68);
+     *      myImu.open( BlackLib::ReadWrite );
+     *
+     *      // fifo of sensor is configured and enabled before
+     *      BlackLib::BlackI2CFIFOReader fifo(&myImu, BlackLib::BlackFIFODescription(), 1000, 170);
+     *
+     *      int16_t ax[170], ay[170], az[170], gx[170], gy[170], gz[170];
+     *      int16_t *channels[6] = { ax, ay, az, gx, gy, gz };
+     *      uint64_t timestamps[170];
+     *
+     *      while( true )
+     *      {
+     *          usleep(50000);
+     *          size_t count = fifo.drain(channels, timestamps, 170);
+     *          if( count > 0 )
+     *          {
+     *              std::cout << count << " frames, last az: " << az[count - 1] << " at " << timestamps[count - 1] << std::endl;
+     *          }
+     *      }
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackI2CFIFOReader
+    {
+        private:
+            BlackI2C               *i2cObject;              /*!< @brief is used to hold the opened i2c device */
+            BlackFIFODescription    description;            /*!< @brief is used to hold the fifo layout */
+            size_t                  frameSize;              /*!< @brief is used to hold the byte count of one frame */
+            size_t                  maxFrames;              /*!< @brief is used to hold the maximum frame count of one drain */
+            std::vector<uint8_t>    rawBuffer;              /*!< @brief is used to hold the bytes which are read from fifo */
+            std::vector<int16_t>    wordBuffer;             /*!< @brief is used to hold the assembled channel values in fifo order */
+            BlackI2CTransaction     countTransaction;       /*!< @brief is used to hold the messages of fifo count read */
+            uint8_t                 countBytes[2];          /*!< @brief is used to hold the received fifo count */
+            uint64_t                nominalPeriod;          /*!< @brief is used to hold the sample period of output data rate at nanosecond level */
+            uint64_t                estimatedPeriod;        /*!< @brief is used to hold the corrected sample period at nanosecond level */
+            uint64_t                lastDrainTime;          /*!< @brief is used to hold the monotonic time of last drain, 0 if there isn't */
+            size_t                  leftoverFrames;         /*!< @brief is used to hold the frame count which is left in fifo at last drain */
+            uint64_t                frameCount;             /*!< @brief is used to hold the total number of read frames */
+            uint64_t                drainCount;             /*!< @brief is used to hold the number of drains which read frames */
+
+            /*! @brief Assembles channel values and copies them to channel arrays.
+            *
+            * Byte order and de-interleaving passes use NEON instructions if they are available.
+            */
+            void                    parseFrames(size_t count, int16_t *const *channels);
+
+            /*! @brief Copying is disabled, because count transaction points to members of its own object.
+            */
+                                    BlackI2CFIFOReader(const BlackI2CFIFOReader &);
+            BlackI2CFIFOReader&     operator=(const BlackI2CFIFOReader &);
+
+        public:
+
+            /*! @brief Constructor of BlackI2CFIFOReader class.
+            *
+            * @param [in] i2c               opened i2c device of sensor
+            * @param [in] fifo              fifo registers and frame layout
+            * @param [in] outputDataRate    sample rate of fifo in Hz
+            * @param [in] maxFrameCount     maximum frame count of one drain, it sets the size of internal buffers
+            */
+                                    BlackI2CFIFOReader(BlackI2C *i2c, const BlackFIFODescription &fifo, uint32_t outputDataRate,
+                                                       size_t maxFrameCount = 256);
+
+            /*! @brief Reads the fifo count of sensor.
+            *
+            * @return frame count of complete frames in fifo, or 0 if reading fails.
+            */
+            size_t                  readFrameCount();
+
+            /*! @brief Reads complete frames from fifo.
+            *
+            * At most maxCount frames are read, remaining frames stay in fifo for the next call.
+            *
+            * @param [out] channels         array of channel arrays, every array must have place for maxCount values
+            * @param [out] timestamps       array of frame timestamps at monotonic nanosecond level, can be NULL
+            * @param [in] maxCount          maximum frame count
+            * @return number of read frames.
+            */
+            size_t                  drain(int16_t *const *channels, uint64_t *timestamps, size_t maxCount);
+
+            /*! @brief Changes the output data rate.
+            *
+            * Estimated period is reset to the new nominal period.
+            *
+            * @param [in] outputDataRate    sample rate of fifo in Hz
+            */
+            void                    setOutputDataRate(uint32_t outputDataRate);
+
+            /*! @brief Exports estimated sample rate.
+            *
+            * @return sample rate in Hz which is measured with drain times.
+            */
+            double                  getEstimatedRate();
+
+            /*! @brief Exports the total number of read frames.
+            *
+            */
+            uint64_t                getFrameCount();
+
+            /*! @brief Exports the number of drains which read frames.
+            *
+            */
+            uint64_t                getDrainCount();
+    };
+    // ######################################### BLACKI2CFIFOREADER DECLARATION ENDS ######################################### //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKI2CFIFOREADER_H_ */
@@ -0,0 +1,181 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackI2CScanner.h"
+#include "../BlackTime/BlackTime.h"
+#include <cerrno>
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackI2CScanner::BlackI2CScanner(i2cProbeMethod method)
+    {
+        this->firstAddress  = 0x03;
+        this->lastAddress   = 0x77;
+        this->probeMethod   = method;
+    }
+
+    bool    BlackI2CScanner::setRange(uint8_t first, uint8_t last)
+    {
+        if( first > last or last >= I2C_ADDRESS_COUNT )
+        {
+            return false;
+        }
+
+        this->firstAddress  = first;
+        this->lastAddress   = last;
+        return true;
+    }
+
+    void    BlackI2CScanner::setProbeMethod(i2cProbeMethod method)
+    {
+        this->probeMethod = method;
+    }
+
+    i2cProbeMethod  BlackI2CScanner::selectMethod(uint8_t address, unsigned long functions)
+    {
+        bool canQuickWrite = ( (functions & I2C_FUNC_SMBUS_QUICK) != 0 );
+
+        if( this->probeMethod == ProbeReadByte or not canQuickWrite )
+        {
+            return ProbeReadByte;
+        }
+
+        if( this->probeMethod == ProbeQuickWrite )
+        {
+            return ProbeQuickWrite;
+        }
+
+        // quick write can change the write protect state of serial memories, so they are read instead
+        bool isMemoryRange = ( (address >= 0x30 and address <= 0x37) or (address >= 0x50 and address <= 0x5F) );
+        return ( isMemoryRange ? ProbeReadByte : ProbeQuickWrite );
+    }
+
+    BlackI2CScanResult  BlackI2CScanner::scan(i2cName bus)
+    {
+        BlackI2CScanResult result;
+        result.busName = bus;
+
+        uint64_t scanStart = BlackTime::getMonotonicTime();
+
+        BlackI2C port(bus, 0);
+        if( port.open(ReadWrite) and (port.getFunctions() & I2C_FUNC_I2C) != 0 )
+        {
+            result.isScanned = true;
+
+            unsigned long functions = port.getFunctions();
+            BlackI2CTransaction transaction;
+            uint8_t readValue;
+
+            for( uint16_t address = this->firstAddress ; address <= this->lastAddress ; address++ )
+            {
+                i2cProbeMethod method   = this->selectMethod(static_cast<uint8_t>(address), functions);
+                uint64_t probeStart     = BlackTime::getMonotonicTime();
+                bool isAcknowledged     = false;
+
+                if( method == ProbeQuickWrite )
+                {
+                    transaction.clear();
+                    transaction.addWrite(NULL, 0, 0, address);
+
+                    errno           = 0;
+                    isAcknowledged  = port.transfer(transaction);
+
+                    // adapters with zero length quirk reject quick writes, so they are probed with reads
+                    if( not isAcknowledged and errno == EOPNOTSUPP )
+                    {
+                        functions  &= ~static_cast<unsigned long>(I2C_FUNC_SMBUS_QUICK);
+                        method      = ProbeReadByte;
+                        probeStart  = BlackTime::getMonotonicTime();
+                    }
+                }
+
+                if( method == ProbeReadByte )
+                {
+                    transaction.clear();
+                    transaction.addRead(&readValue, 1, 0, address);
+                    isAcknowledged  = port.transfer(transaction);
+                }
+
+                result.probeTimes[address]  = BlackTime::getMonotonicTime() - probeStart;
+                result.methods[address]     = static_cast<uint8_t>(method);
+
+                if( isAcknowledged )
+                {
+                    result.presence[address / 8] |= static_cast<uint8_t>(1 << (address % 8));
+                }
+            }
+        }
+
+        port.close();
+
+        result.totalTime = BlackTime::getMonotonicTime() - scanStart;
+        return result;
+    }
+
+    std::vector<BlackI2CScanResult> BlackI2CScanner::scan(const i2cName *buses, size_t busCount)
+    {
+        std::vector<BlackI2CScanResult> results(busCount);
+        std::vector<scanWorker*> workers(busCount);
+
+        for( size_t i = 0 ; i < busCount ; i++ )
+        {
+            results[i].busName  = buses[i];
+            workers[i]          = new scanWorker();
+            workers[i]->scanner = this;
+            workers[i]->result  = &results[i];
+        }
+
+        // every adapter has its own bus lines, so the slowest adapter sets the total time
+        for( size_t i = 0 ; i < busCount ; i++ )
+        {
+            workers[i]->run();
+        }
+
+        for( size_t i = 0 ; i < busCount ; i++ )
+        {
+            workers[i]->waitUntilFinish();
+            delete workers[i];
+        }
+
+        return results;
+    }
+
+    void    BlackI2CScanner::scanWorker::onStartHandler()
+    {
+        *(this->result) = this->scanner->scan(this->result->busName);
+    }
+
+} /* namespace BlackLib */
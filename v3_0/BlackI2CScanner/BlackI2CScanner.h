@@ -0,0 +1,232 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKI2CSCANNER_H_
+#define BLACKI2CSCANNER_H_
+
+#include "../BlackI2C/BlackI2C.h"
+#include "../BlackThread/BlackThread.h"
+
+#include <vector>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting the probe method of BlackI2CScanner.
+    */
+    enum i2cProbeMethod     {   ProbeAuto               = 0,    /*!< read byte for eeprom ranges (0x30-0x37, 0x50-0x5F), quick write for others */
+                                ProbeQuickWrite         = 1,    /*!< zero length write, cheapest, but it can corrupt write protect state of some memories */
+                                ProbeReadByte           = 2     /*!< one byte read, safe for write-only devices but it can confuse some sensors */
+                            };
+
+    const uint8_t           I2C_ADDRESS_COUNT           = 128;      //!< Number of 7 bit i2c addresses
+
+
+
+
+
+    // ####################################### BLACKI2CSCANRESULT DECLARATION STARTS ######################################## //
+
+    /*! @brief Holds the result of scan of one i2c adapter.
+    *
+    *    All time values are at nanosecond (ns) level.
+    */
+    struct BlackI2CScanResult
+    {
+        i2cName     busName;                                /*!< @brief is used to hold the scanned adapter */
+        bool        isScanned;                              /*!< @brief is used to hold whether adapter is opened and it supports i2c transfers */
+        uint8_t     presence[I2C_ADDRESS_COUNT / 8];        /*!< @brief is used to hold the presence bitmap, bit (address % 8) of byte (address / 8) */
+        uint8_t     methods[I2C_ADDRESS_COUNT];             /*!< @brief is used to hold the used i2cProbeMethod of every address, ProbeAuto if it isn't probed */
+        uint64_t    probeTimes[I2C_ADDRESS_COUNT];          /*!< @brief is used to hold the duration of every probe, 0 if it isn't probed */
+        uint64_t    totalTime;                              /*!< @brief is used to hold the duration of whole scan */
+
+        /*! @brief Default constructor of BlackI2CScanResult struct.
+         *
+         *  This function clears all values.
+         */
+        BlackI2CScanResult()
+        {
+            busName     = I2C_0;
+            isScanned   = false;
+            totalTime   = 0;
+
+            memset(presence, 0, sizeof(presence));
+            memset(methods, 0, sizeof(methods));
+            memset(probeTimes, 0, sizeof(probeTimes));
+        }
+
+        /*! @brief Checks whether a device acknowledged at the address.
+         */
+        bool isPresent(uint8_t address) const
+        {
+            return ( address < I2C_ADDRESS_COUNT and (presence[address / 8] & (1 << (address % 8))) != 0 );
+        }
+
+        /*! @brief Counts acknowledged addresses.
+         */
+        size_t getDeviceCount() const
+        {
+            size_t count = 0;
+            for( uint8_t i = 0 ; i < I2C_ADDRESS_COUNT ; i++ )
+            {
+                if( isPresent(i) ) { ++count; }
+            }
+            return count;
+        }
+    };
+    // ######################################## BLACKI2CSCANRESULT DECLARATION ENDS ######################################### //
+
+
+
+
+
+
+
+
+
+
+    // ######################################### BLACKI2CSCANNER DECLARATION STARTS ########################################## //
+
+    /*! @brief Detects the devices of i2c adapters.
+     *
+     *    This class probes an address range of adapters, like i2cdetect tool does. Every probe is one
+     *    I2C_RDWR request with the address in its message, so no I2C_SLAVE request is needed for every
+     *    address. In auto mode, addresses where serial memories usually live are probed with a one byte
+     *    read and other addresses are probed with a zero length write. If adapter doesn't support quick
+     *    write, or it rejects zero length messages with EOPNOTSUPP, read is used for all addresses.
+     *
+     *    When many adapters are scanned, every adapter is scanned at its own thread, so the total time is
+     *    the time of the slowest adapter instead of the sum of them. Presence bitmap and duration of every
+     *    probe are reported.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myI2cScanProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackI2CScanner/BlackI2CScanner.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackI2CScanner   scanner;
+     *      BlackLib::i2cName           buses[2] = { BlackLib::I2C_0, BlackLib::I2C_1 };
+     *
+     *      std::vector<BlackLib::BlackI2CScanResult> results = scanner.scan(buses, 2);
+     *
+     *      for( size_t i = 0 ; i < results.size() ; i++ )
+     *      {
+     *          for( uint8_t address = 0x03 ; address <= 0x77 ; address++ )
+     *          {
+     *              if( results[i].isPresent(address) )
+     *              {
+     *                  std::cout << "i2c-" << results[i].busName << ": 0x" << std::hex << (int)address
+     *                            << " (" << std::dec << results[i].probeTimes[address] << " ns)" << std::endl;
+     *              }
+     *          }
+     *      }
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackI2CScanner
+    {
+        private:
+
+            /*! @brief Scans one adapter at its own thread.
+            */
+            class scanWorker : public BlackThread
+            {
+                public:
+                    BlackI2CScanner    *scanner;            /*!< @brief is used to hold the owner scanner */
+                    BlackI2CScanResult *result;             /*!< @brief is used to hold the result which is filled */
+
+                private:
+                    void                onStartHandler();
+            };
+
+            uint8_t                 firstAddress;           /*!< @brief is used to hold the first probed address */
+            uint8_t                 lastAddress;            /*!< @brief is used to hold the last probed address */
+            i2cProbeMethod          probeMethod;            /*!< @brief is used to hold the probe method */
+
+            /*! @brief Selects the probe method of an address.
+            *
+            */
+            i2cProbeMethod          selectMethod(uint8_t address, unsigned long functions);
+
+        public:
+
+            /*! @brief Constructor of BlackI2CScanner class.
+            *
+            * Default range is 0x03 - 0x77, like i2cdetect tool. Reserved addresses are skipped.
+            *
+            * @param [in] method            probe method (enum)
+            */
+                                    BlackI2CScanner(i2cProbeMethod method = ProbeAuto);
+
+            /*! @brief Changes the probed address range.
+            *
+            * @param [in] first             first probed address
+            * @param [in] last              last probed address, it must be smaller than 0x80
+            * @return true if range is valid, else false.
+            */
+            bool                    setRange(uint8_t first, uint8_t last);
+
+            /*! @brief Changes the probe method.
+            *
+            */
+            void                    setProbeMethod(i2cProbeMethod method);
+
+            /*! @brief Scans one adapter at caller's thread.
+            *
+            * @param [in] bus               adapter name (enum)
+            * @return scan result.
+            */
+            BlackI2CScanResult      scan(i2cName bus);
+
+            /*! @brief Scans many adapters concurrently.
+            *
+            * @param [in] buses             adapter names
+            * @param [in] busCount          adapter count
+            * @return scan results in the order of adapter names.
+            */
+            std::vector<BlackI2CScanResult> scan(const i2cName *buses, size_t busCount);
+    };
+    // ########################################## BLACKI2CSCANNER DECLARATION ENDS ########################################### //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKI2CSCANNER_H_ */
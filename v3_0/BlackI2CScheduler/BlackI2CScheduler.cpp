@@ -0,0 +1,415 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackI2CScheduler.h"
+#include "../BlackTime/BlackTime.h"
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackI2CScheduler::BlackI2CScheduler()
+    {
+        this->isStopRequested   = false;
+        this->statisticsStart   = 0;
+
+        this->readyJobs.reserve(8);
+        this->batch.reserve(8);
+        this->batchResults.reserve(8);
+
+        pthread_condattr_t attributes;
+        pthread_condattr_init( &attributes );
+        pthread_condattr_setclock( &attributes, CLOCK_MONOTONIC );
+
+        pthread_mutex_init( &(this->jobMutex), NULL);
+        pthread_cond_init( &(this->jobCondition), &attributes);
+
+        pthread_condattr_destroy( &attributes );
+    }
+
+    BlackI2CScheduler::~BlackI2CScheduler()
+    {
+        this->requestStop();
+        this->waitUntilFinish();
+
+        for( size_t i = 0 ; i < this->jobs.size() ; i++ )
+        {
+            delete this->jobs[i];
+        }
+
+        pthread_cond_destroy( &(this->jobCondition) );
+        pthread_mutex_destroy( &(this->jobMutex) );
+    }
+
+    int BlackI2CScheduler::addJob(BlackI2CBusDevice &device, uint8_t registerAddr, uint8_t *buffer, uint16_t length,
+                                  uint64_t period, uint64_t deadline, timeType tType,
+                                  i2cJobCallback callback, void *userData)
+    {
+        uint64_t scale;
+
+        switch(tType)
+        {
+            case nanosecond:    { scale = 1;                break; }
+            case microsecond:   { scale = 1000;             break; }
+            case milisecond:    { scale = 1000000;          break; }
+            case second:        { scale = 1000000000ULL;    break; }
+            default:            { scale = 0;                break; }
+        }
+
+        if( scale == 0 or period == 0 or buffer == NULL or length == 0 or length > I2C_MAX_MESSAGE_LENGTH )
+        {
+            return -1;
+        }
+
+        pollingJob *job         = new pollingJob;
+        job->device             = &device;
+        job->registerAddr       = registerAddr;
+        job->buffer             = buffer;
+        job->length             = length;
+        job->period             = period * scale;
+        job->relativeDeadline   = (deadline == 0) ? job->period : deadline * scale;
+        job->release            = BlackTime::getMonotonicTime();
+        job->deadline           = job->release + job->relativeDeadline;
+        job->isEnabled          = true;
+        job->lastResult         = false;
+        job->callback           = callback;
+        job->callbackData       = userData;
+
+        pthread_mutex_lock( &(this->jobMutex) );
+        int jobId = static_cast<int>(this->jobs.size());
+        job->id   = jobId;
+        this->jobs.push_back(job);
+        pthread_cond_broadcast( &(this->jobCondition) );
+        pthread_mutex_unlock( &(this->jobMutex) );
+
+        return jobId;
+    }
+
+    bool BlackI2CScheduler::setJobEnabled(int jobId, bool isEnabled)
+    {
+        pthread_mutex_lock( &(this->jobMutex) );
+
+        if( jobId < 0 or jobId >= static_cast<int>(this->jobs.size()) )
+        {
+            pthread_mutex_unlock( &(this->jobMutex) );
+            return false;
+        }
+
+        pollingJob *job = this->jobs[jobId];
+
+        if( isEnabled and not job->isEnabled )
+        {
+            job->release    = BlackTime::getMonotonicTime();
+            job->deadline   = job->release + job->relativeDeadline;
+        }
+
+        job->isEnabled = isEnabled;
+        pthread_cond_broadcast( &(this->jobCondition) );
+        pthread_mutex_unlock( &(this->jobMutex) );
+
+        return true;
+    }
+
+    size_t BlackI2CScheduler::getJobCount()
+    {
+        pthread_mutex_lock( &(this->jobMutex) );
+        size_t count = this->jobs.size();
+        pthread_mutex_unlock( &(this->jobMutex) );
+
+        return count;
+    }
+
+    BlackI2CJobStatistics BlackI2CScheduler::getJobStatistics(int jobId)
+    {
+        BlackI2CJobStatistics temp;
+
+        pthread_mutex_lock( &(this->jobMutex) );
+        if( jobId >= 0 and jobId < static_cast<int>(this->jobs.size()) )
+        {
+            temp = this->jobs[jobId]->statistics;
+        }
+        pthread_mutex_unlock( &(this->jobMutex) );
+
+        return temp;
+    }
+
+    BlackI2CSchedulerStatistics BlackI2CScheduler::getStatistics()
+    {
+        pthread_mutex_lock( &(this->jobMutex) );
+        BlackI2CSchedulerStatistics temp = this->statistics;
+        if( this->statisticsStart != 0 )
+        {
+            temp.elapsedTime = BlackTime::getMonotonicTime() - this->statisticsStart;
+        }
+        pthread_mutex_unlock( &(this->jobMutex) );
+
+        return temp;
+    }
+
+    void BlackI2CScheduler::resetStatistics()
+    {
+        pthread_mutex_lock( &(this->jobMutex) );
+
+        this->statistics = BlackI2CSchedulerStatistics();
+        if( this->statisticsStart != 0 )
+        {
+            this->statisticsStart = BlackTime::getMonotonicTime();
+        }
+
+        for( size_t i = 0 ; i < this->jobs.size() ; i++ )
+        {
+            this->jobs[i]->statistics = BlackI2CJobStatistics();
+        }
+
+        pthread_mutex_unlock( &(this->jobMutex) );
+    }
+
+    void BlackI2CScheduler::requestStop()
+    {
+        pthread_mutex_lock( &(this->jobMutex) );
+        this->isStopRequested = true;
+        pthread_cond_broadcast( &(this->jobCondition) );
+        pthread_mutex_unlock( &(this->jobMutex) );
+    }
+
+    uint64_t BlackI2CScheduler::collectBatch(uint64_t now)
+    {
+        uint64_t nextRelease = UINT64_MAX;
+
+        this->readyJobs.clear();
+        this->batch.clear();
+
+        for( size_t i = 0 ; i < this->jobs.size() ; i++ )
+        {
+            pollingJob *job = this->jobs[i];
+
+            if( not job->isEnabled )
+            {
+                continue;
+            }
+
+            if( job->release <= now )
+            {
+                // insertion keeps ready jobs sorted by absolute deadline
+                std::vector<pollingJob*>::iterator position = this->readyJobs.begin();
+                while( position != this->readyJobs.end() and (*position)->deadline <= job->deadline )
+                {
+                    ++position;
+                }
+                this->readyJobs.insert(position, job);
+            }
+            else if( job->release < nextRelease )
+            {
+                nextRelease = job->release;
+            }
+        }
+
+        if( this->readyJobs.empty() )
+        {
+            return nextRelease;
+        }
+
+        const BlackI2CBus *bus  = this->readyJobs[0]->device->getBus();
+        const size_t maxBatch   = I2C_MAX_MESSAGE_COUNT / 2;
+
+        this->transaction.clear();
+
+        for( size_t i = 0 ; i < this->readyJobs.size() and this->batch.size() < maxBatch ; i++ )
+        {
+            pollingJob *job = this->readyJobs[i];
+
+            if( job->device->getBus() != bus )
+            {
+                continue;
+            }
+
+            this->transaction.addWrite(&(job->registerAddr), 1, 0, job->device->getAddress());
+            this->transaction.addRead(job->buffer, job->length, 0, job->device->getAddress());
+            this->batch.push_back(job);
+        }
+
+        return 0;
+    }
+
+    void BlackI2CScheduler::executeBatch()
+    {
+        BlackI2CBus *bus = this->batch[0]->device->getBus();
+
+        pthread_mutex_unlock( &(this->jobMutex) );
+
+        BlackI2C *port          = bus->lock();
+        uint64_t begin          = BlackTime::getMonotonicTime();
+        uint64_t requestCount   = 0;
+        bool isRetried          = false;
+
+        this->batchResults.assign(this->batch.size(), false);
+
+        if( port != NULL )
+        {
+            ++requestCount;
+
+            if( port->transfer(this->transaction) )
+            {
+                this->batchResults.assign(this->batch.size(), true);
+            }
+            else if( this->batch.size() > 1 )
+            {
+                // request stops at the first nack, so one absent device must not fail the other jobs
+                isRetried = true;
+
+                for( size_t i = 0 ; i < this->batch.size() ; i++ )
+                {
+                    pollingJob *job = this->batch[i];
+
+                    this->retryTransaction.clear();
+                    this->retryTransaction.addWrite(&(job->registerAddr), 1, 0, job->device->getAddress());
+                    this->retryTransaction.addRead(job->buffer, job->length, 0, job->device->getAddress());
+
+                    this->batchResults[i] = port->transfer(this->retryTransaction);
+                    ++requestCount;
+                }
+            }
+
+            bus->unlock();
+        }
+
+        uint64_t end    = BlackTime::getMonotonicTime();
+
+        pthread_mutex_lock( &(this->jobMutex) );
+
+        this->statistics.batchCount += requestCount;
+        this->statistics.busyTime   += end - begin;
+        if( isRetried ) { ++(this->statistics.retriedBatchCount); }
+
+        for( size_t i = 0 ; i < this->batch.size() ; i++ )
+        {
+            pollingJob *job             = this->batch[i];
+            BlackI2CJobStatistics &stat = job->statistics;
+            uint64_t latency            = end - job->release;
+            bool isRead                 = this->batchResults[i];
+
+            job->lastResult             = isRead;
+            stat.lastLatency            = latency;
+            stat.totalLatency          += latency;
+            stat.lastCompletionTime     = end;
+            ++(stat.runCount);
+            ++(this->statistics.runCount);
+
+            if( latency > stat.maxLatency ) { stat.maxLatency = latency; }
+            if( not isRead )                { ++(stat.errorCount); }
+
+            if( end > job->deadline )
+            {
+                ++(stat.missedDeadlineCount);
+                ++(this->statistics.missedDeadlineCount);
+            }
+
+            job->release += job->period;
+
+            if( job->release <= end )
+            {
+                uint64_t skipped    = (end - job->release) / job->period + 1;
+                job->release       += skipped * job->period;
+                stat.skippedCount  += skipped;
+            }
+
+            job->deadline = job->release + job->relativeDeadline;
+        }
+
+        pthread_mutex_unlock( &(this->jobMutex) );
+
+        for( size_t i = 0 ; i < this->batch.size() ; i++ )
+        {
+            const pollingJob *job = this->batch[i];
+
+            if( job->callback != NULL )
+            {
+                job->callback(job->id, job->lastResult, job->callbackData);
+            }
+        }
+
+        pthread_mutex_lock( &(this->jobMutex) );
+    }
+
+    void BlackI2CScheduler::onStartHandler()
+    {
+        pthread_mutex_lock( &(this->jobMutex) );
+
+        uint64_t start = BlackTime::getMonotonicTime();
+        this->statisticsStart = start;
+
+        for( size_t i = 0 ; i < this->jobs.size() ; i++ )
+        {
+            if( this->jobs[i]->release < start )
+            {
+                this->jobs[i]->release  = start;
+                this->jobs[i]->deadline = start + this->jobs[i]->relativeDeadline;
+            }
+        }
+
+        while( not this->isStopRequested )
+        {
+            uint64_t nextRelease = this->collectBatch( BlackTime::getMonotonicTime() );
+
+            if( nextRelease == 0 )
+            {
+                this->executeBatch();
+            }
+            else if( nextRelease == UINT64_MAX )
+            {
+                pthread_cond_wait( &(this->jobCondition), &(this->jobMutex) );
+            }
+            else
+            {
+                timespec wakeUp;
+                wakeUp.tv_sec   = static_cast<time_t>(nextRelease / 1000000000ULL);
+                wakeUp.tv_nsec  = static_cast<long>(nextRelease % 1000000000ULL);
+
+                pthread_cond_timedwait( &(this->jobCondition), &(this->jobMutex), &wakeUp);
+            }
+        }
+
+        this->isStopRequested = false;
+        this->statistics.elapsedTime = BlackTime::getMonotonicTime() - this->statisticsStart;
+        this->statisticsStart = 0;
+
+        pthread_mutex_unlock( &(this->jobMutex) );
+    }
+
+
+
+} /* namespace BlackLib */
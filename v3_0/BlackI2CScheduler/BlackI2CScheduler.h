@@ -0,0 +1,343 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKI2CSCHEDULER_H_
+#define BLACKI2CSCHEDULER_H_
+
+#include "../BlackI2CBus/BlackI2CBus.h"
+#include "../BlackThread/BlackThread.h"
+
+#include <vector>
+#include <pthread.h>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This type is used for completion callbacks of polling jobs. It is called at scheduler thread after every run.
+    */
+    typedef void (*i2cJobCallback)(int jobId, bool isSuccessful, void *userData);
+
+
+
+
+
+    // ###################################### BLACKI2CJOBSTATISTICS DECLARATION STARTS ###################################### //
+
+    /*! @brief Holds counters of a polling job of BlackI2CScheduler class.
+    *
+    *    Latency is measured from the release time of job to the end of its bus transfer. All time
+    *    values are at nanosecond (ns) level.
+    */
+    struct BlackI2CJobStatistics
+    {
+        uint64_t    runCount;               /*!< @brief is used to hold the number of executed runs */
+        uint64_t    errorCount;             /*!< @brief is used to hold the number of failed runs */
+        uint64_t    missedDeadlineCount;    /*!< @brief is used to hold the number of runs which finished after their deadline */
+        uint64_t    skippedCount;           /*!< @brief is used to hold the number of releases which are skipped because of overruns */
+        uint64_t    lastLatency;            /*!< @brief is used to hold the latency of the last run */
+        uint64_t    maxLatency;             /*!< @brief is used to hold the maximum latency */
+        uint64_t    totalLatency;           /*!< @brief is used to hold the sum of latencies */
+        uint64_t    lastCompletionTime;     /*!< @brief is used to hold the monotonic time of the last run's end */
+
+        /*! @brief Default constructor of BlackI2CJobStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackI2CJobStatistics()
+        {
+            runCount            = 0;
+            errorCount          = 0;
+            missedDeadlineCount = 0;
+            skippedCount        = 0;
+            lastLatency         = 0;
+            maxLatency          = 0;
+            totalLatency        = 0;
+            lastCompletionTime  = 0;
+        }
+
+        /*! @brief Calculates average latency.
+         *
+         *  @return average latency at nanosecond level.
+         */
+        uint64_t getAverageLatency() const
+        {
+            return ( (runCount == 0) ? 0 : (totalLatency / runCount) );
+        }
+    };
+    // ####################################### BLACKI2CJOBSTATISTICS DECLARATION ENDS ####################################### //
+
+
+
+
+
+    // ################################### BLACKI2CSCHEDULERSTATISTICS DECLARATION STARTS #################################### //
+
+    /*! @brief Holds counters of BlackI2CScheduler class.
+    *
+    *    All time values are at nanosecond (ns) level.
+    */
+    struct BlackI2CSchedulerStatistics
+    {
+        uint64_t    batchCount;             /*!< @brief is used to hold the number of I2C_RDWR requests */
+        uint64_t    retriedBatchCount;      /*!< @brief is used to hold the number of failed batches whose jobs are retried one by one */
+        uint64_t    runCount;               /*!< @brief is used to hold the number of executed job runs */
+        uint64_t    missedDeadlineCount;    /*!< @brief is used to hold the number of runs which finished after their deadline */
+        uint64_t    busyTime;               /*!< @brief is used to hold the total time which is spent on bus transfers */
+        uint64_t    elapsedTime;            /*!< @brief is used to hold the time since the scheduler is started or counters are cleared */
+
+        /*! @brief Default constructor of BlackI2CSchedulerStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackI2CSchedulerStatistics()
+        {
+            batchCount          = 0;
+            retriedBatchCount   = 0;
+            runCount            = 0;
+            missedDeadlineCount = 0;
+            busyTime            = 0;
+            elapsedTime         = 0;
+        }
+
+        /*! @brief Calculates bus busy percentage.
+         *
+         *  @return percentage of elapsed time which is spent on bus transfers.
+         */
+        double getBusyPercentage() const
+        {
+            return ( (elapsedTime == 0) ? 0.0 : (100.0 * busyTime / elapsedTime) );
+        }
+    };
+    // #################################### BLACKI2CSCHEDULERSTATISTICS DECLARATION ENDS ##################################### //
+
+
+
+
+
+
+
+
+
+
+    // ######################################## BLACKI2CSCHEDULER DECLARATION STARTS ######################################### //
+
+    /*! @brief Polls i2c registers periodically from one thread.
+     *
+     *    This class runs periodic register block reads of many i2c devices. Every job has a period and a
+     *    relative deadline. Jobs are released at their periods and ready jobs are run in earliest deadline
+     *    first order. The ready jobs which are on the same bus as the most urgent job are batched: their
+     *    register address writes and data reads are sent together with one I2C_RDWR request, so they share
+     *    one system call and one bus lock. At most I2C_MAX_MESSAGE_COUNT / 2 jobs are batched. An I2C_RDWR
+     *    request stops at the first not acknowledged message, so if a batch fails, its jobs are retried with
+     *    one request per job and only the jobs whose own request fails are reported as failed.
+     *
+     *    If a job can't be run before its next release, missed releases are skipped, so a slow bus doesn't
+     *    cause a burst of stale reads. Bus busy percentage, missed deadlines and per-job latencies are
+     *    counted.
+     *
+     *    Read data is written to the buffer of job. The buffer is updated at scheduler thread, so users
+     *    should copy it at job callback or synchronize accesses by themselves.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myI2cSchedulerProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackI2CScheduler/BlackI2CScheduler.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackI2CBus       bus(BlackLib::I2C_1);
+     *      BlackLib::BlackI2CBusDevice imu(bus, 0x68);
+     *      BlackLib::BlackI2CBusDevice baro(bus, 0x77);
+     *
+     *      uint8_t imuData[14], baroData[6];
+     *
+     *      BlackLib::BlackI2CScheduler scheduler;
+     *      int imuJob  = scheduler.addJob(imu,  0x3B, imuData,  sizeof(imuData),  2500);     // 400 Hz
+     *      int baroJob = scheduler.addJob(baro, 0xF7, baroData, sizeof(baroData), 40000);    // 25 Hz
+     *
+     *      scheduler.run();
+     *      BlackLib::BlackThread::sleep(5);
+     *      scheduler.requestStop();
+     *      scheduler.waitUntilFinish();
+     *
+     *      std::cout << "Bus busy: " << scheduler.getStatistics().getBusyPercentage() << "%" << std::endl;
+     *      std::cout << "IMU average latency: " << scheduler.getJobStatistics(imuJob).getAverageLatency() << " ns" << std::endl;
+     *      std::cout << "Baro missed deadlines: " << scheduler.getJobStatistics(baroJob).missedDeadlineCount << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackI2CScheduler : public BlackThread
+    {
+        private:
+
+            /*! @brief Holds one periodic read job.
+            */
+            struct pollingJob
+            {
+                int                     id;                 /*!< @brief is used to hold the id of job */
+                BlackI2CBusDevice      *device;             /*!< @brief is used to hold the target device */
+                uint8_t                 registerAddr;       /*!< @brief is used to hold the first register address */
+                uint8_t                *buffer;             /*!< @brief is used to hold the read buffer */
+                uint16_t                length;             /*!< @brief is used to hold the read length */
+                uint64_t                period;             /*!< @brief is used to hold the period at nanosecond level */
+                uint64_t                relativeDeadline;   /*!< @brief is used to hold the deadline after release at nanosecond level */
+                uint64_t                release;            /*!< @brief is used to hold the monotonic time of next release */
+                uint64_t                deadline;           /*!< @brief is used to hold the monotonic time of next deadline */
+                bool                    isEnabled;          /*!< @brief is used to hold the enable state */
+                bool                    lastResult;         /*!< @brief is used to hold the result of the last run */
+                i2cJobCallback          callback;           /*!< @brief is used to hold the completion callback, can be NULL */
+                void                   *callbackData;       /*!< @brief is used to hold the user data of callback */
+                BlackI2CJobStatistics   statistics;         /*!< @brief is used to hold the counters of job */
+            };
+
+            std::vector<pollingJob*>        jobs;               /*!< @brief is used to hold the registered jobs */
+            std::vector<pollingJob*>        readyJobs;          /*!< @brief is used to hold the released jobs in deadline order */
+            std::vector<pollingJob*>        batch;              /*!< @brief is used to hold the jobs which are sent with one request */
+            std::vector<bool>               batchResults;       /*!< @brief is used to hold the result of every job of current batch */
+            BlackI2CTransaction             transaction;        /*!< @brief is used to hold the messages of current batch */
+            BlackI2CTransaction             retryTransaction;   /*!< @brief is used to hold the messages of one job while a failed batch is retried */
+            BlackI2CSchedulerStatistics     statistics;         /*!< @brief is used to hold the counters of scheduler */
+            uint64_t                        statisticsStart;    /*!< @brief is used to hold the monotonic time which elapsed time is measured from */
+            pthread_mutex_t                 jobMutex;           /*!< @brief is used to protect the jobs and the counters */
+            pthread_cond_t                  jobCondition;       /*!< @brief is used to wake up the scheduler thread */
+            bool                            isStopRequested;    /*!< @brief is used to hold the stop request of scheduler */
+
+            /*! @brief Finds released jobs and selects the batch which will be run.
+            *
+            * This function must be called while the job mutex is locked.
+            *
+            * @param [in] now               current monotonic time
+            * @return monotonic time of the next release if there isn't any released job, else 0.
+            */
+            uint64_t                        collectBatch(uint64_t now);
+
+            /*! @brief Sends current batch, updates counters and calls the callbacks of jobs.
+            *
+            * This function must be called while the job mutex is locked. The mutex is released during
+            * the bus transfer and the callbacks.
+            */
+            void                            executeBatch();
+
+            /*! @brief Thread's start handler function.
+            *
+            *  This function waits for job releases and runs them until stop is requested. Users should
+            *  not call this function directly.
+            */
+            void                            onStartHandler();
+
+
+
+        public:
+
+            /*! @brief Constructor of BlackI2CScheduler class.
+            *
+            * Scheduler thread is started with run() function.
+            */
+                                            BlackI2CScheduler();
+
+            /*! @brief Destructor of BlackI2CScheduler class.
+            *
+            * This function stops the scheduler thread and waits it.
+            */
+            virtual                         ~BlackI2CScheduler();
+
+            /*! @brief Registers a periodic register block read.
+            *
+            * Job is released first when the scheduler starts, or immediately if the scheduler is running.
+            *
+            * @param [in] device            target device
+            * @param [in] registerAddr      first register address
+            * @param [out] buffer           read buffer, it must be valid while the job is registered
+            * @param [in] length            read length, it must be less than or equal to I2C_MAX_MESSAGE_LENGTH
+            * @param [in] period            period of job
+            * @param [in] deadline          deadline after release, 0 means the period
+            * @param [in] tType             time type of period and deadline (enum)
+            * @param [in] callback          completion callback, can be NULL
+            * @param [in] userData          user data of callback
+            * @return id of job, or -1 if parameters are invalid.
+            */
+            int                             addJob(BlackI2CBusDevice &device, uint8_t registerAddr, uint8_t *buffer, uint16_t length,
+                                                   uint64_t period, uint64_t deadline = 0, timeType tType = microsecond,
+                                                   i2cJobCallback callback = NULL, void *userData = NULL);
+
+            /*! @brief Enables or disables a job.
+            *
+            * Enabled job is released immediately.
+            *
+            * @param [in] jobId             id of job
+            * @param [in] isEnabled         new enable state
+            * @return true if job id is valid, else false.
+            */
+            bool                            setJobEnabled(int jobId, bool isEnabled);
+
+            /*! @brief Exports the number of registered jobs.
+            *
+            */
+            size_t                          getJobCount();
+
+            /*! @brief Exports the counters of a job.
+            *
+            * @param [in] jobId             id of job
+            * @return copy of BlackI2CJobStatistics struct, or cleared struct if job id is invalid.
+            */
+            BlackI2CJobStatistics           getJobStatistics(int jobId);
+
+            /*! @brief Exports the counters of scheduler.
+            *
+            * @return copy of BlackI2CSchedulerStatistics struct.
+            */
+            BlackI2CSchedulerStatistics     getStatistics();
+
+            /*! @brief Clears the counters of scheduler and all jobs.
+            *
+            */
+            void                            resetStatistics();
+
+            /*! @brief Requests the scheduler thread to finish.
+            *
+            * This function doesn't wait the thread. Users can use waitUntilFinish() function to wait it.
+            */
+            void                            requestStop();
+    };
+    // ######################################### BLACKI2CSCHEDULER DECLARATION ENDS ########################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKI2CSCHEDULER_H_ */
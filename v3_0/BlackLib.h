@@ -33,11 +33,28 @@
 
 #include "BlackCore.h"
 #include "BlackADC/BlackADC.h"
+#include "BlackBufferPool/BlackBufferPool.h"
+#include "BlackCapture/BlackCapture.h"
+#include "BlackEQEP/BlackEQEP.h"
 #include "BlackPWM/BlackPWM.h"
+#include "BlackRegisterCache/BlackRegisterCache.h"
+#include "BlackRegisterMap/BlackRegisterMap.h"
+#include "BlackPWMChip/BlackPWMChip.h"
+#include "BlackPWMSequencer/BlackPWMSequencer.h"
 #include "BlackGPIO/BlackGPIO.h"
 #include "BlackUART/BlackUART.h"
 #include "BlackSPI/BlackSPI.h"
+#include "BlackSPIADC/BlackSPIADC.h"
+#include "BlackSPIAsync/BlackSPIAsync.h"
+#include "BlackSPIBus/BlackSPIBus.h"
+#include "BlackSPIDisplay/BlackSPIDisplay.h"
 #include "BlackI2C/BlackI2C.h"
+#include "BlackI2CAsync/BlackI2CAsync.h"
+#include "BlackI2CBus/BlackI2CBus.h"
+#include "BlackI2CEEPROM/BlackI2CEEPROM.h"
+#include "BlackI2CFIFOReader/BlackI2CFIFOReader.h"
+#include "BlackI2CScanner/BlackI2CScanner.h"
+#include "BlackI2CScheduler/BlackI2CScheduler.h"
 #include "BlackThread/BlackThread.h"
 #include "BlackMutex/BlackMutex.h"
 #include "BlackDirectory/BlackDirectory.h"
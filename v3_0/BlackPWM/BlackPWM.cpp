@@ -202,6 +202,7 @@ namespace BlackLib
         this->dutyPath      = this->getDutyFilePath();
         this->runPath       = this->getRunFilePath();
         this->polarityPath  = this->getPolarityFilePath();
+        this->pwmWriteMode  = DirectWrite;
     }
 
     BlackPWM::~BlackPWM()
@@ -357,6 +358,107 @@ namespace BlackLib
     }
 
 
+    bool        BlackPWM::writeToFile(shadowIndex reg, int64_t value)
+    {
+        std::string filePath;
+        bool        *fileError;
+
+        switch( reg )
+        {
+            case periodReg:     { filePath = this->periodPath;      fileError = &(this->pwmErrors->periodFileError);    break; }
+            case dutyReg:       { filePath = this->dutyPath;        fileError = &(this->pwmErrors->dutyFileError);      break; }
+            case polarityReg:   { filePath = this->polarityPath;    fileError = &(this->pwmErrors->polarityFileError);  break; }
+            default:            { filePath = this->runPath;         fileError = &(this->pwmErrors->runFileError);       break; }
+        }
+
+        this->shadowStatistics.writeCount++;
+
+        std::ofstream file;
+        file.open(filePath.c_str(),std::ios::out);
+        if(file.fail())
+        {
+            file.close();
+            *fileError = true;
+            this->shadowRegisters[reg].invalidate();
+            return false;
+        }
+        else
+        {
+            file << value;
+            file.close();
+
+            if( file.fail() )
+            {
+                *fileError = true;
+                this->shadowRegisters[reg].invalidate();
+                return false;
+            }
+
+            *fileError = false;
+            this->shadowRegisters[reg].setWritten(value);
+            return true;
+        }
+    }
+
+    bool        BlackPWM::requestWrite(shadowIndex reg, int64_t value)
+    {
+        this->shadowStatistics.requestCount++;
+
+        if( this->pwmWriteMode == DeferredWrite )
+        {
+            this->shadowRegisters[reg].setPending(value, this->shadowStatistics);
+            return true;
+        }
+
+        if( this->pwmWriteMode == ShadowWrite and this->shadowRegisters[reg].isUnchanged(value) )
+        {
+            this->shadowStatistics.unchangedCount++;
+            return true;
+        }
+
+        return this->writeToFile(reg, value);
+    }
+
+    bool        BlackPWM::commitRegister(shadowIndex reg)
+    {
+        if( not this->shadowRegisters[reg].hasPending() )
+        {
+            return true;
+        }
+
+        int64_t value = this->shadowRegisters[reg].getPending();
+        this->shadowRegisters[reg].clearPending();
+
+        if( this->shadowRegisters[reg].isUnchanged(value) )
+        {
+            this->shadowStatistics.unchangedCount++;
+            return true;
+        }
+
+        return this->writeToFile(reg, value);
+    }
+
+    int64_t     BlackPWM::getLatestPeriodValue()
+    {
+        if( this->shadowRegisters[periodReg].hasPending() )
+        {
+            return this->shadowRegisters[periodReg].getPending();
+        }
+
+        if( this->pwmWriteMode != DirectWrite and this->shadowRegisters[periodReg].isKnown() )
+        {
+            return this->shadowRegisters[periodReg].getLast();
+        }
+
+        int64_t period = this->getNumericPeriodValue();
+        if( period != FILE_COULD_NOT_OPEN_INT )
+        {
+            this->shadowRegisters[periodReg].setWritten(period);
+        }
+        return period;
+    }
+
+
     bool        BlackPWM::setDutyPercent(float percantage)
     {
         if( percantage > 100.0 or percantage < 0.0 )
@@ -369,22 +471,14 @@ namespace BlackLib
 
         this->pwmErrors->outOfRange = false;
 
-        std::ofstream dutyFile;
-        dutyFile.open(this->dutyPath.c_str(),std::ios::out);
-        if(dutyFile.fail())
+        int64_t period = this->getLatestPeriodValue();
+        if( period == FILE_COULD_NOT_OPEN_INT )
         {
-            dutyFile.close();
             this->pwmErrors->dutyFileError = true;
             return false;
         }
-        else
-        {
-            dutyFile << static_cast<int64_t>(std::round((this->getNumericPeriodValue()) * (1.0 - (percantage/100))));
-            dutyFile.close();
-            this->pwmErrors->dutyFileError = false;
-            return true;
-        }
 
+        return this->requestWrite(dutyReg, static_cast<int64_t>(std::round(period * (1.0 - (percantage/100)))));
     }
 
     bool        BlackPWM::setPeriodTime(uint64_t period, timeType tType)
@@ -399,21 +493,7 @@ namespace BlackLib
         else
         {
             this->pwmErrors->outOfRange = false;
-            std::ofstream periodFile;
-            periodFile.open(this->periodPath.c_str(),std::ios::out);
-            if(periodFile.fail())
-            {
-                periodFile.close();
-                this->pwmErrors->periodFileError = true;
-                return false;
-            }
-            else
-            {
-                periodFile << writeThis;
-                periodFile.close();
-                this->pwmErrors->periodFileError = false;
-                return true;
-            }
+            return this->requestWrite(periodReg, static_cast<int64_t>(writeThis));
         }
 
     }
@@ -429,27 +509,13 @@ namespace BlackLib
         }
         else
         {
-            std::ofstream dutyFile;
-            dutyFile.open(this->dutyPath.c_str(),std::ios::out);
-            if(dutyFile.fail())
-            {
-                dutyFile.close();
-                this->pwmErrors->dutyFileError = true;
-                return false;
-            }
-            else
-            {
-                dutyFile << writeThis;
-                dutyFile.close();
-                this->pwmErrors->dutyFileError = false;
-                return true;
-            }
+            return this->requestWrite(dutyReg, static_cast<int64_t>(writeThis));
         }
     }
 
     bool        BlackPWM::setLoadRatioTime(uint64_t load, timeType tType)
     {
-        uint64_t writeThis = (this->getNumericPeriodValue() - static_cast<int64_t>(load * static_cast<double>(pow( 10, static_cast<int>(tType)+9) )));
+        uint64_t writeThis = (this->getLatestPeriodValue() - static_cast<int64_t>(load * static_cast<double>(pow( 10, static_cast<int>(tType)+9) )));
 
         if( writeThis > 1000000000)
         {
@@ -458,60 +524,18 @@ namespace BlackLib
         }
         else
         {
-            std::ofstream dutyFile;
-            dutyFile.open(this->dutyPath.c_str(),std::ios::out);
-            if(dutyFile.fail())
-            {
-                dutyFile.close();
-                this->pwmErrors->dutyFileError = true;
-                return false;
-            }
-            else
-            {
-                dutyFile << writeThis;
-                dutyFile.close();
-                this->pwmErrors->dutyFileError = false;
-                return true;
-            }
+            return this->requestWrite(dutyReg, static_cast<int64_t>(writeThis));
         }
     }
 
     bool        BlackPWM::setPolarity(polarityType polarity)
     {
-        std::ofstream polarityFile;
-        polarityFile.open(this->polarityPath.c_str(),std::ios::out);
-        if(polarityFile.fail())
-        {
-            polarityFile.close();
-            this->pwmErrors->polarityFileError = true;
-            return false;
-        }
-        else
-        {
-            polarityFile << static_cast<int>(polarity);
-            polarityFile.close();
-            this->pwmErrors->polarityFileError = false;
-            return true;
-        }
+        return this->requestWrite(polarityReg, static_cast<int64_t>(polarity));
     }
 
     bool        BlackPWM::setRunState(runValue state)
     {
-        std::ofstream runFile;
-        runFile.open(this->runPath.c_str(),std::ios::out);
-        if(runFile.fail())
-        {
-            runFile.close();
-            this->pwmErrors->runFileError = true;
-            return false;
-        }
-        else
-        {
-            runFile << static_cast<int>(state);
-            runFile.close();
-            this->pwmErrors->runFileError = false;
-            return true;
-        }
+        return this->requestWrite(runReg, static_cast<int64_t>(state));
     }
 
 
@@ -535,7 +559,11 @@ namespace BlackLib
 
     void        BlackPWM::toggleRunState()
     {
-        if( this->getRunValue() == "1" )
+        if( this->shadowRegisters[runReg].hasPending() )
+        {
+            this->setRunState( (this->shadowRegisters[runReg].getPending() == 1) ? stop : run );
+        }
+        else if( this->getRunValue() == "1" )
         {
             this->setRunState(stop);
         }
@@ -547,7 +575,11 @@ namespace BlackLib
 
     void        BlackPWM::tooglePolarity()
     {
-        if( this->getPolarityValue() == "0" )
+        if( this->shadowRegisters[polarityReg].hasPending() )
+        {
+            this->setPolarity( (this->shadowRegisters[polarityReg].getPending() == 0) ? reverse : straight );
+        }
+        else if( this->getPolarityValue() == "0" )
         {
             this->setPolarity(reverse);
         }
@@ -557,6 +589,67 @@ namespace BlackLib
         }
     }
 
+    void        BlackPWM::setWriteMode(writeMode mode)
+    {
+        if( this->pwmWriteMode == DeferredWrite and mode != DeferredWrite )
+        {
+            this->commit();
+        }
+
+        this->pwmWriteMode = mode;
+    }
+
+    writeMode   BlackPWM::getWriteMode()
+    {
+        return this->pwmWriteMode;
+    }
+
+    bool        BlackPWM::commit()
+    {
+        bool isPeriodDecreased = ( this->shadowRegisters[periodReg].hasPending() and
+                                   this->shadowRegisters[periodReg].isKnown() and
+                                   this->shadowRegisters[periodReg].getPending() < this->shadowRegisters[periodReg].getLast() );
+
+        bool isCommitted = true;
+
+        // duty value can't be greater than period value, so write order depends on period change
+        if( isPeriodDecreased )
+        {
+            isCommitted = this->commitRegister(dutyReg)   and isCommitted;
+            isCommitted = this->commitRegister(periodReg) and isCommitted;
+        }
+        else
+        {
+            isCommitted = this->commitRegister(periodReg) and isCommitted;
+            isCommitted = this->commitRegister(dutyReg)   and isCommitted;
+        }
+
+        isCommitted = this->commitRegister(polarityReg) and isCommitted;
+        isCommitted = this->commitRegister(runReg)      and isCommitted;
+
+        return isCommitted;
+    }
+
+    BlackShadowStatistics BlackPWM::getShadowStatistics()
+    {
+        return this->shadowStatistics;
+    }
+
+    void        BlackPWM::resetShadowStatistics()
+    {
+        this->shadowStatistics = BlackShadowStatistics();
+    }
+
+    void        BlackPWM::invalidateShadow()
+    {
+        for( int i = 0 ; i < 4 ; i++ )
+        {
+            this->shadowRegisters[i].invalidate();
+        }
+    }
+
+
+
     bool        BlackPWM::fail()
     {
         return (this->pwmErrors->outOfRange or
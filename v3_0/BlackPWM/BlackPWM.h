@@ -305,6 +305,49 @@ namespace BlackLib
             std::string     dutyPath;                   /*!< @brief is used to hold the @a duty file path */
             std::string     runPath;                    /*!< @brief is used to hold the @a run file path */
             std::string     polarityPath;               /*!< @brief is used to hold the @a polarity file path */
+            writeMode       pwmWriteMode;               /*!< @brief is used to hold the selected write mode */
+            BlackShadowRegister<int64_t> shadowRegisters[4];    /*!< @brief is used to hold the last written and pending values of period, duty, polarity and run files */
+            BlackShadowStatistics shadowStatistics;     /*!< @brief is used to hold the write counters of shadow registers */
+
+            /*!
+            * This enum is used to select shadow register of pwm files.
+            */
+            enum shadowIndex {  periodReg       = 0,
+                                dutyReg         = 1,
+                                polarityReg     = 2,
+                                runReg          = 3
+                            };
+
+            /*! @brief Writes value to selected pwm file.
+            *
+            * This function writes value to file which is selected with register index, updates error flag of
+            * this file and saves written value to shadow register.
+            * @return True if writing is successful, else false.
+            */
+            bool            writeToFile(shadowIndex reg, int64_t value);
+
+            /*! @brief Handles setter call by selected write mode.
+            *
+            * At DirectWrite mode value is written to file. At ShadowWrite mode value is written to file
+            * only if it differs from the last written value. At DeferredWrite mode value is saved as
+            * pending value until commit() function call.
+            * @return True if value is written, skipped or saved as pending successfully, else false.
+            */
+            bool            requestWrite(shadowIndex reg, int64_t value);
+
+            /*! @brief Writes pending value of selected shadow register, if it differs from the last written value.
+            *
+            * @return True if there is no need to write or writing is successful, else false.
+            */
+            bool            commitRegister(shadowIndex reg);
+
+            /*! @brief Finds period value for duty calculations.
+            *
+            * This function returns pending period value if it exists. At ShadowWrite and DeferredWrite
+            * modes it returns the last written period value, if it is known. Otherwise it reads period file.
+            * @return period value at nanosecond level or BlackLib::FILE_COULD_NOT_OPEN_INT.
+            */
+            int64_t         getLatestPeriodValue();
 
 
         public:
@@ -895,6 +938,83 @@ namespace BlackLib
             */
             bool            isPolarityReverse();
 
+            /*! @brief Changes write mode of pwm files.
+            *
+            * If write mode is changed from DeferredWrite to another mode, pending values are committed
+            * before changing.
+            * @param [in] mode new write mode(enum)
+            *
+            * @par Example
+            * @code{.cpp}
+            *   BlackLib::BlackPWM myPwm(BlackLib::P8_19);
+            *
+            *   myPwm.setWriteMode(BlackLib::ShadowWrite);
+            *   myPwm.setDutyPercent(40.0);
+            *   myPwm.setDutyPercent(40.0);             // not written, value is same
+            *
+            *   std::cout << "Avoided writes: " << myPwm.getShadowStatistics().getAvoidedCount() << std::endl;
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Avoided writes: 1
+            * @endcode
+            *
+            * @sa writeMode
+            */
+            void            setWriteMode(writeMode mode);
+
+            /*! @brief Exports write mode of pwm files.
+            *
+            * @return BlackLib::writeMode variable.
+            */
+            writeMode       getWriteMode();
+
+            /*! @brief Writes pending values to pwm files.
+            *
+            * This function is the commit point of DeferredWrite mode. Only the last value of every file
+            * since previous commit is written and values which are equal to last written values are skipped.
+            * If period is decreased, duty is written before period, else period is written before duty. Then
+            * polarity and run values are written. Getter functions read files, so they don't see pending
+            * values until this function is called.
+            * @return True if all pending values are written successfully, else false.
+            *
+            * @par Example
+            * @code{.cpp}
+            *   BlackLib::BlackPWM myPwm(BlackLib::P8_19);
+            *
+            *   myPwm.setWriteMode(BlackLib::DeferredWrite);
+            *   myPwm.setPeriodTime(1, BlackLib::milisecond);
+            *   myPwm.setDutyPercent(10.0);
+            *   myPwm.setDutyPercent(30.0);             // overwrites previous duty before commit
+            *   myPwm.commit();                         // writes period and duty files only once
+            *
+            *   std::cout << "Written: " << myPwm.getShadowStatistics().writeCount
+            *             << " Avoided: " << myPwm.getShadowStatistics().getAvoidedCount() << std::endl;
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Written: 2 Avoided: 1
+            * @endcode
+            */
+            bool            commit();
+
+            /*! @brief Exports write counters of shadow registers.
+            *
+            * @return BlackShadowStatistics struct.
+            */
+            BlackShadowStatistics getShadowStatistics();
+
+            /*! @brief Clears write counters of shadow registers.
+            */
+            void            resetShadowStatistics();
+
+            /*! @brief Forgets the last written values.
+            *
+            * If pwm files can be changed by another process, this function can be used for forcing the next
+            * setter calls to write files.
+            */
+            void            invalidateShadow();
+
             /*! @brief Is used for general debugging.
             *
             * @return True if any error occured, else false.
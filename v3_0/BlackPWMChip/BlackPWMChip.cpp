@@ -0,0 +1,562 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackPWMChip.h"
+
+
+namespace BlackLib
+{
+
+    // ########################################### BLACKPWMCHIP DEFINITION STARTS ########################################### //
+
+    std::string     BlackPWMChip::chipPathMap[4];
+    pthread_once_t  BlackPWMChip::chipMapOnce = PTHREAD_ONCE_INIT;
+
+
+    BlackPWMChip::BlackPWMChip(pwmName pwm)
+    {
+        this->pwmChipErrors     = new errorPWMChip();
+        this->pwmPinName        = pwm;
+        this->periodFD          = -1;
+        this->dutyFD            = -1;
+        this->enableFD          = -1;
+        this->polarityFD        = -1;
+        this->lastPeriodValue   = -1;
+
+        // map index: 0 => ecap0, 1 => ehrpwm0, 2 => ehrpwm1, 3 => ehrpwm2
+        int chipIndex;
+        switch( pwm )
+        {
+            case P8_13: { chipIndex = 3; this->channelNumber = 1; break; }
+            case P8_19: { chipIndex = 3; this->channelNumber = 0; break; }
+            case P9_14: { chipIndex = 2; this->channelNumber = 0; break; }
+            case P9_16: { chipIndex = 2; this->channelNumber = 1; break; }
+            case P9_21: { chipIndex = 1; this->channelNumber = 1; break; }
+            case P9_22: { chipIndex = 1; this->channelNumber = 0; break; }
+            default:    { chipIndex = 0; this->channelNumber = 0; break; }
+        }
+
+        pthread_once(&BlackPWMChip::chipMapOnce, &BlackPWMChip::resolveChipPaths);
+
+        this->chipPath = BlackPWMChip::chipPathMap[chipIndex];
+        if( this->chipPath == "" )
+        {
+            this->pwmChipErrors->chipError = true;
+            return;
+        }
+
+        char channelDir[16];
+        snprintf(channelDir, sizeof(channelDir), "/pwm%d", this->channelNumber);
+        this->channelPath = this->chipPath + channelDir;
+
+        this->doExport();
+    }
+
+    BlackPWMChip::~BlackPWMChip()
+    {
+        if( this->periodFD >= 0 )   { ::close(this->periodFD);   }
+        if( this->dutyFD >= 0 )     { ::close(this->dutyFD);     }
+        if( this->enableFD >= 0 )   { ::close(this->enableFD);   }
+        if( this->polarityFD >= 0 ) { ::close(this->polarityFD); }
+
+        delete this->pwmChipErrors;
+    }
+
+    void        BlackPWMChip::resolveChipPaths()
+    {
+        // physical addresses of ecap0, ehrpwm0, ehrpwm1 and ehrpwm2 submodules
+        const char *submoduleAddress[4] = { "48300100.", "48300200.", "48302200.", "48304200." };
+
+        DIR *classDir = opendir(PWM_CLASS_PATH.c_str());
+        if( classDir == NULL )
+        {
+            return;
+        }
+
+        struct dirent *entry;
+        char linkTarget[512];
+
+        while( (entry = readdir(classDir)) != NULL )
+        {
+            std::string entryName(entry->d_name);
+            if( entryName.compare(0, 7, "pwmchip") != 0 )
+            {
+                continue;
+            }
+
+            std::string entryPath = PWM_CLASS_PATH + "/" + entryName;
+            ssize_t targetSize = readlink(entryPath.c_str(), linkTarget, sizeof(linkTarget) - 1);
+            if( targetSize <= 0 )
+            {
+                continue;
+            }
+            linkTarget[targetSize] = '\0';
+
+            std::string target(linkTarget);
+            for( int i = 0 ; i < 4 ; i++ )
+            {
+                if( target.find(submoduleAddress[i]) != std::string::npos )
+                {
+                    BlackPWMChip::chipPathMap[i] = entryPath;
+                    break;
+                }
+            }
+        }
+
+        closedir(classDir);
+    }
+
+    bool        BlackPWMChip::doExport()
+    {
+        bool isExportedNow = false;
+
+        if( access(this->channelPath.c_str(), F_OK) != 0 )
+        {
+            std::string exportPath = this->chipPath + "/export";
+            int exportFD = ::open(exportPath.c_str(), O_WRONLY);
+            if( exportFD < 0 )
+            {
+                this->pwmChipErrors->exportError = true;
+                return false;
+            }
+
+            char channel[8];
+            int size = snprintf(channel, sizeof(channel), "%d", this->channelNumber);
+            bool isWritten = (::write(exportFD, channel, size) == size);
+            ::close(exportFD);
+
+            if( not isWritten )
+            {
+                this->pwmChipErrors->exportError = true;
+                return false;
+            }
+
+            isExportedNow = true;
+        }
+
+        this->pwmChipErrors->exportError = false;
+
+        this->periodFD      = this->openChannelFile("/period", isExportedNow);
+        this->dutyFD        = this->openChannelFile("/duty_cycle", isExportedNow);
+        this->enableFD      = this->openChannelFile("/enable", isExportedNow);
+        this->polarityFD    = this->openChannelFile("/polarity", isExportedNow);
+
+        this->pwmChipErrors->periodFileError    = (this->periodFD < 0);
+        this->pwmChipErrors->dutyFileError      = (this->dutyFD < 0);
+        this->pwmChipErrors->enableFileError    = (this->enableFD < 0);
+        this->pwmChipErrors->polarityFileError  = (this->polarityFD < 0);
+
+        this->lastPeriodValue = this->getNumericPeriodValue();
+
+        return ( this->periodFD >= 0 and this->dutyFD >= 0 and this->enableFD >= 0 );
+    }
+
+    int         BlackPWMChip::openChannelFile(const std::string &fileName, bool isExportedNow)
+    {
+        std::string filePath = this->channelPath + fileName;
+
+        // udev can change the owner of new channel files after the export, so give it a short time
+        int tryCount = isExportedNow ? 10 : 1;
+        for( int i = 0 ; i < tryCount ; i++ )
+        {
+            int fd = ::open(filePath.c_str(), O_RDWR);
+            if( fd >= 0 )
+            {
+                return fd;
+            }
+
+            if( i + 1 < tryCount )
+            {
+                usleep(10000);
+            }
+        }
+
+        return -1;
+    }
+
+    bool        BlackPWMChip::writeToFile(int fd, const char *value, size_t size)
+    {
+        if( fd < 0 )
+        {
+            return false;
+        }
+
+        return ( ::pwrite(fd, value, size, 0) == static_cast<ssize_t>(size) );
+    }
+
+    bool        BlackPWMChip::writeNumericToFile(int fd, uint64_t value)
+    {
+        char buffer[24];
+        int size = snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+
+        return this->writeToFile(fd, buffer, size);
+    }
+
+    std::string BlackPWMChip::readFromFile(int fd)
+    {
+        if( fd < 0 )
+        {
+            return FILE_COULD_NOT_OPEN_STRING;
+        }
+
+        char buffer[32];
+        ssize_t size = ::pread(fd, buffer, sizeof(buffer) - 1, 0);
+        if( size <= 0 )
+        {
+            return FILE_COULD_NOT_OPEN_STRING;
+        }
+
+        buffer[size] = '\0';
+
+        ssize_t wordEnd = 0;
+        while( wordEnd < size and buffer[wordEnd] != '\n' and buffer[wordEnd] != ' ' )
+        {
+            wordEnd++;
+        }
+
+        return std::string(buffer, wordEnd);
+    }
+
+    uint64_t    BlackPWMChip::toNanosecond(uint64_t value, timeType tType)
+    {
+        switch( tType )
+        {
+            case picosecond:    { return value / 1000;          }
+            case microsecond:   { return value * 1000;          }
+            case milisecond:    { return value * 1000000;       }
+            case second:        { return value * 1000000000;    }
+            default:            { return value;                 }
+        }
+    }
+
+
+
+    std::string BlackPWMChip::getValue()
+    {
+        int64_t period  = this->getNumericPeriodValue();
+        int64_t duty    = this->getNumericDutyValue();
+
+        if( period <= 0 or duty < 0 )
+        {
+            return FILE_COULD_NOT_OPEN_STRING;
+        }
+
+        return tostr( 100.0 * static_cast<float>(duty) / static_cast<float>(period) );
+    }
+
+    std::string BlackPWMChip::getPeriodValue()
+    {
+        std::string readValue = this->readFromFile(this->periodFD);
+        this->pwmChipErrors->periodFileError = (readValue == FILE_COULD_NOT_OPEN_STRING);
+        return readValue;
+    }
+
+    std::string BlackPWMChip::getDutyValue()
+    {
+        std::string readValue = this->readFromFile(this->dutyFD);
+        this->pwmChipErrors->dutyFileError = (readValue == FILE_COULD_NOT_OPEN_STRING);
+        return readValue;
+    }
+
+    std::string BlackPWMChip::getRunValue()
+    {
+        std::string readValue = this->readFromFile(this->enableFD);
+        this->pwmChipErrors->enableFileError = (readValue == FILE_COULD_NOT_OPEN_STRING);
+        return readValue;
+    }
+
+    std::string BlackPWMChip::getPolarityValue()
+    {
+        std::string readValue = this->readFromFile(this->polarityFD);
+        this->pwmChipErrors->polarityFileError = (readValue == FILE_COULD_NOT_OPEN_STRING);
+
+        if( readValue == "normal" )
+        {
+            return "0";
+        }
+        else if( readValue == "inversed" )
+        {
+            return "1";
+        }
+
+        return readValue;
+    }
+
+    float       BlackPWMChip::getNumericValue()
+    {
+        int64_t period  = this->getNumericPeriodValue();
+        int64_t duty    = this->getNumericDutyValue();
+
+        if( period <= 0 or duty < 0 )
+        {
+            return FILE_COULD_NOT_OPEN_FLOAT;
+        }
+
+        return ( 100.0 * static_cast<float>(duty) / static_cast<float>(period) );
+    }
+
+    int64_t     BlackPWMChip::getNumericPeriodValue()
+    {
+        std::string readValue = this->getPeriodValue();
+        if( readValue == FILE_COULD_NOT_OPEN_STRING )
+        {
+            return FILE_COULD_NOT_OPEN_INT;
+        }
+
+        this->lastPeriodValue = strtoll(readValue.c_str(), NULL, 10);
+        return this->lastPeriodValue;
+    }
+
+    int64_t     BlackPWMChip::getNumericDutyValue()
+    {
+        std::string readValue = this->getDutyValue();
+        if( readValue == FILE_COULD_NOT_OPEN_STRING )
+        {
+            return FILE_COULD_NOT_OPEN_INT;
+        }
+
+        return strtoll(readValue.c_str(), NULL, 10);
+    }
+
+
+
+    bool        BlackPWMChip::setDutyPercent(float percentage)
+    {
+        if( percentage > 100.0 or percentage < 0.0 )
+        {
+            this->pwmChipErrors->outOfRange      = true;
+            this->pwmChipErrors->dutyFileError   = true;
+            return false;
+        }
+
+        this->pwmChipErrors->outOfRange = false;
+
+        if( this->lastPeriodValue < 0 and this->getNumericPeriodValue() < 0 )
+        {
+            this->pwmChipErrors->dutyFileError = true;
+            return false;
+        }
+
+        uint64_t writeThis = static_cast<uint64_t>(std::round(this->lastPeriodValue * (percentage / 100.0)));
+
+        this->pwmChipErrors->dutyFileError = not this->writeNumericToFile(this->dutyFD, writeThis);
+        return not this->pwmChipErrors->dutyFileError;
+    }
+
+    bool        BlackPWMChip::setPeriodTime(uint64_t period, timeType tType)
+    {
+        uint64_t writeThis = this->toNanosecond(period, tType);
+
+        if( writeThis > 1000000000 )
+        {
+            this->pwmChipErrors->outOfRange = true;
+            return false;
+        }
+
+        this->pwmChipErrors->outOfRange = false;
+
+        // kernel rejects a period which is less than duty cycle, so the duty cycle is lowered first
+        if( this->lastPeriodValue < 0 )
+        {
+            this->getNumericPeriodValue();
+        }
+
+        if( this->lastPeriodValue < 0 or writeThis < static_cast<uint64_t>(this->lastPeriodValue) )
+        {
+            int64_t duty = this->getNumericDutyValue();
+
+            if( duty != FILE_COULD_NOT_OPEN_INT and static_cast<uint64_t>(duty) > writeThis )
+            {
+                uint64_t newDuty = writeThis;
+                if( this->lastPeriodValue > 0 and duty <= this->lastPeriodValue )
+                {
+                    newDuty = static_cast<uint64_t>(duty) * writeThis / static_cast<uint64_t>(this->lastPeriodValue);
+                }
+
+                if( not this->writeNumericToFile(this->dutyFD, newDuty) )
+                {
+                    this->pwmChipErrors->dutyFileError      = true;
+                    this->pwmChipErrors->periodFileError    = true;
+                    return false;
+                }
+                this->pwmChipErrors->dutyFileError = false;
+            }
+        }
+
+        if( this->writeNumericToFile(this->periodFD, writeThis) )
+        {
+            this->lastPeriodValue = static_cast<int64_t>(writeThis);
+            this->pwmChipErrors->periodFileError = false;
+            return true;
+        }
+
+        this->pwmChipErrors->periodFileError = true;
+        return false;
+    }
+
+    bool        BlackPWMChip::setSpaceRatioTime(uint64_t space, timeType tType)
+    {
+        uint64_t spaceTime = this->toNanosecond(space, tType);
+
+        if( this->lastPeriodValue < 0 and this->getNumericPeriodValue() < 0 )
+        {
+            this->pwmChipErrors->dutyFileError = true;
+            return false;
+        }
+
+        if( spaceTime > static_cast<uint64_t>(this->lastPeriodValue) )
+        {
+            this->pwmChipErrors->outOfRange = true;
+            return false;
+        }
+
+        this->pwmChipErrors->outOfRange = false;
+        this->pwmChipErrors->dutyFileError = not this->writeNumericToFile(this->dutyFD, this->lastPeriodValue - spaceTime);
+        return not this->pwmChipErrors->dutyFileError;
+    }
+
+    bool        BlackPWMChip::setLoadRatioTime(uint64_t load, timeType tType)
+    {
+        uint64_t writeThis = this->toNanosecond(load, tType);
+
+        if( writeThis > 1000000000 )
+        {
+            this->pwmChipErrors->outOfRange = true;
+            return false;
+        }
+
+        this->pwmChipErrors->outOfRange = false;
+        this->pwmChipErrors->dutyFileError = not this->writeNumericToFile(this->dutyFD, writeThis);
+        return not this->pwmChipErrors->dutyFileError;
+    }
+
+    bool        BlackPWMChip::setPolarity(polarityType polarity)
+    {
+        bool isWritten;
+        if( polarity == straight )
+        {
+            isWritten = this->writeToFile(this->polarityFD, "normal", 6);
+        }
+        else
+        {
+            isWritten = this->writeToFile(this->polarityFD, "inversed", 8);
+        }
+
+        this->pwmChipErrors->polarityFileError = not isWritten;
+        return isWritten;
+    }
+
+    bool        BlackPWMChip::setRunState(runValue state)
+    {
+        bool isWritten = this->writeToFile(this->enableFD, (state == run) ? "1" : "0", 1);
+
+        this->pwmChipErrors->enableFileError = not isWritten;
+        return isWritten;
+    }
+
+    void        BlackPWMChip::toggleRunState()
+    {
+        std::string currentRunValue = this->getRunValue();
+
+        if( currentRunValue == "1" )
+        {
+            this->setRunState(stop);
+        }
+        else if( currentRunValue == "0" )
+        {
+            this->setRunState(run);
+        }
+    }
+
+    void        BlackPWMChip::tooglePolarity()
+    {
+        std::string currentPolarity = this->getPolarityValue();
+
+        if( currentPolarity == "0" )
+        {
+            this->setPolarity(reverse);
+        }
+        else if( currentPolarity == "1" )
+        {
+            this->setPolarity(straight);
+        }
+    }
+
+    bool        BlackPWMChip::isRunning()
+    {
+        return ( this->getRunValue() == "1" );
+    }
+
+    bool        BlackPWMChip::isPolarityStraight()
+    {
+        return ( this->getPolarityValue() == "0" );
+    }
+
+    bool        BlackPWMChip::isPolarityReverse()
+    {
+        return ( this->getPolarityValue() == "1" );
+    }
+
+    std::string BlackPWMChip::getChannelPath()
+    {
+        return this->channelPath;
+    }
+
+
+
+    bool        BlackPWMChip::fail()
+    {
+        return (this->pwmChipErrors->chipError or
+                this->pwmChipErrors->exportError or
+                this->pwmChipErrors->periodFileError or
+                this->pwmChipErrors->dutyFileError or
+                this->pwmChipErrors->enableFileError or
+                this->pwmChipErrors->polarityFileError or
+                this->pwmChipErrors->outOfRange
+                );
+    }
+
+    bool        BlackPWMChip::fail(BlackPWMChip::flags f)
+    {
+        if(f==chipErr)          { return this->pwmChipErrors->chipError;            }
+        if(f==exportErr)        { return this->pwmChipErrors->exportError;          }
+        if(f==periodFileErr)    { return this->pwmChipErrors->periodFileError;      }
+        if(f==dutyFileErr)      { return this->pwmChipErrors->dutyFileError;        }
+        if(f==runFileErr)       { return this->pwmChipErrors->enableFileError;      }
+        if(f==polarityFileErr)  { return this->pwmChipErrors->polarityFileError;    }
+        if(f==outOfRangeErr)    { return this->pwmChipErrors->outOfRange;           }
+
+        return true;
+    }
+
+    // ############################################ BLACKPWMCHIP DEFINITION ENDS ############################################ //
+
+} /* namespace BlackLib */
@@ -0,0 +1,366 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKPWMCHIP_H_
+#define BLACKPWMCHIP_H_
+
+#include "../BlackPWM/BlackPWM.h"
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This constant is used for the generic pwm class directory of kernel.
+    */
+    const std::string       PWM_CLASS_PATH              = "/sys/class/pwm";
+
+
+
+
+    // ########################################## BLACKPWMCHIP DECLARATION STARTS ########################################## //
+
+    /*! @brief Interacts with end user, to use PWM over generic pwm class interface.
+     *
+     *    This class is an alternative of the BlackPWM class for the kernels which expose the pwm outputs
+     *    at @b "/sys/class/pwm/pwmchipN/pwmM" directories instead of the @b "am33xx_pwm" and @b "bone_pwm_*"
+     *    overlays. It doesn't load device tree overlays and it doesn't search the ocp directory, so it is
+     *    not derived from BlackCore class.
+     *
+     *    The pwmchip of every pwm subsystem is resolved only once per process, by reading the links at
+     *    pwm class directory. After the channel is exported, period, duty_cycle, enable and polarity files
+     *    are opened once and kept open until the object is destroyed. All read and write operations are
+     *    done with pread() and pwrite() system calls over these persistent file descriptors.
+     *
+     *    Public functions of this class have the same names and meanings with the BlackPWM class. But
+     *    the kernel's duty_cycle file holds the load time (the time that stays at "1"), so getDutyValue()
+     *    and getNumericDutyValue() functions return load time unlike BlackPWM class.
+     *
+     *    @warning The pin of selected pwm output must be muxed to pwm mode (for example with using
+     *    config-pin tool) before using this class.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myPwmChipProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackPWMChip/BlackPWMChip.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackPWMChip  myPwm(BlackLib::P9_14);
+     *
+     *      myPwm.setPeriodTime(100, BlackLib::microsecond);
+     *      myPwm.setDutyPercent(25.0);
+     *      myPwm.setRunState(BlackLib::run);
+     *
+     *      std::cout << "Pwm duty ratio: " << myPwm.getValue() << "%" << std::endl;
+     *      std::cout << "Pwm path: " << myPwm.getChannelPath() << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     * @code{.cpp}
+     *   // Possible Output:
+     *   // Pwm duty ratio: 25%
+     *   // Pwm path: /sys/class/pwm/pwmchip2/pwm0
+     * @endcode
+     */
+    class BlackPWMChip
+    {
+        private:
+            errorPWMChip    *pwmChipErrors;             /*!< @brief is used to hold the errors of BlackPWMChip class */
+            pwmName         pwmPinName;                 /*!< @brief is used to hold the selected pwm @b pin name */
+            int             channelNumber;              /*!< @brief is used to hold the pwm channel number at pwmchip */
+            std::string     chipPath;                   /*!< @brief is used to hold the pwmchip directory path */
+            std::string     channelPath;                /*!< @brief is used to hold the exported pwm channel directory path */
+            int             periodFD;                   /*!< @brief is used to hold the @a period file's file descriptor */
+            int             dutyFD;                     /*!< @brief is used to hold the @a duty_cycle file's file descriptor */
+            int             enableFD;                   /*!< @brief is used to hold the @a enable file's file descriptor */
+            int             polarityFD;                 /*!< @brief is used to hold the @a polarity file's file descriptor */
+            int64_t         lastPeriodValue;            /*!< @brief is used to hold the last known period value, -1 if unknown */
+
+            static std::string      chipPathMap[4];     /*!< @brief is used to hold the resolved pwmchip paths of ecap0, ehrpwm0, ehrpwm1 and ehrpwm2 */
+            static pthread_once_t   chipMapOnce;        /*!< @brief is used to resolve the pwmchip paths once per process */
+
+            /*! @brief Resolves pwmchip paths of all pwm subsystems.
+            *
+            *  This function reads links of @b "pwmchipN" entries at pwm class directory and matches
+            *  them with the physical addresses of pwm subsystems. It runs once per process.
+            */
+            static void     resolveChipPaths();
+
+            /*! @brief Exports pwm channel and opens its files.
+            *
+            *  @return True if successful, else false.
+            */
+            bool            doExport();
+
+            /*! @brief Opens file of pwm channel.
+            *
+            *  If the channel is exported just now, the file permissions might not be ready. So this
+            *  function retries opening for a short time.
+            *  @return file descriptor if successful, else -1.
+            */
+            int             openChannelFile(const std::string &fileName, bool isExportedNow);
+
+            /*! @brief Writes string to file of pwm channel from its beginning.
+            *
+            *  @return True if successful, else false.
+            */
+            bool            writeToFile(int fd, const char *value, size_t size);
+
+            /*! @brief Writes numeric value to file of pwm channel.
+            *
+            *  @return True if successful, else false.
+            */
+            bool            writeNumericToFile(int fd, uint64_t value);
+
+            /*! @brief Reads first word of file of pwm channel.
+            *
+            *  @return read word if successful, else BlackLib::FILE_COULD_NOT_OPEN_STRING.
+            */
+            std::string     readFromFile(int fd);
+
+            /*! @brief Converts time value to nanosecond.
+            *
+            *  @return nanosecond equivalent of value.
+            */
+            uint64_t        toNanosecond(uint64_t value, timeType tType);
+
+
+        public:
+            /*!
+            * This enum is used to define PWMChip debugging flags.
+            */
+            enum flags      {   periodFileErr   = 0,    /*!< enumeration for @a errorPWMChip::periodFileError status */
+                                dutyFileErr     = 1,    /*!< enumeration for @a errorPWMChip::dutyFileError status */
+                                runFileErr      = 2,    /*!< enumeration for @a errorPWMChip::enableFileError status */
+                                polarityFileErr = 3,    /*!< enumeration for @a errorPWMChip::polarityFileError status */
+                                outOfRangeErr   = 4,    /*!< enumeration for @a errorPWMChip::outOfRange status */
+                                chipErr         = 5,    /*!< enumeration for @a errorPWMChip::chipError status */
+                                exportErr       = 6     /*!< enumeration for @a errorPWMChip::exportError status */
+                            };
+
+            /*! @brief Constructor of BlackPWMChip class.
+            *
+            * This function initializes errorPWMChip struct, finds pwmchip of selected pwm output,
+            * exports the channel and opens its files.
+            * @param [in] pwm        pwm name (enum)
+            *
+            * @sa pwmName
+            */
+                            BlackPWMChip(pwmName pwm);
+
+            /*! @brief Destructor of BlackPWMChip class.
+            *
+            * This function closes the files of pwm channel and deletes errorPWMChip struct pointer.
+            * The channel is not unexported, so the output keeps its state.
+            */
+            virtual         ~BlackPWMChip();
+
+            /*! @brief Reads percentage value of duty cycle.
+            *
+            *  @return @a String type percentage value of the time that stays at "1".
+            */
+            std::string     getValue();
+
+            /*! @brief Reads period value of pwm signal.
+            *
+            *  @return @a String type period value at nanosecond level. If reading fails, it returns
+            *  BlackLib::FILE_COULD_NOT_OPEN_STRING.
+            */
+            std::string     getPeriodValue();
+
+            /*! @brief Reads duty cycle value of pwm signal.
+            *
+            *  @return @a String type load time value at nanosecond level. If reading fails, it returns
+            *  BlackLib::FILE_COULD_NOT_OPEN_STRING.
+            */
+            std::string     getDutyValue();
+
+            /*! @brief Reads enable value of pwm signal.
+            *
+            *  @return @a String type run value. If reading fails, it returns BlackLib::FILE_COULD_NOT_OPEN_STRING.
+            */
+            std::string     getRunValue();
+
+            /*! @brief Reads polarity value of pwm signal.
+            *
+            *  @return "0" for @a normal and "1" for @a inversed polarity. If reading fails, it returns
+            *  BlackLib::FILE_COULD_NOT_OPEN_STRING.
+            */
+            std::string     getPolarityValue();
+
+            /*! @brief Reads numeric percentage value of duty cycle.
+            *
+            *  @return @a Float type percentage value of the time that stays at "1".
+            */
+            float           getNumericValue();
+
+            /*! @brief Reads numeric period value of pwm signal.
+            *
+            *  @return period value at nanosecond level. If reading fails, it returns BlackLib::FILE_COULD_NOT_OPEN_INT.
+            */
+            int64_t         getNumericPeriodValue();
+
+            /*! @brief Reads numeric duty cycle value of pwm signal.
+            *
+            *  @return load time value at nanosecond level. If reading fails, it returns BlackLib::FILE_COULD_NOT_OPEN_INT.
+            */
+            int64_t         getNumericDutyValue();
+
+            /*! @brief Sets percentage value of duty cycle.
+            *
+            * If input parameter is in range (from 0.0 to 100.0), this function changes duty cycle
+            * without changing period value. The period value is not read from file, the last known
+            * period value is used.
+            * @param [in] percentage new percentage value(float)
+            * @return True if setting new value is successful, else false.
+            */
+            bool            setDutyPercent(float percentage);
+
+            /*! @brief Sets period value of pwm signal.
+            *
+            * The kernel rejects a period value which is less than the current duty cycle value. So if the
+            * period is decreased below the duty cycle, duty cycle is written first, scaled with the period
+            * change so the duty percentage is kept.
+            *
+            * @param [in] period new period value
+            * @param [in] tType time type of your new period value(enum)
+            * @return True if setting new period value is successful, else false.
+            */
+            bool            setPeriodTime(uint64_t period, timeType tType = nanosecond);
+
+            /*! @brief Sets space time value of pwm signal.
+            *
+            * This function writes (period - space) value to duty_cycle file.
+            * @param [in] space new space time
+            * @param [in] tType time type of your new space time value(enum)
+            * @return True if setting new value is successful, else false.
+            */
+            bool            setSpaceRatioTime(uint64_t space, timeType tType = nanosecond);
+
+            /*! @brief Sets load time value of pwm signal.
+            *
+            * This function writes input value to duty_cycle file directly.
+            * @param [in] load new load time
+            * @param [in] tType time type of your new load time value(enum)
+            * @return True if setting new value is successful, else false.
+            */
+            bool            setLoadRatioTime(uint64_t load, timeType tType = nanosecond);
+
+            /*! @brief Sets polarity of pwm signal.
+            *
+            * @param [in] polarity new polarity value(enum)
+            * @return True if setting new polarity is successful, else false.
+            *
+            * @warning Some pwm drivers don't allow changing polarity while the output is enabled.
+            */
+            bool            setPolarity(polarityType polarity);
+
+            /*! @brief Sets run value of pwm signal.
+            *
+            * @param [in] state new run value(enum)
+            * @return True if setting new run value is successful, else false.
+            */
+            bool            setRunState(runValue state);
+
+            /*! @brief Toggles run state of pwm signal.
+            */
+            void            toggleRunState();
+
+            /*! @brief Toggles polarity type of pwm signal.
+            *
+            * This function has the same name with BlackPWM::tooglePolarity() function for compatibility.
+            */
+            void            tooglePolarity();
+
+            /*! @brief Checks run state of pwm signal.
+            *
+            * @return True if enable value equals to 1, else false.
+            */
+            bool            isRunning();
+
+            /*! @brief Checks polarity of pwm signal.
+            *
+            * @return True if polarity is normal, else false.
+            */
+            bool            isPolarityStraight();
+
+            /*! @brief Checks polarity of pwm signal.
+            *
+            * @return True if polarity is inversed, else false.
+            */
+            bool            isPolarityReverse();
+
+            /*! @brief Exports directory path of pwm channel.
+            *
+            * @return pwm channel directory path like @b "/sys/class/pwm/pwmchip2/pwm0".
+            */
+            std::string     getChannelPath();
+
+            /*! @brief Is used for general debugging.
+            *
+            * @return True if any error occured, else false.
+            *
+            * @sa errorPWMChip
+            */
+            bool            fail();
+
+            /*! @brief Is used for specific debugging.
+            *
+            * @param [in] f specific error type (enum)
+            * @return Value of @a selected error.
+            *
+            * @sa errorPWMChip
+            */
+            bool            fail(BlackPWMChip::flags f);
+    };
+    // ########################################### BLACKPWMCHIP DECLARATION ENDS ########################################### //
+
+
+
+} /* namespace BlackLib */
+
+#endif /* BLACKPWMCHIP_H_ */
@@ -0,0 +1,272 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackPWMSequencer.h"
+
+
+
+
+
+namespace BlackLib
+{
+
+    // ####################################### BLACKPWMSEQUENCER DEFINITION STARTS ######################################## //
+    BlackPWMSequencer::BlackPWMSequencer(uint32_t rate) : BlackPeriodicThread( 1000000000ULL / ((rate == 0) ? 1 : rate), nanosecond )
+    {
+        this->updateRate        = (rate == 0) ? 1 : rate;
+        this->stepCount         = 0;
+        this->currentStep       = 0;
+        this->writeErrorCount   = 0;
+        this->isLooping         = false;
+
+        pthread_mutex_init( &(this->progressMutex), NULL);
+    }
+
+    BlackPWMSequencer::~BlackPWMSequencer()
+    {
+        pthread_mutex_destroy( &(this->progressMutex) );
+    }
+
+
+
+    uint64_t    BlackPWMSequencer::percentToSpaceTime(int64_t period, float percentage)
+    {
+        if( percentage > 100.0 )    { percentage = 100.0;   }
+        if( percentage < 0.0 )      { percentage = 0.0;     }
+
+        return static_cast<uint64_t>( std::floor(period * (1.0 - (percentage / 100.0)) + 0.5) );
+    }
+
+    void        BlackPWMSequencer::updateStepCount()
+    {
+        uint64_t longest = 0;
+
+        for( unsigned int i = 0 ; i < this->channels.size() ; i++ )
+        {
+            if( this->channels[i].spaceTimes.size() > longest )
+            {
+                longest = this->channels[i].spaceTimes.size();
+            }
+        }
+
+        this->stepCount = longest;
+    }
+
+
+
+    int         BlackPWMSequencer::addChannel(BlackPWM *pwm)
+    {
+        if( pwm == NULL or this->isRunning() )
+        {
+            return -1;
+        }
+
+        sequencerChannel newChannel;
+        newChannel.pwm = pwm;
+
+        this->channels.push_back(newChannel);
+        return static_cast<int>(this->channels.size() - 1);
+    }
+
+    bool        BlackPWMSequencer::setRamp(unsigned int channel, float fromPercent, float toPercent,
+                                           uint64_t duration, timeType tType, rampProfile profile)
+    {
+        if( channel >= this->channels.size() or this->isRunning() )
+        {
+            return false;
+        }
+
+        uint64_t durationNs;
+        switch(tType)
+        {
+            case picosecond:    { durationNs = duration / 1000;             break; }
+            case nanosecond:    { durationNs = duration;                    break; }
+            case microsecond:   { durationNs = duration * 1000;             break; }
+            case milisecond:    { durationNs = duration * 1000000;          break; }
+            case second:        { durationNs = duration * 1000000000ULL;    break; }
+            default:            { return false;                                    }
+        }
+
+        int64_t period = this->channels[channel].pwm->getNumericPeriodValue();
+        if( period <= 0 )
+        {
+            return false;
+        }
+
+        uint64_t intervals  = (durationNs * this->updateRate + 500000000ULL) / 1000000000ULL;
+        std::vector<uint64_t> &spaceTimes = this->channels[channel].spaceTimes;
+
+        spaceTimes.resize(intervals + 1);
+
+        for( uint64_t i = 0 ; i <= intervals ; i++ )
+        {
+            double t = (intervals == 0) ? 1.0 : (static_cast<double>(i) / intervals);
+
+            if( profile == SCurveRamp )
+            {
+                t = t * t * (3.0 - 2.0 * t);
+            }
+
+            spaceTimes[i] = this->percentToSpaceTime(period, static_cast<float>(fromPercent + (toPercent - fromPercent) * t));
+        }
+
+        this->updateStepCount();
+        return true;
+    }
+
+    bool        BlackPWMSequencer::setTable(unsigned int channel, const std::vector<float> &percentages)
+    {
+        if( channel >= this->channels.size() or this->isRunning() )
+        {
+            return false;
+        }
+
+        int64_t period = this->channels[channel].pwm->getNumericPeriodValue();
+        if( period <= 0 )
+        {
+            return false;
+        }
+
+        std::vector<uint64_t> &spaceTimes = this->channels[channel].spaceTimes;
+        spaceTimes.resize( percentages.size() );
+
+        for( unsigned int i = 0 ; i < percentages.size() ; i++ )
+        {
+            spaceTimes[i] = this->percentToSpaceTime(period, percentages[i]);
+        }
+
+        this->updateStepCount();
+        return true;
+    }
+
+    void        BlackPWMSequencer::clearChannel(unsigned int channel)
+    {
+        if( channel < this->channels.size() and !(this->isRunning()) )
+        {
+            this->channels[channel].spaceTimes.clear();
+            this->updateStepCount();
+        }
+    }
+
+    void        BlackPWMSequencer::setLooping(bool loop)
+    {
+        this->isLooping = loop;
+    }
+
+    bool        BlackPWMSequencer::setUpdateRate(uint32_t rate)
+    {
+        if( rate == 0 or this->isRunning() )
+        {
+            return false;
+        }
+
+        this->updateRate = rate;
+        return this->setInterval( 1000000000ULL / rate, nanosecond );
+    }
+
+    uint32_t    BlackPWMSequencer::getUpdateRate()
+    {
+        return this->updateRate;
+    }
+
+    uint64_t    BlackPWMSequencer::getStepCount()
+    {
+        return this->stepCount;
+    }
+
+    uint64_t    BlackPWMSequencer::getCurrentStep()
+    {
+        pthread_mutex_lock( &(this->progressMutex) );
+        uint64_t temp = this->currentStep;
+        pthread_mutex_unlock( &(this->progressMutex) );
+
+        return temp;
+    }
+
+    uint64_t    BlackPWMSequencer::getWriteErrorCount()
+    {
+        pthread_mutex_lock( &(this->progressMutex) );
+        uint64_t temp = this->writeErrorCount;
+        pthread_mutex_unlock( &(this->progressMutex) );
+
+        return temp;
+    }
+
+
+
+    bool        BlackPWMSequencer::onTickHandler(uint64_t tick)
+    {
+        if( this->stepCount == 0 )
+        {
+            return false;
+        }
+
+        uint64_t step       = tick;
+        bool     isLastStep = false;
+
+        if( this->isLooping )
+        {
+            step = step % this->stepCount;
+        }
+        else if( step >= (this->stepCount - 1) )
+        {
+            // missed ticks can jump over the end, the last sample must be written in any case
+            step        = this->stepCount - 1;
+            isLastStep  = true;
+        }
+
+        uint64_t errorCount = 0;
+
+        for( unsigned int i = 0 ; i < this->channels.size() ; i++ )
+        {
+            const std::vector<uint64_t> &spaceTimes = this->channels[i].spaceTimes;
+
+            if( step < spaceTimes.size() )
+            {
+                if( ! this->channels[i].pwm->setSpaceRatioTime(spaceTimes[step], nanosecond) )
+                {
+                    ++errorCount;
+                }
+            }
+        }
+
+        // pwm writes are done without the lock, so readers don't wait for file accesses
+        pthread_mutex_lock( &(this->progressMutex) );
+        this->writeErrorCount  += errorCount;
+        this->currentStep       = step;
+        pthread_mutex_unlock( &(this->progressMutex) );
+
+        return !isLastStep;
+    }
+    // ######################################## BLACKPWMSEQUENCER DEFINITION ENDS ######################################### //
+
+
+} /* namespace BlackLib */
@@ -0,0 +1,247 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKPWMSEQUENCER_H_
+#define BLACKPWMSEQUENCER_H_
+
+#include "../BlackPWM/BlackPWM.h"
+#include "../BlackThread/BlackThread.h"
+
+#include <vector>
+#include <cmath>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting ramp profile of BlackPWMSequencer.
+    */
+    enum rampProfile        {   LinearRamp              = 0,
+                                SCurveRamp              = 1
+                            };
+
+
+
+
+    // ####################################### BLACKPWMSEQUENCER DECLARATION STARTS ######################################## //
+
+    /*! @brief Plays precomputed duty cycle trajectories on pwm outputs.
+     *
+     *    This class is used for soft-starting motors, sweeping servos and similar jobs which are done
+     *    with setDutyPercent() and usleep() calls in user loops. Users add one or more BlackPWM objects
+     *    as channels and load a ramp (linear or S-curve) or a sample table to each channel. All duty
+     *    values are calculated as nanosecond values before the playback starts. Then the values are
+     *    written to pwm outputs at fixed update rate, from an absolute time timer thread.
+     *
+     *    The channels which have shorter trajectory than the others, hold their last value until the
+     *    longest trajectory finishes. Timing statistics (overruns, missed ticks and wake-up latencies)
+     *    can be read with getStatistics() function while the sequencer is running or after finished.
+     *
+     *    @warning Trajectories can't change while the sequencer is running.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myPwmSequencerProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackPWMSequencer/BlackPWMSequencer.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackPWM          motor(BlackLib::P9_14);
+     *      BlackLib::BlackPWM          servo(BlackLib::P9_16);
+     *      BlackLib::BlackPWMSequencer sequencer(500);
+     *
+     *      int motorCh = sequencer.addChannel(&motor);
+     *      int servoCh = sequencer.addChannel(&servo);
+     *
+     *      sequencer.setRamp(motorCh, 0.0, 80.0, 2000, BlackLib::milisecond, BlackLib::SCurveRamp);
+     *      sequencer.setRamp(servoCh, 5.0, 10.0, 1000, BlackLib::milisecond);
+     *
+     *      sequencer.run();
+     *      WAIT_THREAD_FINISH(&sequencer)
+     *
+     *      std::cout << "Overruns: " << sequencer.getStatistics().overrunCount << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackPWMSequencer : public BlackPeriodicThread
+    {
+        private:
+
+            /*! @brief Holds one channel of the sequencer.
+             *
+             *  Space times are the values which are written to duty file of the pwm, at nanosecond level.
+             */
+            struct sequencerChannel
+            {
+                BlackPWM                *pwm;               /*!< @brief is used to hold the pwm object of channel */
+                std::vector<uint64_t>   spaceTimes;         /*!< @brief is used to hold the precomputed space time values of channel */
+            };
+
+            std::vector<sequencerChannel>   channels;           /*!< @brief is used to hold the channels of sequencer */
+            uint32_t                        updateRate;         /*!< @brief is used to hold the update rate at Hz level */
+            uint64_t                        stepCount;          /*!< @brief is used to hold the longest trajectory's sample count */
+            uint64_t                        currentStep;        /*!< @brief is used to hold the last played sample index */
+            uint64_t                        writeErrorCount;    /*!< @brief is used to hold the failed pwm write count */
+            bool                            isLooping;          /*!< @brief is used to hold the looping mode of playback */
+            pthread_mutex_t                 progressMutex;      /*!< @brief is used to protect the current step and the error count while they are read from another thread */
+
+            /*! @brief Converts duty percentage to space time by using period value of pwm.
+            *
+            *  @return space time at nanosecond level.
+            */
+            uint64_t                        percentToSpaceTime(int64_t period, float percentage);
+
+            /*! @brief Calculates the longest trajectory's sample count.
+            */
+            void                            updateStepCount();
+
+            /*! @brief Writes one sample of all channels to pwm outputs.
+            *
+            *  This function calls from timer thread at every tick. Users should not call this function
+            *  directly.
+            *  @return false if all trajectories are finished and looping mode is disabled, else true.
+            */
+            bool                            onTickHandler(uint64_t tick);
+
+
+        public:
+
+            /*! @brief Constructor of BlackPWMSequencer class.
+            *
+            * @param [in] rate          update rate at Hz level
+            */
+                                            BlackPWMSequencer(uint32_t rate);
+
+            /*! @brief Destructor of BlackPWMSequencer class.
+            *
+            */
+            virtual                         ~BlackPWMSequencer();
+
+            /*! @brief Adds pwm output to sequencer as a channel.
+            *
+            * @param [in] pwm           pointer of BlackPWM object
+            * @return index of new channel if adding is successful, else -1.
+            */
+            int                             addChannel(BlackPWM *pwm);
+
+            /*! @brief Loads ramp trajectory to channel.
+            *
+            * This function reads the period value of pwm once and calculates all space time values
+            * of ramp. Sample count is equal to (duration * update rate) + 1, so first sample is the
+            * start value and the last sample is the end value exactly.
+            *
+            * @param [in] channel       channel index
+            * @param [in] fromPercent   start duty percentage
+            * @param [in] toPercent     end duty percentage
+            * @param [in] duration      ramp duration
+            * @param [in] tType         time type of duration (enum)
+            * @param [in] profile       ramp profile (enum)
+            * @return true if trajectory is calculated successfully, else false.
+            *
+            * @sa rampProfile
+            */
+            bool                            setRamp(unsigned int channel, float fromPercent, float toPercent,
+                                                    uint64_t duration, timeType tType = milisecond,
+                                                    rampProfile profile = LinearRamp);
+
+            /*! @brief Loads sample table to channel.
+            *
+            * Every element of the table is played at one tick.
+            *
+            * @param [in] channel       channel index
+            * @param [in] percentages   duty percentage samples
+            * @return true if trajectory is calculated successfully, else false.
+            */
+            bool                            setTable(unsigned int channel, const std::vector<float> &percentages);
+
+            /*! @brief Removes trajectory of channel.
+            *
+            * @param [in] channel       channel index
+            */
+            void                            clearChannel(unsigned int channel);
+
+            /*! @brief Changes looping mode of playback.
+            *
+            * If looping mode is enabled, the playback restarts from the first sample after the last sample.
+            *
+            * @param [in] loop          new looping mode
+            */
+            void                            setLooping(bool loop);
+
+            /*! @brief Changes update rate of sequencer.
+            *
+            * Ramp trajectories are calculated with the update rate, so they must be loaded again after
+            * this function call.
+            *
+            * @param [in] rate          update rate at Hz level
+            * @return true if rate is valid and sequencer is not running, else false.
+            */
+            bool                            setUpdateRate(uint32_t rate);
+
+            /*! @brief Exports update rate of sequencer.
+            *
+            * @return update rate at Hz level.
+            */
+            uint32_t                        getUpdateRate();
+
+            /*! @brief Exports sample count of the longest trajectory.
+            *
+            * @return sample count.
+            */
+            uint64_t                        getStepCount();
+
+            /*! @brief Exports index of the last played sample.
+            *
+            * @return sample index.
+            */
+            uint64_t                        getCurrentStep();
+
+            /*! @brief Exports count of failed pwm writes.
+            *
+            * @return failed write count.
+            */
+            uint64_t                        getWriteErrorCount();
+    };
+    // ######################################## BLACKPWMSEQUENCER DECLARATION ENDS ######################################### //
+
+
+
+} /* namespace BlackLib */
+
+#endif /* BLACKPWMSEQUENCER_H_ */
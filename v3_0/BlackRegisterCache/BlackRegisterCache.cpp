@@ -0,0 +1,490 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackRegisterCache.h"
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackI2CRegisterBus::BlackI2CRegisterBus(BlackI2C *i2c)
+    {
+        this->i2cObject = i2c;
+        this->writeBuffer.resize(33);
+    }
+
+    bool        BlackI2CRegisterBus::readRegisters(uint32_t address, uint8_t *buffer, size_t size)
+    {
+        if( size > I2C_MAX_MESSAGE_LENGTH ) { return false; }
+
+        this->registerAddress = static_cast<uint8_t>(address);
+
+        this->transaction.clear();
+        this->transaction.addWrite(&(this->registerAddress), 1);
+        this->transaction.addRead(buffer, static_cast<uint16_t>(size));
+
+        return this->i2cObject->transfer(this->transaction);
+    }
+
+    bool        BlackI2CRegisterBus::writeRegisters(uint32_t address, const uint8_t *buffer, size_t size)
+    {
+        if( this->writeBuffer.size() < size + 1 )
+        {
+            this->writeBuffer.resize(size + 1);
+        }
+
+        this->writeBuffer[0] = static_cast<uint8_t>(address);
+        memcpy( &(this->writeBuffer[1]), buffer, size);
+
+        return this->i2cObject->writeLine( &(this->writeBuffer[0]), size + 1);
+    }
+
+
+
+
+
+
+
+
+
+    BlackSPIRegisterBus::BlackSPIRegisterBus(BlackSPI *spi, uint8_t readBit, uint8_t writeBit, uint8_t multiBit)
+    {
+        this->spiObject = spi;
+        this->readFlag  = readBit;
+        this->writeFlag = writeBit;
+        this->multiFlag = multiBit;
+        this->command   = 0;
+    }
+
+    bool        BlackSPIRegisterBus::readRegisters(uint32_t address, uint8_t *buffer, size_t size)
+    {
+        this->command = static_cast<uint8_t>(address) | this->readFlag | ((size > 1) ? this->multiFlag : 0);
+
+        this->transaction.clear();
+        this->transaction.addSegment(&(this->command), NULL, 1);
+        this->transaction.addSegment(NULL, buffer, size);
+
+        return this->spiObject->transfer(this->transaction);
+    }
+
+    bool        BlackSPIRegisterBus::writeRegisters(uint32_t address, const uint8_t *buffer, size_t size)
+    {
+        this->command = static_cast<uint8_t>(address) | this->writeFlag | ((size > 1) ? this->multiFlag : 0);
+
+        this->transaction.clear();
+        this->transaction.addSegment(&(this->command), NULL, 1);
+        this->transaction.addSegment(buffer, NULL, size);
+
+        return this->spiObject->transfer(this->transaction);
+    }
+
+
+
+
+
+
+
+
+
+    BlackRegisterCache::BlackRegisterCache(BlackRegisterBus *registerBus, uint32_t maxRegister, uint8_t width,
+                                           uint8_t stride, bool bigEndian)
+    {
+        this->bus           = registerBus;
+        this->valueWidth    = (width == 2 or width == 4) ? width : 1;
+        this->addressStride = (stride == 0) ? 1 : stride;
+        this->isBigEndian   = bigEndian;
+        this->writeMode     = WriteBack;
+        this->dirtyCount    = 0;
+
+        cacheEntry empty;
+        empty.value         = 0;
+        empty.isVolatile    = false;
+        empty.isValid       = false;
+        empty.isDirty       = false;
+
+        this->entries.assign( maxRegister / this->addressStride + 1, empty );
+        this->setMaxBulkSize(32);
+    }
+
+    BlackRegisterCache::~BlackRegisterCache()
+    {
+    }
+
+    size_t      BlackRegisterCache::toIndex(uint32_t address)
+    {
+        if( address % this->addressStride != 0 )
+        {
+            return this->entries.size();
+        }
+
+        size_t index = address / this->addressStride;
+        return ( (index < this->entries.size()) ? index : this->entries.size() );
+    }
+
+    void        BlackRegisterCache::encode(uint32_t value, uint8_t *raw)
+    {
+        for( uint8_t i = 0 ; i < this->valueWidth ; i++ )
+        {
+            uint8_t shift = this->isBigEndian ? (8 * (this->valueWidth - 1 - i)) : (8 * i);
+            raw[i] = static_cast<uint8_t>(value >> shift);
+        }
+    }
+
+    uint32_t    BlackRegisterCache::decode(const uint8_t *raw)
+    {
+        uint32_t value = 0;
+
+        for( uint8_t i = 0 ; i < this->valueWidth ; i++ )
+        {
+            uint8_t shift = this->isBigEndian ? (8 * (this->valueWidth - 1 - i)) : (8 * i);
+            value |= static_cast<uint32_t>(raw[i]) << shift;
+        }
+
+        return value;
+    }
+
+    void        BlackRegisterCache::describe(const BlackRegisterDescription *descriptions, size_t count)
+    {
+        for( size_t i = 0 ; i < count ; i++ )
+        {
+            size_t index = this->toIndex(descriptions[i].address);
+
+            if( index == this->entries.size() )
+            {
+                continue;
+            }
+
+            cacheEntry &entry   = this->entries[index];
+            entry.isVolatile    = (descriptions[i].type == VolatileRegister);
+
+            if( entry.isDirty )
+            {
+                --(this->dirtyCount);
+                entry.isDirty   = false;
+            }
+
+            entry.isValid       = (not entry.isVolatile) and descriptions[i].hasDefault;
+            entry.value         = descriptions[i].defaultValue;
+        }
+    }
+
+    void        BlackRegisterCache::describeRange(uint32_t firstAddress, uint32_t lastAddress, registerType type)
+    {
+        for( uint32_t address = firstAddress ; address <= lastAddress ; address += this->addressStride )
+        {
+            size_t index = this->toIndex(address);
+
+            if( index == this->entries.size() )
+            {
+                break;
+            }
+
+            cacheEntry &entry   = this->entries[index];
+            entry.isVolatile    = (type == VolatileRegister);
+
+            if( entry.isVolatile )
+            {
+                if( entry.isDirty )
+                {
+                    --(this->dirtyCount);
+                }
+
+                entry.isValid   = false;
+                entry.isDirty   = false;
+            }
+        }
+    }
+
+    bool        BlackRegisterCache::setWriteMode(registerWriteMode mode)
+    {
+        if( mode == WriteThrough and not this->sync() )
+        {
+            return false;
+        }
+
+        this->writeMode = mode;
+        return true;
+    }
+
+    registerWriteMode BlackRegisterCache::getWriteMode()
+    {
+        return this->writeMode;
+    }
+
+    void        BlackRegisterCache::setMaxBulkSize(size_t size)
+    {
+        this->maxBulkSize = (size < this->valueWidth) ? this->valueWidth : size;
+        this->transferBuffer.resize(this->maxBulkSize);
+    }
+
+    bool        BlackRegisterCache::read(uint32_t address, uint32_t &value)
+    {
+        size_t index = this->toIndex(address);
+
+        if( index == this->entries.size() )
+        {
+            return false;
+        }
+
+        cacheEntry &entry = this->entries[index];
+
+        if( entry.isValid )
+        {
+            ++(entry.statistics.hitCount);
+            value = entry.value;
+            return true;
+        }
+
+        ++(entry.statistics.missCount);
+
+        uint8_t raw[4];
+        if( not this->bus->readRegisters(address, raw, this->valueWidth) )
+        {
+            return false;
+        }
+
+        value = this->decode(raw);
+
+        if( not entry.isVolatile )
+        {
+            entry.value     = value;
+            entry.isValid   = true;
+        }
+
+        return true;
+    }
+
+    bool        BlackRegisterCache::write(uint32_t address, uint32_t value)
+    {
+        size_t index = this->toIndex(address);
+
+        if( index == this->entries.size() )
+        {
+            return false;
+        }
+
+        cacheEntry &entry = this->entries[index];
+
+        if( entry.isValid and entry.value == value )
+        {
+            ++(entry.statistics.skippedWriteCount);
+            return true;
+        }
+
+        if( this->writeMode == WriteBack and not entry.isVolatile )
+        {
+            entry.value     = value;
+            entry.isValid   = true;
+
+            if( not entry.isDirty )
+            {
+                entry.isDirty = true;
+                ++(this->dirtyCount);
+            }
+
+            return true;
+        }
+
+        uint8_t raw[4];
+        this->encode(value, raw);
+
+        if( not this->bus->writeRegisters(address, raw, this->valueWidth) )
+        {
+            return false;
+        }
+
+        ++(entry.statistics.busWriteCount);
+
+        if( not entry.isVolatile )
+        {
+            entry.value     = value;
+            entry.isValid   = true;
+        }
+
+        return true;
+    }
+
+    bool        BlackRegisterCache::update(uint32_t address, uint32_t mask, uint32_t value)
+    {
+        uint32_t oldValue;
+
+        if( not this->read(address, oldValue) )
+        {
+            return false;
+        }
+
+        return this->write(address, (oldValue & ~mask) | (value & mask));
+    }
+
+    bool        BlackRegisterCache::readRaw(uint32_t address, uint8_t *buffer, size_t size)
+    {
+        return this->bus->readRegisters(address, buffer, size);
+    }
+
+    bool        BlackRegisterCache::writeRun(size_t firstIndex, size_t count)
+    {
+        for( size_t i = 0 ; i < count ; i++ )
+        {
+            this->encode( this->entries[firstIndex + i].value, &(this->transferBuffer[i * this->valueWidth]) );
+        }
+
+        uint32_t address = static_cast<uint32_t>(firstIndex * this->addressStride);
+
+        if( not this->bus->writeRegisters(address, &(this->transferBuffer[0]), count * this->valueWidth) )
+        {
+            return false;
+        }
+
+        for( size_t i = 0 ; i < count ; i++ )
+        {
+            cacheEntry &entry = this->entries[firstIndex + i];
+            entry.isDirty = false;
+            ++(entry.statistics.busWriteCount);
+        }
+
+        this->dirtyCount -= count;
+        return true;
+    }
+
+    bool        BlackRegisterCache::sync()
+    {
+        bool isAllWritten   = true;
+        size_t maxCount     = this->maxBulkSize / this->valueWidth;
+        size_t index        = 0;
+
+        // neighbour values are neighbour bytes on bus only if registers are packed without gaps
+        if( this->addressStride != this->valueWidth )
+        {
+            maxCount = 1;
+        }
+
+        while( this->dirtyCount > 0 and index < this->entries.size() )
+        {
+            if( not this->entries[index].isDirty )
+            {
+                ++index;
+                continue;
+            }
+
+            size_t count = 1;
+            while( index + count < this->entries.size() and
+                   this->entries[index + count].isDirty and
+                   count < maxCount )
+            {
+                ++count;
+            }
+
+            if( not this->writeRun(index, count) )
+            {
+                isAllWritten = false;
+            }
+
+            index += count;
+        }
+
+        return isAllWritten;
+    }
+
+    uint32_t    BlackRegisterCache::getDirtyCount()
+    {
+        return this->dirtyCount;
+    }
+
+    void        BlackRegisterCache::invalidate()
+    {
+        for( size_t i = 0 ; i < this->entries.size() ; i++ )
+        {
+            this->entries[i].isValid = false;
+            this->entries[i].isDirty = false;
+        }
+
+        this->dirtyCount = 0;
+    }
+
+    void        BlackRegisterCache::invalidate(uint32_t address)
+    {
+        size_t index = this->toIndex(address);
+
+        if( index == this->entries.size() )
+        {
+            return;
+        }
+
+        if( this->entries[index].isDirty )
+        {
+            --(this->dirtyCount);
+        }
+
+        this->entries[index].isValid = false;
+        this->entries[index].isDirty = false;
+    }
+
+    BlackRegisterStatistics BlackRegisterCache::getStatistics(uint32_t address)
+    {
+        size_t index = this->toIndex(address);
+
+        if( index == this->entries.size() )
+        {
+            return BlackRegisterStatistics();
+        }
+
+        return this->entries[index].statistics;
+    }
+
+    BlackRegisterStatistics BlackRegisterCache::getTotalStatistics()
+    {
+        BlackRegisterStatistics total;
+
+        for( size_t i = 0 ; i < this->entries.size() ; i++ )
+        {
+            total.hitCount          += this->entries[i].statistics.hitCount;
+            total.missCount         += this->entries[i].statistics.missCount;
+            total.busWriteCount     += this->entries[i].statistics.busWriteCount;
+            total.skippedWriteCount += this->entries[i].statistics.skippedWriteCount;
+        }
+
+        return total;
+    }
+
+    void        BlackRegisterCache::resetStatistics()
+    {
+        for( size_t i = 0 ; i < this->entries.size() ; i++ )
+        {
+            this->entries[i].statistics = BlackRegisterStatistics();
+        }
+    }
+
+
+
+} /* namespace BlackLib */
@@ -0,0 +1,506 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKREGISTERCACHE_H_
+#define BLACKREGISTERCACHE_H_
+
+#include "../BlackI2C/BlackI2C.h"
+#include "../BlackSPI/BlackSPI.h"
+
+#include <cstdint>
+#include <vector>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for describing cache behaviour of a register.
+    */
+    enum registerType       {   CacheableRegister       = 0,    /*!< value changes only with writes, so it is cached */
+                                VolatileRegister        = 1     /*!< value is changed by device (status, data, fifo), so it is never cached */
+                            };
+
+    /*!
+    * This enum is used for selecting write behaviour of BlackRegisterCache.
+    */
+    enum registerWriteMode  {   WriteThrough            = 0,    /*!< writes are sent immediately, cache is updated */
+                                WriteBack               = 1     /*!< writes are kept at cache until sync() function is called */
+                            };
+
+
+
+
+    // ################################### BLACKREGISTERDESCRIPTION DECLARATION STARTS ################################### //
+
+    /*! @brief Describes one register of a device.
+    *
+    *    Registers which are not described are cacheable and their values are unknown until they are read.
+    */
+    struct BlackRegisterDescription
+    {
+        uint32_t        address;            /*!< @brief is used to hold the register address */
+        registerType    type;               /*!< @brief is used to hold the cache behaviour of register */
+        bool            hasDefault;         /*!< @brief is used to hold whether the reset value is known */
+        uint32_t        defaultValue;       /*!< @brief is used to hold the reset value of register */
+
+        /*! @brief Default constructor of BlackRegisterDescription struct.
+         *
+         *  This function sets default value to variables.
+         */
+        BlackRegisterDescription()
+        {
+            address         = 0;
+            type            = CacheableRegister;
+            hasDefault      = false;
+            defaultValue    = 0;
+        }
+
+        /*! @brief Overloaded constructor of BlackRegisterDescription struct.
+         *
+         *  This function sets entered parameters to variables.
+         */
+        BlackRegisterDescription(uint32_t addr, registerType regType)
+        {
+            address         = addr;
+            type            = regType;
+            hasDefault      = false;
+            defaultValue    = 0;
+        }
+
+        /*! @brief Overloaded constructor of BlackRegisterDescription struct.
+         *
+         *  This function sets entered parameters to variables and marks the reset value as known.
+         */
+        BlackRegisterDescription(uint32_t addr, registerType regType, uint32_t resetValue)
+        {
+            address         = addr;
+            type            = regType;
+            hasDefault      = true;
+            defaultValue    = resetValue;
+        }
+    };
+    // #################################### BLACKREGISTERDESCRIPTION DECLARATION ENDS #################################### //
+
+
+
+
+
+    // ##################################### BLACKREGISTERSTATISTICS DECLARATION STARTS ##################################### //
+
+    /*! @brief Holds access counters of a register or a whole register cache.
+    */
+    struct BlackRegisterStatistics
+    {
+        uint64_t    hitCount;               /*!< @brief is used to hold the number of reads which are answered from cache */
+        uint64_t    missCount;              /*!< @brief is used to hold the number of reads which are sent to device */
+        uint64_t    busWriteCount;          /*!< @brief is used to hold the number of register values which are sent to device */
+        uint64_t    skippedWriteCount;      /*!< @brief is used to hold the number of writes which are skipped because value is same */
+
+        /*! @brief Default constructor of BlackRegisterStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackRegisterStatistics()
+        {
+            hitCount            = 0;
+            missCount           = 0;
+            busWriteCount       = 0;
+            skippedWriteCount   = 0;
+        }
+    };
+    // ###################################### BLACKREGISTERSTATISTICS DECLARATION ENDS ###################################### //
+
+
+
+
+
+
+
+
+
+
+    // ######################################## BLACKREGISTERBUS DECLARATION STARTS ######################################### //
+
+    /*! @brief Interface class of buses which are used by BlackRegisterCache.
+     *
+     *    Implementations transfer raw bytes of consecutive registers, starting from a register address.
+     *    Devices must increase register address automatically at multi-byte accesses.
+     */
+    class BlackRegisterBus
+    {
+        public:
+            /*! @brief Destructor of BlackRegisterBus class.
+            */
+            virtual         ~BlackRegisterBus() {}
+
+            /*! @brief Reads consecutive register bytes.
+            *
+            * @param [in] address           first register address
+            * @param [out] buffer           destination buffer
+            * @param [in] size              byte count
+            * @return true if reading successful, else false.
+            */
+            virtual bool    readRegisters(uint32_t address, uint8_t *buffer, size_t size) = 0;
+
+            /*! @brief Writes consecutive register bytes.
+            *
+            * @param [in] address           first register address
+            * @param [in] buffer            source buffer
+            * @param [in] size              byte count
+            * @return true if writing successful, else false.
+            */
+            virtual bool    writeRegisters(uint32_t address, const uint8_t *buffer, size_t size) = 0;
+    };
+    // ######################################### BLACKREGISTERBUS DECLARATION ENDS ########################################## //
+
+
+
+
+
+    // ####################################### BLACKI2CREGISTERBUS DECLARATION STARTS ####################################### //
+
+    /*! @brief Register bus implementation of i2c devices which have 8 bit register addresses.
+     *
+     *    Register address and data are written in one i2c message. Reading writes register address,
+     *    then reads data block after a repeated start, in one I2C_RDWR request.
+     */
+    class BlackI2CRegisterBus : public BlackRegisterBus
+    {
+        private:
+            BlackI2C               *i2cObject;              /*!< @brief is used to hold the opened i2c device */
+            std::vector<uint8_t>    writeBuffer;            /*!< @brief is used to hold the register address and data of write message */
+            uint8_t                 registerAddress;        /*!< @brief is used to hold the register address of current read */
+            BlackI2CTransaction     transaction;            /*!< @brief is used to hold the address and data messages of read */
+
+        public:
+            /*! @brief Constructor of BlackI2CRegisterBus class.
+            *
+            * @param [in] i2c               opened i2c device
+            */
+                            BlackI2CRegisterBus(BlackI2C *i2c);
+
+            bool            readRegisters(uint32_t address, uint8_t *buffer, size_t size);
+            bool            writeRegisters(uint32_t address, const uint8_t *buffer, size_t size);
+    };
+    // ######################################## BLACKI2CREGISTERBUS DECLARATION ENDS ######################################## //
+
+
+
+
+
+    // ####################################### BLACKSPIREGISTERBUS DECLARATION STARTS ####################################### //
+
+    /*! @brief Register bus implementation of spi devices which have one command byte.
+     *
+     *    Command byte is composed of 8 bit register address and read, write and multi-byte flags. Most of
+     *    sensors use 0x80 as read flag and some of them (ADXL345, LIS3DH) use 0x40 as multi-byte flag.
+     *    Command and data are sent with one spi message, so chip select stays active between them.
+     */
+    class BlackSPIRegisterBus : public BlackRegisterBus
+    {
+        private:
+            BlackSPI               *spiObject;              /*!< @brief is used to hold the opened spi device */
+            uint8_t                 readFlag;               /*!< @brief is used to hold the read flag of command byte */
+            uint8_t                 writeFlag;              /*!< @brief is used to hold the write flag of command byte */
+            uint8_t                 multiFlag;              /*!< @brief is used to hold the multi-byte flag of command byte */
+            uint8_t                 command;                /*!< @brief is used to hold the command byte of current transfer */
+            BlackSPITransaction     transaction;            /*!< @brief is used to hold the command and data segments */
+
+        public:
+            /*! @brief Constructor of BlackSPIRegisterBus class.
+            *
+            * @param [in] spi               opened spi device
+            * @param [in] readBit           read flag of command byte
+            * @param [in] writeBit          write flag of command byte
+            * @param [in] multiBit          flag which is added if more than one byte is transferred
+            */
+                            BlackSPIRegisterBus(BlackSPI *spi, uint8_t readBit = 0x80, uint8_t writeBit = 0x00, uint8_t multiBit = 0x00);
+
+            bool            readRegisters(uint32_t address, uint8_t *buffer, size_t size);
+            bool            writeRegisters(uint32_t address, const uint8_t *buffer, size_t size);
+    };
+    // ######################################## BLACKSPIREGISTERBUS DECLARATION ENDS ######################################## //
+
+
+
+
+
+
+
+
+
+
+    // ####################################### BLACKREGISTERCACHE DECLARATION STARTS ######################################## //
+
+    /*! @brief Caches registers of a device which is accessed over i2c or spi.
+     *
+     *    This class keeps the last known value of every cacheable register, so reads of configuration
+     *    registers and read-modify-write cycles don't need bus round trips. Registers which are changed by
+     *    the device (status, data, fifo) are described as volatile and they are always accessed on bus.
+     *
+     *    Register width can be 1, 2 or 4 bytes and register addresses are multiples of address stride.
+     *    Multi-byte registers are transferred in big or little endian order.
+     *
+     *    At write-back mode, writes to cacheable registers only change the cache and mark the register as
+     *    dirty; writes which don't change the cached value are skipped. sync() function sends every run of
+     *    contiguous dirty registers with one bus transaction, if address stride equals register width.
+     *    Otherwise every dirty register is sent alone. At write-through mode, writes are sent at once but
+     *    unchanged values are still skipped.
+     *
+     *    Hit, miss and write counters are kept for every register.
+     *
+     *    @warning This class is not thread safe.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myRegisterCacheProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackRegisterCache/BlackRegisterCache.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackI2C              myI2c(BlackLib::I2C_1, 0x53);       // ADXL345
+     *      myI2c.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+     *
+     *      BlackLib::BlackI2CRegisterBus   bus(&myI2c);
+     *      BlackLib::BlackRegisterCache    regs(&bus, 0x39, 1);
+     *
+     *      BlackLib::BlackRegisterDescription desc[] = {
+     *          BlackLib::BlackRegisterDescription(0x2C, BlackLib::CacheableRegister, 0x0A),   // BW_RATE
+     *          BlackLib::BlackRegisterDescription(0x2D, BlackLib::CacheableRegister, 0x00),   // POWER_CTL
+     *          BlackLib::BlackRegisterDescription(0x30, BlackLib::VolatileRegister),          // INT_SOURCE
+     *          BlackLib::BlackRegisterDescription(0x32, BlackLib::VolatileRegister)           // DATAX0
+     *      };
+     *      regs.describe(desc, 4);
+     *      regs.describeRange(0x33, 0x37, BlackLib::VolatileRegister);                        // DATAX1 - DATAZ1
+     *
+     *      regs.update(0x2C, 0x0F, 0x0D);          // no bus read, reset value is known
+     *      regs.update(0x2D, 0x08, 0x08);
+     *      regs.sync();                            // 0x2C and 0x2D are written with one message
+     *
+     *      uint8_t raw[6];
+     *      regs.readRaw(0x32, raw, 6);             // volatile data registers
+     *
+     *      std::cout << "POWER_CTL hits: " << regs.getStatistics(0x2D).hitCount << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackRegisterCache
+    {
+        private:
+
+            /*! @brief Holds cache state of one register.
+            */
+            struct cacheEntry
+            {
+                uint32_t                value;          /*!< @brief is used to hold the cached value */
+                bool                    isVolatile;     /*!< @brief is used to hold the volatile state */
+                bool                    isValid;        /*!< @brief is used to hold the validity of cached value */
+                bool                    isDirty;        /*!< @brief is used to hold the unsynchronized state of cached value */
+                BlackRegisterStatistics statistics;     /*!< @brief is used to hold the access counters */
+            };
+
+            BlackRegisterBus           *bus;            /*!< @brief is used to hold the register bus */
+            std::vector<cacheEntry>     entries;        /*!< @brief is used to hold the cache state of registers */
+            std::vector<uint8_t>        transferBuffer; /*!< @brief is used to hold the raw bytes of bulk transfers */
+            uint8_t                     valueWidth;     /*!< @brief is used to hold the byte count of registers */
+            uint8_t                     addressStride;  /*!< @brief is used to hold the address distance between registers */
+            bool                        isBigEndian;    /*!< @brief is used to hold the byte order of multi-byte registers */
+            registerWriteMode           writeMode;      /*!< @brief is used to hold the write behaviour */
+            size_t                      maxBulkSize;    /*!< @brief is used to hold the byte limit of one bus transaction */
+            uint32_t                    dirtyCount;     /*!< @brief is used to hold the number of dirty registers */
+
+            /*! @brief Converts register address to entry index.
+            *
+            * @return entry index, or entry count if address is not valid.
+            */
+            size_t                      toIndex(uint32_t address);
+
+            /*! @brief Converts value to raw bytes at selected byte order.
+            */
+            void                        encode(uint32_t value, uint8_t *raw);
+
+            /*! @brief Converts raw bytes to value at selected byte order.
+            */
+            uint32_t                    decode(const uint8_t *raw);
+
+            /*! @brief Writes a run of registers from cache to device.
+            */
+            bool                        writeRun(size_t firstIndex, size_t count);
+
+        public:
+
+            /*! @brief Constructor of BlackRegisterCache class.
+            *
+            * This function allocates cache entries of all registers. All registers are cacheable and
+            * invalid at start. Write mode is write-back.
+            *
+            * @param [in] registerBus       bus which is used for device accesses
+            * @param [in] maxRegister       address of last register
+            * @param [in] width             byte count of registers (1, 2 or 4)
+            * @param [in] stride            address distance between registers
+            * @param [in] bigEndian         byte order of multi-byte registers
+            */
+                                        BlackRegisterCache(BlackRegisterBus *registerBus, uint32_t maxRegister, uint8_t width = 1,
+                                                           uint8_t stride = 1, bool bigEndian = true);
+
+            /*! @brief Destructor of BlackRegisterCache class.
+            *
+            * Dirty registers are not written, sync() function must be called before.
+            */
+            virtual                     ~BlackRegisterCache();
+
+            /*! @brief Applies register descriptions.
+            *
+            * Registers which have a known reset value become valid at cache.
+            *
+            * @param [in] descriptions      description array
+            * @param [in] count             item count of description array
+            */
+            void                        describe(const BlackRegisterDescription *descriptions, size_t count);
+
+            /*! @brief Sets cache behaviour of a register range.
+            *
+            * @param [in] firstAddress      first register address
+            * @param [in] lastAddress       last register address
+            * @param [in] type              cache behaviour (enum)
+            */
+            void                        describeRange(uint32_t firstAddress, uint32_t lastAddress, registerType type);
+
+            /*! @brief Changes write behaviour.
+            *
+            * Dirty registers are synchronized before changing to write-through mode.
+            *
+            * @param [in] mode              new write behaviour (enum)
+            * @return false if synchronization fails, else true.
+            */
+            bool                        setWriteMode(registerWriteMode mode);
+
+            /*! @brief Exports write behaviour.
+            */
+            registerWriteMode           getWriteMode();
+
+            /*! @brief Changes byte limit of one bus transaction.
+            *
+            * Longer runs are split. Default value is 32 bytes, which is safe for most of devices.
+            */
+            void                        setMaxBulkSize(size_t size);
+
+            /*! @brief Reads a register.
+            *
+            * Valid cacheable registers are answered from cache. Others are read from device and
+            * cacheable ones are stored.
+            *
+            * @param [in] address           register address
+            * @param [out] value            register value
+            * @return true if reading successful, else false.
+            */
+            bool                        read(uint32_t address, uint32_t &value);
+
+            /*! @brief Writes a register.
+            *
+            * @param [in] address           register address
+            * @param [in] value             new register value
+            * @return true if writing successful, else false.
+            */
+            bool                        write(uint32_t address, uint32_t value);
+
+            /*! @brief Changes selected bits of a register.
+            *
+            * This function reads the register (from cache if possible), changes masked bits and writes
+            * the new value only if it is different.
+            *
+            * @param [in] address           register address
+            * @param [in] mask              bits which will be changed
+            * @param [in] value             new values of masked bits
+            * @return true if operation successful, else false.
+            */
+            bool                        update(uint32_t address, uint32_t mask, uint32_t value);
+
+            /*! @brief Reads consecutive registers with one bus transaction.
+            *
+            * Raw bytes are not cached, so this function is suitable for volatile data registers.
+            *
+            * @param [in] address           first register address
+            * @param [out] buffer           destination buffer
+            * @param [in] size              byte count
+            * @return true if reading successful, else false.
+            */
+            bool                        readRaw(uint32_t address, uint8_t *buffer, size_t size);
+
+            /*! @brief Writes all dirty registers to device.
+            *
+            * Every run of contiguous dirty registers is written with one bus transaction, if address stride
+            * equals register width. Otherwise registers aren't packed on bus, so every dirty register is
+            * written with its own transaction.
+            *
+            * @return true if all registers are written, else false.
+            */
+            bool                        sync();
+
+            /*! @brief Exports the number of dirty registers.
+            */
+            uint32_t                    getDirtyCount();
+
+            /*! @brief Forgets all cached values.
+            *
+            * Dirty values are lost. This function should be called after device reset.
+            */
+            void                        invalidate();
+
+            /*! @brief Forgets cached value of a register.
+            */
+            void                        invalidate(uint32_t address);
+
+            /*! @brief Exports counters of a register.
+            */
+            BlackRegisterStatistics     getStatistics(uint32_t address);
+
+            /*! @brief Exports sum of counters of all registers.
+            */
+            BlackRegisterStatistics     getTotalStatistics();
+
+            /*! @brief Clears counters of all registers.
+            */
+            void                        resetStatistics();
+    };
+    // ######################################## BLACKREGISTERCACHE DECLARATION ENDS ######################################### //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKREGISTERCACHE_H_ */
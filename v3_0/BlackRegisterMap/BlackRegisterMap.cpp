@@ -0,0 +1,129 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackRegisterMap.h"
+
+
+namespace BlackLib
+{
+
+    // ######################################## BLACKREGISTERMAP DEFINITION STARTS ######################################### //
+
+    BlackRegisterMap::BlackRegisterMap()
+    {
+        this->mapFD         = -1;
+        this->mapBase       = MAP_FAILED;
+        this->mapSize       = 0;
+        this->registerBase  = NULL;
+    }
+
+    BlackRegisterMap::BlackRegisterMap(const std::string &filePath, off_t offset, size_t size)
+    {
+        this->mapFD         = -1;
+        this->mapBase       = MAP_FAILED;
+        this->mapSize       = 0;
+        this->registerBase  = NULL;
+
+        this->open(filePath, offset, size);
+    }
+
+    BlackRegisterMap::~BlackRegisterMap()
+    {
+        this->close();
+    }
+
+    bool        BlackRegisterMap::open(const std::string &filePath, off_t offset, size_t size)
+    {
+        this->close();
+
+        this->mapFD = ::open(filePath.c_str(), O_RDWR | O_SYNC);
+        if( this->mapFD < 0 )
+        {
+            return false;
+        }
+
+        off_t pageSize      = sysconf(_SC_PAGESIZE);
+        off_t pageOffset    = offset & ~(pageSize - 1);
+        size_t inPageOffset = static_cast<size_t>(offset - pageOffset);
+
+        this->mapSize = ((inPageOffset + size + pageSize - 1) / pageSize) * pageSize;
+
+        // pages beyond the end of a regular file raise bus error at access, so short images are rejected
+        struct stat fileStatus;
+        if( fstat(this->mapFD, &fileStatus) != 0 or
+            (S_ISREG(fileStatus.st_mode) and fileStatus.st_size < offset + static_cast<off_t>(size)) )
+        {
+            ::close(this->mapFD);
+            this->mapFD     = -1;
+            this->mapSize   = 0;
+            return false;
+        }
+
+        this->mapBase = mmap(NULL, this->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->mapFD, pageOffset);
+
+        if( this->mapBase == MAP_FAILED )
+        {
+            ::close(this->mapFD);
+            this->mapFD     = -1;
+            this->mapSize   = 0;
+            return false;
+        }
+
+        this->registerBase = static_cast<volatile uint8_t *>(this->mapBase) + inPageOffset;
+        return true;
+    }
+
+    void        BlackRegisterMap::close()
+    {
+        if( this->mapBase != MAP_FAILED )
+        {
+            munmap(this->mapBase, this->mapSize);
+            this->mapBase = MAP_FAILED;
+        }
+
+        if( this->mapFD >= 0 )
+        {
+            ::close(this->mapFD);
+            this->mapFD = -1;
+        }
+
+        this->mapSize       = 0;
+        this->registerBase  = NULL;
+    }
+
+    bool        BlackRegisterMap::isOpen() const
+    {
+        return ( this->registerBase != NULL );
+    }
+
+    // ######################################### BLACKREGISTERMAP DEFINITION ENDS ########################################## //
+
+} /* namespace BlackLib */
@@ -0,0 +1,167 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKREGISTERMAP_H_
+#define BLACKREGISTERMAP_H_
+
+#include <string>
+#include <cstdint>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+
+
+namespace BlackLib
+{
+
+    const std::string       DEV_MEM_PATH                = "/dev/mem";               //!< Physical memory device path
+    const off_t             PWMSS0_BASE_ADDRESS         = 0x48300000;               //!< Physical address of pwm subsystem 0
+    const off_t             PWMSS1_BASE_ADDRESS         = 0x48302000;               //!< Physical address of pwm subsystem 1
+    const off_t             PWMSS2_BASE_ADDRESS         = 0x48304000;               //!< Physical address of pwm subsystem 2
+    const size_t            PWMSS_MAP_SIZE              = 0x1000;                   //!< Size of pwm subsystem register area
+    const uint32_t          PWMSS_CLKCONFIG_OFFSET      = 0x08;                     //!< Offset of pwm subsystem clock config register
+
+
+
+
+    // ####################################### BLACKREGISTERMAP DECLARATION STARTS ######################################### //
+
+    /*! @brief Maps a register area to memory.
+     *
+     *    This class maps a part of a file to memory and gives volatile 16 and 32 bit access to it. The file
+     *    is generally @b "/dev/mem" and the offset is physical address of a peripheral. But any regular file
+     *    can be mapped also, so register images can be used instead of real hardware.
+     *
+     *    Offset is rounded down to page boundary before mapping, so the register offsets which are used at
+     *    read and write functions are always relative to the entered offset.
+     *
+     *    @warning Accessing registers of a module whose clock is disabled causes bus error.
+     */
+    class BlackRegisterMap
+    {
+        private:
+            int             mapFD;                      /*!< @brief is used to hold the mapped file's file descriptor */
+            void            *mapBase;                   /*!< @brief is used to hold the page aligned start of mapping */
+            size_t          mapSize;                    /*!< @brief is used to hold the page aligned size of mapping */
+            volatile uint8_t *registerBase;             /*!< @brief is used to hold the start of register area */
+
+            /*! @brief Copying is disabled, because copies would unmap the same area twice.
+            */
+                            BlackRegisterMap(const BlackRegisterMap &);
+            BlackRegisterMap& operator=(const BlackRegisterMap &);
+
+        public:
+            /*! @brief Constructor of BlackRegisterMap class.
+            *
+            * This function initializes class variables. Nothing is mapped.
+            */
+                            BlackRegisterMap();
+
+            /*! @brief Constructor of BlackRegisterMap class.
+            *
+            * This function maps the area by calling open() function.
+            * @param [in] filePath   file which is mapped (like "/dev/mem")
+            * @param [in] offset     start of register area at file
+            * @param [in] size       size of register area
+            */
+                            BlackRegisterMap(const std::string &filePath, off_t offset, size_t size);
+
+            /*! @brief Destructor of BlackRegisterMap class.
+            *
+            * This function unmaps the area and closes the file.
+            */
+            virtual         ~BlackRegisterMap();
+
+            /*! @brief Maps register area of file to memory.
+            *
+            * If there is an open mapping, it is closed before.
+            * @return True if mapping is successful, else false.
+            */
+            bool            open(const std::string &filePath, off_t offset, size_t size);
+
+            /*! @brief Unmaps register area and closes file.
+            */
+            void            close();
+
+            /*! @brief Checks mapping state.
+            *
+            * @return True if register area is mapped, else false.
+            */
+            bool            isOpen() const;
+
+            /*! @brief Reads 16 bit register.
+            *
+            * @param [in] offset register offset from start of register area
+            */
+            inline uint16_t read16(uint32_t offset) const
+            {
+                return *reinterpret_cast<volatile uint16_t *>(this->registerBase + offset);
+            }
+
+            /*! @brief Reads 32 bit register.
+            *
+            * @param [in] offset register offset from start of register area
+            */
+            inline uint32_t read32(uint32_t offset) const
+            {
+                return *reinterpret_cast<volatile uint32_t *>(this->registerBase + offset);
+            }
+
+            /*! @brief Writes 16 bit register.
+            *
+            * @param [in] offset register offset from start of register area
+            * @param [in] value  new register value
+            */
+            inline void     write16(uint32_t offset, uint16_t value)
+            {
+                *reinterpret_cast<volatile uint16_t *>(this->registerBase + offset) = value;
+            }
+
+            /*! @brief Writes 32 bit register.
+            *
+            * @param [in] offset register offset from start of register area
+            * @param [in] value  new register value
+            */
+            inline void     write32(uint32_t offset, uint32_t value)
+            {
+                *reinterpret_cast<volatile uint32_t *>(this->registerBase + offset) = value;
+            }
+    };
+    // ######################################## BLACKREGISTERMAP DECLARATION ENDS ########################################## //
+
+
+
+} /* namespace BlackLib */
+
+#endif /* BLACKREGISTERMAP_H_ */
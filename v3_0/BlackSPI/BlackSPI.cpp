@@ -33,6 +33,12 @@
 
 #include "BlackSPI.h"
 
+#include <cerrno>
+
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+#include <arm_neon.h>
+#endif
+
 namespace BlackLib
 {
 
@@ -46,6 +52,9 @@ namespace BlackLib
         this->spiFD             = -1;
         this->isOpenFlag        = false;
         this->isCurrentEqDefault= true;
+        this->isChunkChipSelectHeld = false;
+        this->wordSupport[0]    = WordSupportUnknown;
+        this->wordSupport[1]    = WordSupportUnknown;
         this->spiErrors         = new errorSPI( this->getErrorsFromCore() );
 
 
@@ -63,6 +72,9 @@ namespace BlackLib
         this->spiFD             = -1;
         this->isOpenFlag        = false;
         this->isCurrentEqDefault= false;
+        this->isChunkChipSelectHeld = false;
+        this->wordSupport[0]    = WordSupportUnknown;
+        this->wordSupport[1]    = WordSupportUnknown;
         this->spiErrors         = new errorSPI( this->getErrorsFromCore() );
 
         constructorProperties   = spiProperties;
@@ -81,6 +93,9 @@ namespace BlackLib
         this->spiFD             = -1;
         this->isOpenFlag        = false;
         this->isCurrentEqDefault= false;
+        this->isChunkChipSelectHeld = false;
+        this->wordSupport[0]    = WordSupportUnknown;
+        this->wordSupport[1]    = WordSupportUnknown;
         this->spiErrors         = new errorSPI( this->getErrorsFromCore() );
 
 
@@ -196,14 +211,12 @@ namespace BlackLib
         }
         else
         {
-            if( this->setProperties( this->constructorProperties ))
-            {
-                this->currentProperties = this->constructorProperties;
-            }
-            else
-            {
-                this->currentProperties = this->defaultProperties;
-            }
+            // updateProperties() compares against the cached values, so they
+            // have to hold what the kernel reported before anything is
+            // skipped. Each successful setter updates its own field, so the
+            // cache keeps matching the device even if a later write fails.
+            this->currentProperties = this->defaultProperties;
+            this->updateProperties( this->constructorProperties );
         }
         return true;
     }
@@ -348,6 +361,34 @@ namespace BlackLib
         return ( this->currentProperties );
     }
 
+    bool        BlackSPI::updateProperties(const BlackSpiProperties &newProperties)
+    {
+        if( newProperties.spiBitsPerWord != this->currentProperties.spiBitsPerWord and
+            not this->setBitsPerWord( newProperties.spiBitsPerWord ) )
+        {
+            return false;
+        }
+
+        if( newProperties.spiSpeed != this->currentProperties.spiSpeed and
+            not this->setMaximumSpeed( newProperties.spiSpeed ) )
+        {
+            return false;
+        }
+
+        if( newProperties.spiMode != this->currentProperties.spiMode and
+            not this->setMode( newProperties.spiMode ) )
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    BlackSpiProperties BlackSPI::getCachedProperties()
+    {
+        return ( this->currentProperties );
+    }
+
 
 
     uint8_t     BlackSPI::transfer(uint8_t writeByte, uint16_t wait_us)
@@ -366,6 +407,7 @@ namespace BlackLib
 
         this->spiErrors->openError          = false;
         spi_ioc_transfer package;
+        memset(&package, 0, sizeof(package));
 
         package.tx_buf          = (unsigned long)&writeByte;
         package.rx_buf          = (unsigned long)&tempReadByte;
@@ -388,6 +430,223 @@ namespace BlackLib
     }
 
     bool        BlackSPI::transfer(uint8_t *writeBuffer, uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us)
+    {
+        return this->doTransfer(writeBuffer, readBuffer, bufferSize, wait_us);
+    }
+
+    bool        BlackSPI::transfer(uint8_t *buffer, size_t bufferSize, uint16_t wait_us)
+    {
+        return this->doTransfer(buffer, buffer, bufferSize, wait_us);
+    }
+
+    bool        BlackSPI::write(const uint8_t *writeBuffer, size_t bufferSize, uint16_t wait_us)
+    {
+        return this->doTransfer(writeBuffer, NULL, bufferSize, wait_us);
+    }
+
+    bool        BlackSPI::read(uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us)
+    {
+        return this->doTransfer(NULL, readBuffer, bufferSize, wait_us);
+    }
+
+    bool        BlackSPI::transfer(BlackBuffer &buffer, uint16_t wait_us)
+    {
+        return this->doTransfer(buffer.getData(), buffer.getData(), buffer.getLength(), wait_us);
+    }
+
+    bool        BlackSPI::transfer(const BlackBuffer &writeBuffer, BlackBuffer &readBuffer, uint16_t wait_us)
+    {
+        if( not readBuffer.setLength( writeBuffer.getLength() ) )
+        {
+            this->spiErrors->transferError = true;
+            return false;
+        }
+
+        return this->doTransfer(writeBuffer.getData(), readBuffer.getData(), writeBuffer.getLength(), wait_us);
+    }
+
+    bool        BlackSPI::write(const BlackBuffer &writeBuffer, uint16_t wait_us)
+    {
+        return this->doTransfer(writeBuffer.getData(), NULL, writeBuffer.getLength(), wait_us);
+    }
+
+    bool        BlackSPI::read(BlackBuffer &readBuffer, size_t bufferSize, uint16_t wait_us)
+    {
+        if( not readBuffer.setLength(bufferSize) )
+        {
+            this->spiErrors->transferError = true;
+            return false;
+        }
+
+        return this->doTransfer(NULL, readBuffer.getData(), bufferSize, wait_us);
+    }
+
+    bool        BlackSPI::transfer(const uint16_t *writeBuffer, uint16_t *readBuffer, size_t wordCount, uint16_t wait_us)
+    {
+        return this->doWordTransfer(writeBuffer, readBuffer, wordCount, sizeof(uint16_t), wait_us);
+    }
+
+    bool        BlackSPI::transfer(const uint32_t *writeBuffer, uint32_t *readBuffer, size_t wordCount, uint16_t wait_us)
+    {
+        return this->doWordTransfer(writeBuffer, readBuffer, wordCount, sizeof(uint32_t), wait_us);
+    }
+
+    bool        BlackSPI::write(const uint16_t *writeBuffer, size_t wordCount, uint16_t wait_us)
+    {
+        return this->doWordTransfer(writeBuffer, NULL, wordCount, sizeof(uint16_t), wait_us);
+    }
+
+    bool        BlackSPI::write(const uint32_t *writeBuffer, size_t wordCount, uint16_t wait_us)
+    {
+        return this->doWordTransfer(writeBuffer, NULL, wordCount, sizeof(uint32_t), wait_us);
+    }
+
+    bool        BlackSPI::read(uint16_t *readBuffer, size_t wordCount, uint16_t wait_us)
+    {
+        return this->doWordTransfer(NULL, readBuffer, wordCount, sizeof(uint16_t), wait_us);
+    }
+
+    bool        BlackSPI::read(uint32_t *readBuffer, size_t wordCount, uint16_t wait_us)
+    {
+        return this->doWordTransfer(NULL, readBuffer, wordCount, sizeof(uint32_t), wait_us);
+    }
+
+    bool        BlackSPI::doWordTransfer(const void *writeBuffer, void *readBuffer, size_t wordCount, uint8_t wordSize, uint16_t wait_us)
+    {
+        if( ! this->isOpenFlag )
+        {
+            this->spiErrors->openError      = true;
+            this->spiErrors->transferError  = true;
+            return false;
+        }
+
+        this->spiErrors->openError  = false;
+
+        size_t byteCount            = wordCount * wordSize;
+        uint8_t &support            = this->wordSupport[ (wordSize == sizeof(uint16_t)) ? 0 : 1 ];
+
+        if( support != WordSupportSwapped )
+        {
+            spi_ioc_transfer package;
+            memset(&package, 0, sizeof(package));
+
+            package.tx_buf          = (unsigned long)writeBuffer;
+            package.rx_buf          = (unsigned long)readBuffer;
+            package.len             = byteCount;
+            package.delay_usecs     = wait_us;
+            package.speed_hz        = this->currentProperties.spiSpeed;
+            package.bits_per_word   = wordSize * 8;
+
+            if( this->submitPackages(&package, 1) )
+            {
+                support = WordSupportNative;
+                this->spiErrors->transferError = false;
+                return true;
+            }
+
+            // word size is validated before the transfer starts, so the fallback doesn't repeat any data
+            if( support == WordSupportNative or errno != EINVAL )
+            {
+                this->spiErrors->transferError = true;
+                return false;
+            }
+
+            support = WordSupportSwapped;
+        }
+
+
+        if( this->wordScratch.size() < byteCount )
+        {
+            this->wordScratch.resize(byteCount);
+        }
+
+        uint8_t *bytes = &(this->wordScratch[0]);
+
+        if( writeBuffer == NULL )
+        {
+            memset(bytes, 0, byteCount);
+        }
+        else if( wordSize == sizeof(uint16_t) )
+        {
+            const uint16_t *words = static_cast<const uint16_t*>(writeBuffer);
+            size_t i = 0;
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+            // 8 words per step: little endian words become big endian by reversing bytes of every word
+            for( ; i + 8 <= wordCount ; i += 8 )
+            {
+                vst1q_u8(bytes + 2*i, vrev16q_u8( vld1q_u8(reinterpret_cast<const uint8_t*>(words + i)) ));
+            }
+#endif
+            for( ; i < wordCount ; i++ )
+            {
+                bytes[2*i]      = static_cast<uint8_t>(words[i] >> 8);
+                bytes[2*i + 1]  = static_cast<uint8_t>(words[i]);
+            }
+        }
+        else
+        {
+            const uint32_t *words = static_cast<const uint32_t*>(writeBuffer);
+            size_t i = 0;
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+            for( ; i + 4 <= wordCount ; i += 4 )
+            {
+                vst1q_u8(bytes + 4*i, vrev32q_u8( vld1q_u8(reinterpret_cast<const uint8_t*>(words + i)) ));
+            }
+#endif
+            for( ; i < wordCount ; i++ )
+            {
+                bytes[4*i]      = static_cast<uint8_t>(words[i] >> 24);
+                bytes[4*i + 1]  = static_cast<uint8_t>(words[i] >> 16);
+                bytes[4*i + 2]  = static_cast<uint8_t>(words[i] >> 8);
+                bytes[4*i + 3]  = static_cast<uint8_t>(words[i]);
+            }
+        }
+
+        if( not this->doTransfer(bytes, (readBuffer == NULL) ? NULL : bytes, byteCount, wait_us) )
+        {
+            return false;
+        }
+
+        if( readBuffer == NULL )
+        {
+            return true;
+        }
+        else if( wordSize == sizeof(uint16_t) )
+        {
+            uint16_t *words = static_cast<uint16_t*>(readBuffer);
+            size_t i = 0;
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+            for( ; i + 8 <= wordCount ; i += 8 )
+            {
+                vst1q_u8(reinterpret_cast<uint8_t*>(words + i), vrev16q_u8( vld1q_u8(bytes + 2*i) ));
+            }
+#endif
+            for( ; i < wordCount ; i++ )
+            {
+                words[i] = static_cast<uint16_t>( (bytes[2*i] << 8) | bytes[2*i + 1] );
+            }
+        }
+        else
+        {
+            uint32_t *words = static_cast<uint32_t*>(readBuffer);
+            size_t i = 0;
+#if defined(__ARM_NEON__) && defined(__ARMEL__)
+            for( ; i + 4 <= wordCount ; i += 4 )
+            {
+                vst1q_u8(reinterpret_cast<uint8_t*>(words + i), vrev32q_u8( vld1q_u8(bytes + 4*i) ));
+            }
+#endif
+            for( ; i < wordCount ; i++ )
+            {
+                words[i] = (static_cast<uint32_t>(bytes[4*i]) << 24) | (static_cast<uint32_t>(bytes[4*i + 1]) << 16) |
+                           (static_cast<uint32_t>(bytes[4*i + 2]) << 8) | static_cast<uint32_t>(bytes[4*i + 3]);
+            }
+        }
+
+        return true;
+    }
+
+    bool        BlackSPI::doTransfer(const uint8_t *writeBuffer, uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us)
     {
         if( ! this->isOpenFlag )
         {
@@ -399,29 +658,251 @@ namespace BlackLib
 
 
         this->spiErrors->openError          = false;
-        uint8_t tempReadBuffer[ bufferSize ];
-        memset( tempReadBuffer, 0, bufferSize);
 
+        // kernel copies write data before it copies read data back, so both pointers can be same
         spi_ioc_transfer package;
+        memset(&package, 0, sizeof(package));
+
         package.tx_buf          = (unsigned long)writeBuffer;
-        package.rx_buf          = (unsigned long)tempReadBuffer;
+        package.rx_buf          = (unsigned long)readBuffer;
         package.len             = bufferSize;
         package.delay_usecs     = wait_us;
         package.speed_hz        = this->currentProperties.spiSpeed;
         package.bits_per_word   = this->currentProperties.spiBitsPerWord;
 
+        this->spiErrors->transferError = ! this->submitPackages(&package, 1);
+        return ! this->spiErrors->transferError;
+    }
 
-        if( ::ioctl(this->spiFD, SPI_IOC_MESSAGE(1), &package) >= 0)
+    bool        BlackSPI::submitPackages(spi_ioc_transfer *packages, size_t packageCount)
+    {
+        size_t limit        = BlackSPI::getMaximumMessageSize();
+        size_t alignment    = (limit < SPIDEV_TRANSFER_ALIGNMENT) ? 1 : SPIDEV_TRANSFER_ALIGNMENT;
+        size_t totalLength  = 0;
+
+        // spidev rounds every transfer up in its bounce buffers, so the rounded lengths are counted
+        limit -= limit % alignment;
+
+        for( size_t i = 0 ; i < packageCount ; i++ )
+        {
+            totalLength += BlackSPI::getAlignedTransferLength(packages[i].len);
+        }
+
+        if( totalLength <= limit and packageCount <= SPI_MAX_MESSAGE_SEGMENTS )
+        {
+            return this->sendMessage(packages, packageCount);
+        }
+
+
+
+        this->chunkPackages.clear();
+        size_t messageLength = 0;
+
+        for( size_t i = 0 ; i < packageCount ; i++ )
+        {
+            const spi_ioc_transfer &package = packages[i];
+            bool isLastPackage = (i + 1 == packageCount);
+
+            if( package.len == 0 )
+            {
+                this->chunkPackages.push_back(package);
+                if( this->chunkPackages.size() == SPI_MAX_MESSAGE_SEGMENTS and not isLastPackage )
+                {
+                    if( ! this->flushChunkPackages(false, package.cs_change != 0) ) { return false; }
+                    messageLength = 0;
+                }
+                continue;
+            }
+
+            // chunks of multi-byte words are split only at word boundaries
+            uint32_t wordBytes  = this->getTransferWordSize(package);
+
+            uint32_t offset = 0;
+            while( offset < package.len )
+            {
+                uint32_t chunkLength = package.len - offset;
+                if( messageLength + BlackSPI::getAlignedTransferLength(chunkLength) > limit )
+                {
+                    chunkLength  = limit - messageLength;
+                    chunkLength -= chunkLength % wordBytes;
+                }
+
+                if( chunkLength == 0 )
+                {
+                    if( ! this->flushChunkPackages(false, false) ) { return false; }
+                    messageLength = 0;
+                    continue;
+                }
+
+                bool isLastChunk = (offset + chunkLength == package.len);
+
+                spi_ioc_transfer chunk = package;
+                chunk.tx_buf        = (package.tx_buf == 0) ? 0 : package.tx_buf + offset;
+                chunk.rx_buf        = (package.rx_buf == 0) ? 0 : package.rx_buf + offset;
+                chunk.len           = chunkLength;
+                chunk.delay_usecs   = isLastChunk ? package.delay_usecs : 0;
+                chunk.cs_change     = isLastChunk ? package.cs_change   : 0;
+
+                this->chunkPackages.push_back(chunk);
+                messageLength  += BlackSPI::getAlignedTransferLength(chunkLength);
+                offset         += chunkLength;
+
+                bool isFull = (messageLength >= limit or this->chunkPackages.size() == SPI_MAX_MESSAGE_SEGMENTS);
+                if( isFull and not (isLastPackage and isLastChunk) )
+                {
+                    if( ! this->flushChunkPackages(false, isLastChunk and package.cs_change != 0) ) { return false; }
+                    messageLength = 0;
+                }
+            }
+        }
+
+        return this->flushChunkPackages(true, false);
+    }
+
+    bool        BlackSPI::flushChunkPackages(bool isFinal, bool isToggleRequested)
+    {
+        if( this->chunkPackages.empty() )
         {
-            this->spiErrors->transferError = false;
-            memcpy(readBuffer, tempReadBuffer, bufferSize);
             return true;
         }
-        else
+
+        // cs_change at the last package of a message means keeping chip select active after message
+        if( ! isFinal )
+        {
+            this->chunkPackages.back().cs_change = (this->isChunkChipSelectHeld and ! isToggleRequested) ? 1 : 0;
+        }
+
+        bool isSent = this->sendMessage(&(this->chunkPackages[0]), this->chunkPackages.size());
+        this->chunkPackages.clear();
+        return isSent;
+    }
+
+    bool        BlackSPI::sendMessage(spi_ioc_transfer *packages, size_t packageCount)
+    {
+        if( ::ioctl(this->spiFD, SPI_IOC_MESSAGE(packageCount), packages) >= 0 )
+        {
+            return true;
+        }
+
+        // kernel checks message size before anything is clocked out, so a rejected message can be split
+        if( errno != EMSGSIZE )
+        {
+            return false;
+        }
+
+        if( packageCount > 1 )
+        {
+            size_t firstCount           = packageCount / 2;
+            spi_ioc_transfer &boundary  = packages[firstCount - 1];
+            uint8_t savedChange         = boundary.cs_change;
+
+            boundary.cs_change  = (this->isChunkChipSelectHeld and savedChange == 0) ? 1 : 0;
+            bool isSent         = this->sendMessage(packages, firstCount);
+            boundary.cs_change  = savedChange;
+
+            return ( isSent and this->sendMessage(packages + firstCount, packageCount - firstCount) );
+        }
+
+        uint32_t wordBytes      = this->getTransferWordSize(packages[0]);
+        uint32_t firstLength    = packages[0].len / 2;
+        firstLength            -= firstLength % wordBytes;
+
+        if( firstLength == 0 )
+        {
+            return false;
+        }
+
+        spi_ioc_transfer first  = packages[0];
+        spi_ioc_transfer second = packages[0];
+
+        first.len           = firstLength;
+        first.delay_usecs   = 0;
+        first.cs_change     = this->isChunkChipSelectHeld ? 1 : 0;
+
+        second.tx_buf       = (second.tx_buf == 0) ? 0 : second.tx_buf + firstLength;
+        second.rx_buf       = (second.rx_buf == 0) ? 0 : second.rx_buf + firstLength;
+        second.len         -= firstLength;
+
+        return ( this->sendMessage(&first, 1) and this->sendMessage(&second, 1) );
+    }
+
+    uint32_t    BlackSPI::getTransferWordSize(const spi_ioc_transfer &package)
+    {
+        uint8_t bits = (package.bits_per_word == 0) ? this->currentProperties.spiBitsPerWord : package.bits_per_word;
+        return ( (bits > 16) ? 4 : ((bits > 8) ? 2 : 1) );
+    }
+
+    size_t      BlackSPI::getAlignedTransferLength(size_t length)
+    {
+        size_t limit = BlackSPI::getMaximumMessageSize();
+        if( limit < SPIDEV_TRANSFER_ALIGNMENT )
+        {
+            return length;
+        }
+        return ( (length + SPIDEV_TRANSFER_ALIGNMENT - 1) / SPIDEV_TRANSFER_ALIGNMENT * SPIDEV_TRANSFER_ALIGNMENT );
+    }
+
+    void        BlackSPI::setChunkChipSelectHold(bool hold)
+    {
+        this->isChunkChipSelectHeld = hold;
+    }
+
+    bool        BlackSPI::getChunkChipSelectHold()
+    {
+        return this->isChunkChipSelectHeld;
+    }
+
+    size_t      BlackSPI::getMaximumMessageSize()
+    {
+        static size_t maximumMessageSize = 0;
+        static pthread_once_t readOnce = PTHREAD_ONCE_INIT;
+
+        struct BufsizReader
+        {
+            static void read()
+            {
+                maximumMessageSize = SPIDEV_DEFAULT_BUFSIZ;
+
+                std::ifstream bufsizFile;
+                bufsizFile.open(SPIDEV_BUFSIZ_PATH.c_str(), std::ios::in);
+                if( ! bufsizFile.fail() )
+                {
+                    size_t readValue = 0;
+                    bufsizFile >> readValue;
+                    if( readValue > 0 )
+                    {
+                        maximumMessageSize = readValue;
+                    }
+                }
+                bufsizFile.close();
+            }
+        };
+
+        pthread_once(&readOnce, &BufsizReader::read);
+        return maximumMessageSize;
+    }
+
+    bool        BlackSPI::transfer(BlackSPITransaction &transaction)
+    {
+        if( ! this->isOpenFlag )
+        {
+            this->spiErrors->openError      = true;
+            this->spiErrors->transferError  = true;
+            return false;
+        }
+
+        this->spiErrors->openError          = false;
+
+        size_t segmentCount = transaction.getSegmentCount();
+        if( segmentCount == 0 )
         {
             this->spiErrors->transferError = true;
             return false;
         }
+
+
+        this->spiErrors->transferError = ! this->submitPackages(transaction.getSegments(), segmentCount);
+        return ! this->spiErrors->transferError;
     }
 
 
@@ -36,14 +36,17 @@
 
 
 #include "../BlackCore.h"
+#include "../BlackBufferPool/BlackBufferPool.h"
 
 #include <cstring>
 #include <string>
 #include <fstream>
 #include <cstdint>
+#include <vector>
 #include <unistd.h>
 
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/ioctl.h>
 #include <linux/spi/spidev.h>
 
@@ -154,14 +157,152 @@ namespace BlackLib
 
 
 
+    const size_t            SPI_MAX_MESSAGE_SEGMENTS    = ((1 << _IOC_SIZEBITS) - 1) / sizeof(spi_ioc_transfer);   //!< Maximum segment count of one SPI_IOC_MESSAGE request
+    const std::string       SPIDEV_BUFSIZ_PATH          = "/sys/module/spidev/parameters/bufsiz";                   //!< spidev module's message size limit parameter
+    const size_t            SPIDEV_DEFAULT_BUFSIZ       = 4096;                                                     //!< If bufsiz parameter can't read, this limit is used
+    const size_t            SPIDEV_TRANSFER_ALIGNMENT   = 64;                                                       //!< spidev rounds every transfer up to this size (ARCH_KMALLOC_MINALIGN of Cortex-A8) in its buffers
+
+
+
+
+    // ######################################### BLACKSPITRANSACTION DECLARATION STARTS ######################################## //
+
+    /*! @brief Holds segments of a spi message.
+     *
+     *    This class builds a chain of spi transfer segments. Every segment has its own write buffer, read buffer,
+     *    length, speed, word size, delay and chip select change values. The whole chain is sent to kernel with
+     *    one @b SPI_IOC_MESSAGE(n) request by BlackSPI::transfer(BlackSPITransaction&) function, so chip select
+     *    stays active between segments unless cs_change is set for a segment. If total length of chain exceeds
+     *    spidev's message size limit, the chain is split into chunks and sent with as few requests as possible.
+     *
+     *    Buffers are not copied, so they must be valid until the transfer is finished.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  uint8_t command[2] = { 0x03, 0x00 };       // read command and address
+     *  uint8_t response[16];
+     *
+     *  BlackLib::BlackSPITransaction transaction;
+     *  transaction.addSegment(command, NULL, sizeof(command));
+     *  transaction.addSegment(NULL, response, sizeof(response));
+     *
+     *  mySpi.transfer(transaction);
+     * @endcode
+     */
+    class BlackSPITransaction
+    {
+        private:
+            std::vector<spi_ioc_transfer> segments;     /*!< @brief is used to hold the kernel transfer packages */
+
+        public:
+            /*! @brief Default constructor of BlackSPITransaction class.
+            *
+            *  This function reserves place for a few segments.
+            */
+            BlackSPITransaction()
+            {
+                segments.reserve(4);
+            }
+
+            /*! @brief Appends a segment to the transaction.
+            *
+            * Zero speed and zero word size mean the current values of spi device.
+            * @param [in] writeBuffer      data buffer pointer, NULL for sending zeros
+            * @param [out] readBuffer      read buffer pointer, NULL for discarding received data
+            * @param [in] length           segment length in bytes
+            * @param [in] speed            segment speed in Hz
+            * @param [in] bitsPerWord      segment word size
+            * @param [in] wait_us          delay after segment
+            * @param [in] csChange         deselects chip select after segment if it is true
+            * @return reference of transaction for chaining.
+            */
+            BlackSPITransaction& addSegment(const uint8_t *writeBuffer, uint8_t *readBuffer, uint32_t length,
+                                            uint32_t speed = 0, uint8_t bitsPerWord = 0, uint16_t wait_us = 0,
+                                            bool csChange = false)
+            {
+                spi_ioc_transfer package;
+                memset(&package, 0, sizeof(package));
+
+                package.tx_buf          = (unsigned long)writeBuffer;
+                package.rx_buf          = (unsigned long)readBuffer;
+                package.len             = length;
+                package.speed_hz        = speed;
+                package.bits_per_word   = bitsPerWord;
+                package.delay_usecs     = wait_us;
+                package.cs_change       = csChange ? 1 : 0;
+
+                segments.push_back(package);
+                return *this;
+            }
+
+            /*! @brief Removes all segments. Reserved memory is kept for reusing.
+            */
+            void clear()
+            {
+                segments.clear();
+            }
+
+            /*! @brief Exports segment count.
+            */
+            size_t getSegmentCount() const
+            {
+                return segments.size();
+            }
+
+            /*! @brief Exports sum of segment lengths.
+            */
+            size_t getTotalLength() const
+            {
+                size_t total = 0;
+                for( size_t i = 0 ; i < segments.size() ; i++ )
+                {
+                    total += segments[i].len;
+                }
+                return total;
+            }
+
+            /*! @brief Exports kernel transfer package of selected segment.
+            */
+            spi_ioc_transfer& getSegment(size_t index)
+            {
+                return segments[index];
+            }
+
+            /*! @brief Exports pointer of first kernel transfer package.
+            *
+            * @return pointer which can be passed to SPI_IOC_MESSAGE request, or NULL if there isn't any segment.
+            */
+            spi_ioc_transfer* getSegments()
+            {
+                return segments.empty() ? NULL : &segments[0];
+            }
+
+            /*! @brief Appends copies of all segments of another transaction.
+            *
+            * Buffers are not copied, only kernel transfer packages are copied.
+            * @param [in] other            source transaction
+            * @return reference of transaction for chaining.
+            */
+            BlackSPITransaction& append(const BlackSPITransaction &other)
+            {
+                segments.insert(segments.end(), other.segments.begin(), other.segments.end());
+                return *this;
+            }
+    };
+    // ########################################## BLACKSPITRANSACTION DECLARATION ENDS ######################################### //
+
+
+
+
+
     // ########################################### BLACKSPI DECLARATION STARTS ############################################ //
 
     /*! @brief Interacts with end user, to use SPI.
      *
      *    This class is end node to use spi. End users interact with spi from this class.
      *    It includes public functions to set and get properties of spi's and to transfer datas.
-     *    Spi has not capable of only read operation. For reading something from spi, user's
-     *    must send dummy data.
+     *    Spi has not capable of only read operation. For reading something from spi, dummy data
+     *    must be sent; read() function does this by sending zeros without any dummy buffer.
      *
      *    @warning Users have to execute setup script before use spi. This is required for compiling
      *    and setting device tree overlays about spi.
@@ -287,6 +428,18 @@ namespace BlackLib
             int             spiChipNumber;              /*!< @brief is used to hold the spi's chip number */
             bool            isCurrentEqDefault;         /*!< @brief is used to hold the properties of spi is equal to default properties */
             bool            isOpenFlag;                 /*!< @brief is used to hold the spi's tty file's state */
+            bool            isChunkChipSelectHeld;      /*!< @brief is used to hold the chip select state between chunk messages */
+            std::vector<spi_ioc_transfer> chunkPackages;    /*!< @brief is used to hold the reusable packages of chunked messages */
+            uint8_t         wordSupport[2];             /*!< @brief is used to hold the controller support of 16 and 32 bit words (wordSupportState) */
+            std::vector<uint8_t> wordScratch;           /*!< @brief is used to hold the byte ordered copy of words when controller doesn't support word size */
+
+            /*!
+            * This enum is used for caching the controller support of word sizes.
+            */
+            enum wordSupportState   {   WordSupportUnknown  = 0,
+                                        WordSupportNative   = 1,
+                                        WordSupportSwapped  = 2
+                                    };
 
             /*! @brief Loads SPI overlay to device tree.
             *
@@ -309,6 +462,58 @@ namespace BlackLib
             */
             bool            findPortPath();
 
+            /*! @brief Does one segment spi transfer.
+            *
+            *  This function is used by transfer(), write() and read() functions. NULL write or read
+            *  buffer is passed to kernel as it is.
+            *  @return True if successful, else false.
+            */
+            bool            doTransfer(const uint8_t *writeBuffer, uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us);
+
+            /*! @brief Sends transfer packages to kernel.
+            *
+            *  Every package is counted with its length rounded up to BlackLib::SPIDEV_TRANSFER_ALIGNMENT, as
+            *  spidev does in its buffers. If total counted length of packages is not greater than spidev's
+            *  message size limit, packages are sent with one request. Otherwise packages are split into maximal
+            *  chunks and chunks are packed into as few requests as possible. If chip select holding is enabled,
+            *  the last chunk of every request except the final one has cs_change flag, so chip select stays
+            *  active until next request.
+            *  @return True if all requests are successful, else false.
+            */
+            bool            submitPackages(spi_ioc_transfer *packages, size_t packageCount);
+
+            /*! @brief Sends collected chunk packages with one request and clears them.
+            *
+            *  @return True if successful, else false.
+            */
+            bool            flushChunkPackages(bool isFinal, bool isToggleRequested);
+
+            /*! @brief Sends packages with one request, splits the request if kernel rejects its size.
+            *
+            *  If kernel returns EMSGSIZE, packages are sent as two halves, and a single package is halved at
+            *  word boundary. Halves are split again while kernel rejects them. Chip select between halves
+            *  follows the chunk chip select holding setting.
+            *  @return True if all requests are successful, else false.
+            */
+            bool            sendMessage(spi_ioc_transfer *packages, size_t packageCount);
+
+            /*! @brief Exports byte count of one word of a transfer package.
+            *
+            *  @return 1, 2 or 4.
+            */
+            uint32_t        getTransferWordSize(const spi_ioc_transfer &package);
+
+            /*! @brief Transfers 16 or 32 bit words.
+            *
+            *  Words are sent with word sized spi transfers first, so the controller sends them most significant
+            *  bit first directly from memory. If the controller rejects the word size, this is cached and words
+            *  are converted to big endian byte stream in a scratch buffer and sent as bytes. Conversions reverse
+            *  bytes of 16 byte blocks with NEON instructions when the library is compiled with NEON support
+            *  (-mfpu=neon), else they are scalar loops.
+            *  @return True if successful, else false.
+            */
+            bool            doWordTransfer(const void *writeBuffer, void *readBuffer, size_t wordCount, uint8_t wordSize, uint16_t wait_us);
+
 
         public:
             /*!
@@ -416,8 +621,9 @@ namespace BlackLib
             *
             * This function opens spi's TTY file with selected open mode, gets default properties of SPI
             * and saves this properties to BlackSPI::defaultProperties struct. Then sets properties
-            * which are specified at class initialization stage. Users can send "or"ed BlackLib::openMode
-            * enums as parameter to this function.
+            * which are specified at class initialization stage. Only the properties which differ from
+            * the default values are written. Users can send "or"ed BlackLib::openMode enums as parameter
+            * to this function.
             * @warning After initialization of BlackSPI class, this function must call. Otherwise users
             * could not use any of data transfering functions.
             *
@@ -489,11 +695,11 @@ namespace BlackLib
 
             /*! @brief Transfers datas to/from slave.
             *
-            * This function creates temporary read buffer with specified size and then generates <i><b> SPI IOCTL
-            * TRANSFER PACKAGE </b></i> with write buffer pointer, temporary read buffer pointer, buffer size,
-            * delay time, spi word's size and spi speed parameters. After doing ioctl kernel request if request is
-            * finished successfully, datas which are held in temporary read buffer are copied to @a @b readBuffer
-            * pointer.
+            * This function generates <i><b> SPI IOCTL TRANSFER PACKAGE </b></i> with write buffer pointer, read
+            * buffer pointer, buffer size, delay time, spi word's size and spi speed parameters. Received datas are
+            * written by kernel to @a @b readBuffer directly, so there isn't any temporary buffer or copy. Write and
+            * read buffers can be the same buffer. If write buffer is NULL zeros are sent, if read buffer is NULL
+            * received datas are discarded.
             *
             * @param [in] writeBuffer          data buffer pointer
             * @param [out] readBuffer          read buffer pointer
@@ -528,6 +734,252 @@ namespace BlackLib
             */
             bool            transfer(uint8_t *writeBuffer, uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us = 10);
 
+            /*! @brief Transfers datas to/from slave in place.
+            *
+            * This function sends the datas in buffer and writes received datas over them.
+            *
+            * @param [in,out] buffer           data buffer pointer
+            * @param [in] bufferSize           buffer size
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *
+            *   BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiDefault, 2400000);
+            *
+            *   mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *
+            *   uint8_t buffer[3] = { 0x01, 0x80, 0x00 };
+            *   mySpi.transfer(buffer, sizeof(buffer));
+            *
+            *   std::cout << "Loopback spi test result: 0x" << std::hex << (int)buffer[1];
+            *
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Loopback spi test result: 0x80
+            * @endcode
+            */
+            bool            transfer(uint8_t *buffer, size_t bufferSize, uint16_t wait_us = 10);
+
+            /*! @brief Sends datas to slave and discards received datas.
+            *
+            * This function passes NULL read buffer to kernel.
+            *
+            * @param [in] writeBuffer          data buffer pointer
+            * @param [in] bufferSize           buffer size
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            */
+            bool            write(const uint8_t *writeBuffer, size_t bufferSize, uint16_t wait_us = 10);
+
+            /*! @brief Receives datas from slave while sending zeros.
+            *
+            * This function passes NULL write buffer to kernel.
+            *
+            * @param [out] readBuffer          read buffer pointer
+            * @param [in] bufferSize           buffer size
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            */
+            bool            read(uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us = 10);
+
+            /*! @brief Transfers valid bytes of a pool buffer in place.
+            *
+            * Received datas overwrite the sent datas, so the buffer is used without any copy.
+            *
+            * @param [in,out] buffer           pool buffer, its length is used as transfer size
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            *
+            * @sa BlackBufferPool
+            */
+            bool            transfer(BlackBuffer &buffer, uint16_t wait_us = 10);
+
+            /*! @brief Transfers valid bytes of a pool buffer and receives datas to another pool buffer.
+            *
+            * Length of read buffer is set to transfer size.
+            *
+            * @param [in] writeBuffer          pool buffer, its length is used as transfer size
+            * @param [out] readBuffer          pool buffer, its capacity must be enough for transfer size
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            */
+            bool            transfer(const BlackBuffer &writeBuffer, BlackBuffer &readBuffer, uint16_t wait_us = 10);
+
+            /*! @brief Sends valid bytes of a pool buffer and discards received datas.
+            *
+            * @param [in] writeBuffer          pool buffer, its length is used as transfer size
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            */
+            bool            write(const BlackBuffer &writeBuffer, uint16_t wait_us = 10);
+
+            /*! @brief Receives datas to a pool buffer while sending zeros.
+            *
+            * Length of buffer is set to transfer size.
+            *
+            * @param [out] readBuffer          pool buffer, its capacity must be enough for transfer size
+            * @param [in] bufferSize           transfer size
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            */
+            bool            read(BlackBuffer &readBuffer, size_t bufferSize, uint16_t wait_us = 10);
+
+            /*! @brief Transfers 16 bit words to/from slave.
+            *
+            * Every word is sent most significant bit first, so users don't need byte swapping for big endian
+            * devices. Word sized spi transfers are used if the controller supports them, otherwise words are
+            * converted to byte stream internally. Both buffers can be same.
+            *
+            * @param [in] writeBuffer          word buffer pointer, NULL for sending zeros
+            * @param [out] readBuffer          word buffer pointer, NULL for discarding received data
+            * @param [in] wordCount            word count
+            * @param [in] wait_us              delay time
+            * @return true if transfer operation successful, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *
+            *   BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiMode0, 2400000);
+            *
+            *   mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *
+            *   uint16_t command[2]  = { 0x8F00, 0x0000 };   // read register 0x0F of a 16 bit word device
+            *   uint16_t response[2];
+            *   mySpi.transfer(command, response, 2);
+            *
+            *   std::cout << "Register value: 0x" << std::hex << response[1];
+            *
+            * @endcode
+            */
+            bool            transfer(const uint16_t *writeBuffer, uint16_t *readBuffer, size_t wordCount, uint16_t wait_us = 10);
+
+            /*! @brief Transfers 32 bit words to/from slave.
+            *
+            * @sa transfer(const uint16_t*, uint16_t*, size_t, uint16_t)
+            */
+            bool            transfer(const uint32_t *writeBuffer, uint32_t *readBuffer, size_t wordCount, uint16_t wait_us = 10);
+
+            /*! @brief Sends 16 bit words to slave and discards received datas.
+            *
+            * @sa transfer(const uint16_t*, uint16_t*, size_t, uint16_t)
+            */
+            bool            write(const uint16_t *writeBuffer, size_t wordCount, uint16_t wait_us = 10);
+
+            /*! @brief Sends 32 bit words to slave and discards received datas.
+            *
+            * @sa transfer(const uint16_t*, uint16_t*, size_t, uint16_t)
+            */
+            bool            write(const uint32_t *writeBuffer, size_t wordCount, uint16_t wait_us = 10);
+
+            /*! @brief Receives 16 bit words from slave while sending zeros.
+            *
+            * @sa transfer(const uint16_t*, uint16_t*, size_t, uint16_t)
+            */
+            bool            read(uint16_t *readBuffer, size_t wordCount, uint16_t wait_us = 10);
+
+            /*! @brief Receives 32 bit words from slave while sending zeros.
+            *
+            * @sa transfer(const uint16_t*, uint16_t*, size_t, uint16_t)
+            */
+            bool            read(uint32_t *readBuffer, size_t wordCount, uint16_t wait_us = 10);
+
+            /*! @brief Transfers all segments of transaction with one kernel request.
+            *
+            * This function sends segments of transaction to kernel with one @b SPI_IOC_MESSAGE(n) request. Chip select
+            * is held active between segments unless cs_change is set, so command and response phases of a slave
+            * can be done without full duplex dummy buffers and without releasing chip select. Chains which are
+            * greater than spidev's message size limit are split into chunks.
+            * @sa setChunkChipSelectHold()
+            *
+            * @param [in,out] transaction      segment chain
+            * @return true if transfer operation successful, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *
+            *   BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiDefault, 2400000);
+            *
+            *   mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *
+            *   uint8_t readIdCommand = 0x9F;
+            *   uint8_t id[3];
+            *
+            *   BlackLib::BlackSPITransaction transaction;
+            *   transaction.addSegment(&readIdCommand, NULL, 1)
+            *              .addSegment(NULL, id, sizeof(id), 1000000);
+            *
+            *   mySpi.transfer(transaction);
+            *
+            *   std::cout << "Flash id: 0x" << std::hex << (int)id[0] << (int)id[1] << (int)id[2];
+            *
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Flash id: 0xef4018
+            * @endcode
+            */
+            bool            transfer(BlackSPITransaction &transaction);
+
+            /*! @brief Changes chip select behaviour between chunk requests.
+            *
+            * Transfers which are greater than spidev's message size limit are sent with more than one request.
+            * Normally chip select is deactivated at the end of every request. If this feature is enabled, chip
+            * select stays active between these requests, so slave sees one continuous transfer.
+            *
+            * @param [in] hold                 true for holding chip select active between chunk requests
+            *
+            * @par Example
+            *  @code{.cpp}
+            *
+            *   BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiDefault, 24000000);
+            *
+            *   mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *   mySpi.setChunkChipSelectHold(true);
+            *
+            *   std::vector<uint8_t> frame(320*240*2);
+            *   mySpi.write(&frame[0], frame.size());      // sent as 38 chunks, chip select stays active
+            *
+            *   std::cout << "Message size limit: " << BlackLib::BlackSPI::getMaximumMessageSize();
+            *
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Message size limit: 4096
+            * @endcode
+            */
+            void            setChunkChipSelectHold(bool hold);
+
+            /*! @brief Exports chip select behaviour between chunk requests.
+            *
+            * @return true if chip select is held active between chunk requests, else false.
+            */
+            bool            getChunkChipSelectHold();
+
+            /*! @brief Exports message size limit of spidev.
+            *
+            * This function reads @b bufsiz parameter of spidev module once per process. If it can't read, it
+            * returns BlackLib::SPIDEV_DEFAULT_BUFSIZ value.
+            *
+            * @return maximum total length of one spi message.
+            */
+            static size_t   getMaximumMessageSize();
+
+            /*! @brief Exports the length which spidev reserves for a transfer in its buffers.
+            *
+            * spidev rounds every transfer up to BlackLib::SPIDEV_TRANSFER_ALIGNMENT bytes, and checks the
+            * rounded totals against its message size limit. So a message of many short segments fits
+            * fewer segments than its raw length suggests.
+            *
+            * @param [in] length            transfer length in bytes
+            * @return rounded length in bytes.
+            *
+            * @sa getMaximumMessageSize()
+            */
+            static size_t   getAlignedTransferLength(size_t length);
+
 
             /*! @brief Changes word size of spi.
             *
@@ -666,6 +1118,31 @@ namespace BlackLib
             */
             bool            setProperties(BlackSpiProperties &newProperties);
 
+            /*! @brief Changes only the properties which differ from the last known values.
+            *
+            * This function compares new properties with the values which are read or written at last,
+            * and it issues ioctl requests only for the different fields. The last known values are
+            * correct while spi device is configured only from this object. If another program can
+            * change the device, getProperties() function should be called first.
+            *
+            * @param [in] &newProperties        new properties of spi
+            * @return true if all requested fields are set, else false.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiDefault, 2400000);
+            *   mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *
+            *   // only the speed ioctl is issued
+            *   BlackLib::BlackSpiProperties fastProps(8, BlackLib::SpiDefault, 12000000);
+            *   mySpi.updateProperties(fastProps);
+            * @endcode
+            *
+            * @sa setProperties()
+            * @sa getCachedProperties()
+            */
+            bool            updateProperties(const BlackSpiProperties &newProperties);
+
             /*! @brief Exports spi's port path.
             *
             * @return spi's port path as string.
@@ -737,6 +1214,14 @@ namespace BlackLib
             */
             BlackSpiProperties getProperties();
 
+            /*! @brief Exports last known properties of spi without reading them from kernel.
+            *
+            * @return BlackSPI::currentProperties struct.
+            *
+            * @sa updateProperties()
+            */
+            BlackSpiProperties getCachedProperties();
+
             /*! @brief Checks spi's tty file's open state.
             *
             * @return true if tty file is open, else false.
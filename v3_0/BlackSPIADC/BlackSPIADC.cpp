@@ -0,0 +1,252 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackSPIADC.h"
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+
+
+
+
+namespace BlackLib
+{
+
+    // ########################################### BLACKSPIADC DEFINITION STARTS ############################################ //
+
+    BlackSPIADC::BlackSPIADC(BlackSPI *spi, spiAdcModel model, const uint8_t *channels, uint8_t channelCount,
+                             uint32_t repeatCount, uint64_t interval, timeType tType, size_t bufferSize)
+        : BlackPeriodicThread(interval, tType)
+    {
+        this->spiObject             = spi;
+        this->sequenceLength        = (channels == NULL or channelCount == 0) ? 1 : channelCount;
+        this->resultMask            = (model == MCP3208) ? 0x0FFF : 0x03FF;
+        this->writeIndex            = 0;
+        this->readIndex             = 0;
+        this->droppedCount          = 0;
+        this->transferErrorCount    = 0;
+
+        // every frame takes a whole aligned slot of spidev's buffers, so both limits are checked
+        size_t maxSegments = BlackSPI::getMaximumMessageSize() / BlackSPI::getAlignedTransferLength(SPI_ADC_FRAME_SIZE);
+        if( maxSegments > SPI_MAX_MESSAGE_SEGMENTS )
+        {
+            maxSegments = SPI_MAX_MESSAGE_SEGMENTS;
+        }
+
+        size_t maxRepeats = maxSegments / this->sequenceLength;
+        if( maxRepeats == 0 )
+        {
+            maxRepeats = 1;
+        }
+
+        this->repeats = (repeatCount == 0) ? 1 : repeatCount;
+        if( this->repeats > maxRepeats )
+        {
+            this->repeats = maxRepeats;
+        }
+
+
+        size_t frameCount = this->sequenceLength * this->repeats;
+
+        this->commandFrames.assign(frameCount * SPI_ADC_FRAME_SIZE, 0x00);
+        this->responseFrames.assign(frameCount * SPI_ADC_FRAME_SIZE, 0x00);
+        this->decodedValues.assign(frameCount, 0);
+
+        for( size_t i = 0 ; i < frameCount ; i++ )
+        {
+            uint8_t channel = (channels == NULL or channelCount == 0) ? 0 : (channels[i % this->sequenceLength] & 0x07);
+            uint8_t *frame  = &(this->commandFrames[i * SPI_ADC_FRAME_SIZE]);
+
+            if( model == MCP3208 )
+            {
+                frame[0] = 0x06 | (channel >> 2);           // start bit, single-ended, D2
+                frame[1] = (channel & 0x03) << 6;           // D1, D0
+            }
+            else
+            {
+                frame[0] = 0x01;                            // start bit
+                frame[1] = 0x80 | (channel << 4);           // single-ended, D2, D1, D0
+            }
+        }
+
+        // every conversion is started by falling edge of chip select, so it is toggled between frames
+        for( size_t i = 0 ; i < frameCount ; i++ )
+        {
+            this->transaction.addSegment( &(this->commandFrames[i * SPI_ADC_FRAME_SIZE]),
+                                          &(this->responseFrames[i * SPI_ADC_FRAME_SIZE]),
+                                          SPI_ADC_FRAME_SIZE, 0, 0, 0, (i + 1 < frameCount) );
+        }
+
+
+        size_t capacity = 2;
+        while( capacity < bufferSize or capacity < 2 * this->repeats )
+        {
+            capacity <<= 1;
+        }
+
+        this->ringSize  = capacity;
+        this->ringMask  = capacity - 1;
+        this->ringBuffer.assign(capacity * this->sequenceLength, 0);
+    }
+
+    BlackSPIADC::~BlackSPIADC()
+    {
+    }
+
+    void        BlackSPIADC::decodeFrames()
+    {
+        const uint8_t  *frames  = &(this->responseFrames[0]);
+        uint16_t       *values  = &(this->decodedValues[0]);
+        const uint16_t  mask    = this->resultMask;
+        const size_t    count   = this->decodedValues.size();
+        size_t          i       = 0;
+
+#if defined(__ARM_NEON__)
+        // 8 frames per step: frame bytes are de-interleaved by the load, so result bytes are whole vectors
+        const uint16x8_t maskVector = vdupq_n_u16(mask);
+        for( ; i + 8 <= count ; i += 8 )
+        {
+            uint8x8x3_t frame   = vld3_u8(frames + i * SPI_ADC_FRAME_SIZE);
+            uint16x8_t  value   = vorrq_u16( vshll_n_u8(frame.val[1], 8), vmovl_u8(frame.val[2]) );
+
+            vst1q_u16(values + i, vandq_u16(value, maskVector));
+        }
+#endif
+
+        for( ; i < count ; i++ )
+        {
+            values[i] = static_cast<uint16_t>( ((frames[i * SPI_ADC_FRAME_SIZE + 1] << 8) |
+                                                 frames[i * SPI_ADC_FRAME_SIZE + 2]) & mask );
+        }
+    }
+
+    bool        BlackSPIADC::onTickHandler(uint64_t)
+    {
+        if( not this->spiObject->transfer(this->transaction) )
+        {
+            this->transferErrorCount = this->transferErrorCount + 1;
+            return true;
+        }
+
+        size_t currentWrite = this->writeIndex;
+
+        if( currentWrite - this->readIndex + this->repeats > this->ringSize )
+        {
+            this->droppedCount = this->droppedCount + this->repeats;
+            return true;
+        }
+
+        this->decodeFrames();
+
+        // slots must be released by consumer before they are overwritten
+        __sync_synchronize();
+
+        const uint16_t *values = &(this->decodedValues[0]);
+
+        for( uint8_t channel = 0 ; channel < this->sequenceLength ; channel++ )
+        {
+            uint16_t *ring = &(this->ringBuffer[channel * this->ringSize]);
+
+            for( uint32_t i = 0 ; i < this->repeats ; i++ )
+            {
+                ring[(currentWrite + i) & this->ringMask] = values[i * this->sequenceLength + channel];
+            }
+        }
+
+        // samples must be visible before the index which publishes them
+        __sync_synchronize();
+        this->writeIndex = currentWrite + this->repeats;
+
+        return true;
+    }
+
+    size_t      BlackSPIADC::readSamples(uint16_t *const *outputs, size_t maxCount)
+    {
+        size_t currentRead  = this->readIndex;
+        size_t available    = this->writeIndex - currentRead;
+        size_t count        = (available < maxCount) ? available : maxCount;
+
+        // index must be read before the samples which it publishes
+        __sync_synchronize();
+
+        for( uint8_t channel = 0 ; channel < this->sequenceLength ; channel++ )
+        {
+            const uint16_t *ring    = &(this->ringBuffer[channel * this->ringSize]);
+            uint16_t *output        = outputs[channel];
+
+            for( size_t i = 0 ; i < count ; i++ )
+            {
+                output[i] = ring[(currentRead + i) & this->ringMask];
+            }
+        }
+
+        // samples must be copied before their slots are released
+        __sync_synchronize();
+        this->readIndex = currentRead + count;
+
+        return count;
+    }
+
+    size_t      BlackSPIADC::getAvailableCount()
+    {
+        return ( this->writeIndex - this->readIndex );
+    }
+
+    uint64_t    BlackSPIADC::getDroppedCount()
+    {
+        return this->droppedCount;
+    }
+
+    uint64_t    BlackSPIADC::getTransferErrorCount()
+    {
+        return this->transferErrorCount;
+    }
+
+    uint8_t     BlackSPIADC::getChannelCount()
+    {
+        return this->sequenceLength;
+    }
+
+    uint32_t    BlackSPIADC::getRepeatCount()
+    {
+        return this->repeats;
+    }
+
+    uint16_t    BlackSPIADC::getMaximumValue()
+    {
+        return this->resultMask;
+    }
+
+    // ############################################ BLACKSPIADC DEFINITION ENDS ############################################# //
+
+} /* namespace BlackLib */
@@ -0,0 +1,208 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKSPIADC_H_
+#define BLACKSPIADC_H_
+
+#include "../BlackSPI/BlackSPI.h"
+#include "../BlackThread/BlackThread.h"
+
+#include <vector>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting the converter family of BlackSPIADC.
+    */
+    enum spiAdcModel        {   MCP3008                 = 0,    /*!< 10 bit, MCP3004 and MCP3008 */
+                                MCP3208                 = 1     /*!< 12 bit, MCP3204 and MCP3208 */
+                            };
+
+    const size_t            SPI_ADC_FRAME_SIZE          = 3;        //!< Byte count of one conversion frame of supported converters
+    const uint8_t           SPI_ADC_MAX_CHANNEL         = 8;        //!< Channel count of the biggest supported converter
+
+
+
+
+
+    // ########################################### BLACKSPIADC DECLARATION STARTS ############################################ //
+
+    /*! @brief Streams conversions of an external spi adc to per-channel ring buffers.
+     *
+     *    This class is derived from BlackPeriodicThread class. Command frames of the whole channel sequence
+     *    are built once at construction, and the sequence is repeated several times in one transaction. So
+     *    every tick sends many conversions with one SPI_IOC_MESSAGE(n) request and chip select is toggled
+     *    between frames by the kernel, without returning to user space. Received frames are decoded 8 at a
+     *    time with NEON instructions when the library is compiled with NEON support (-mfpu=neon), else
+     *    with a scalar loop, and the results are appended to one ring buffer per channel.
+     *
+     *    Channels are converted in round-robin order, so the samples which have the same index at
+     *    different channels are taken within one sequence time. Consumer thread reads the samples of all
+     *    channels together without locking. If ring buffers don't have enough space, samples of the tick
+     *    are dropped and counted.
+     *
+     *    Spi device must be opened before the thread runs, and it must not be used by other threads while
+     *    the thread runs. Timing statistics can be read with getStatistics() function.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: mySpiAdcProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackSPIADC/BlackSPIADC.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiMode0, 3600000);
+     *      mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+     *
+     *      uint8_t channels[2] = { 0, 3 };
+     *
+     *      // 32 conversions of every channel at every 1 ms, so 32 kS/s per channel
+     *      BlackLib::BlackSPIADC myAdc(&mySpi, BlackLib::MCP3008, channels, 2, 32, 1, BlackLib::milisecond);
+     *      myAdc.run();
+     *
+     *      uint16_t first[256];
+     *      uint16_t second[256];
+     *      uint16_t *outputs[2] = { first, second };
+     *
+     *      for( int i = 0 ; i < 100 ; i++ )
+     *      {
+     *          usleep(10000);
+     *          size_t count = myAdc.readSamples(outputs, 256);
+     *          if( count > 0 )
+     *          {
+     *              std::cout << count << " samples, last: " << first[count-1] << " " << second[count-1] << std::endl;
+     *          }
+     *      }
+     *
+     *      myAdc.requestStop();
+     *      WAIT_THREAD_FINISH(&myAdc)
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackSPIADC : public BlackPeriodicThread
+    {
+        public:
+
+            /*! @brief Constructor of BlackSPIADC class.
+            *
+            * This function builds command frames and spi transaction. Repeat count is limited so the
+            * transaction doesn't exceed the segment limit of one kernel request, or spidev's message size
+            * limit after every frame is rounded up by BlackSPI::getAlignedTransferLength().
+            *
+            * @param [in] spi               opened spi device which the converter is connected
+            * @param [in] model             converter family (enum)
+            * @param [in] channels          channel sequence, every item must be smaller than 8
+            * @param [in] channelCount      item count of channel sequence
+            * @param [in] repeatCount       conversion count of every channel at every tick
+            * @param [in] interval          tick interval
+            * @param [in] tType             time type of tick interval (enum)
+            * @param [in] bufferSize        ring buffer capacity per channel, rounded up to power of two
+            */
+                                BlackSPIADC(BlackSPI *spi, spiAdcModel model, const uint8_t *channels, uint8_t channelCount,
+                                            uint32_t repeatCount, uint64_t interval, timeType tType = microsecond,
+                                            size_t bufferSize = 4096);
+
+            /*! @brief Destructor of BlackSPIADC class.
+            */
+            virtual             ~BlackSPIADC();
+
+            /*! @brief Reads the oldest samples of all channels.
+            *
+            * @param [out] outputs      one destination array for every channel, in sequence order
+            * @param [in] maxCount      capacity of every destination array
+            * @return number of samples which are written to every array.
+            */
+            size_t              readSamples(uint16_t *const *outputs, size_t maxCount);
+
+            /*! @brief Exports number of samples per channel at ring buffers.
+            */
+            size_t              getAvailableCount();
+
+            /*! @brief Exports number of dropped samples per channel because of full ring buffers.
+            */
+            uint64_t            getDroppedCount();
+
+            /*! @brief Exports number of failed spi transactions.
+            */
+            uint64_t            getTransferErrorCount();
+
+            /*! @brief Exports item count of channel sequence.
+            */
+            uint8_t             getChannelCount();
+
+            /*! @brief Exports conversion count of every channel at every tick, after limiting.
+            */
+            uint32_t            getRepeatCount();
+
+            /*! @brief Exports maximum output value of converter.
+            */
+            uint16_t            getMaximumValue();
+
+        private:
+            BlackSPI           *spiObject;              /*!< @brief is used to hold the spi device */
+            uint8_t             sequenceLength;         /*!< @brief is used to hold the item count of channel sequence */
+            uint32_t            repeats;                /*!< @brief is used to hold the conversion count of every channel at every tick */
+            uint16_t            resultMask;             /*!< @brief is used to hold the valid bits of result field */
+            std::vector<uint8_t> commandFrames;         /*!< @brief is used to hold the precomputed command frames */
+            std::vector<uint8_t> responseFrames;        /*!< @brief is used to hold the received frames */
+            std::vector<uint16_t> decodedValues;        /*!< @brief is used to hold the decoded values in conversion order */
+            BlackSPITransaction transaction;            /*!< @brief is used to hold the prebuilt segments of all frames */
+
+            std::vector<uint16_t> ringBuffer;           /*!< @brief is used to hold the samples, one ring after another for every channel */
+            size_t              ringSize;               /*!< @brief is used to hold the ring capacity per channel */
+            size_t              ringMask;               /*!< @brief is used to hold the ring index mask */
+            volatile size_t     writeIndex;             /*!< @brief is used to hold the producer index, written only by sampler thread */
+            volatile size_t     readIndex;              /*!< @brief is used to hold the consumer index, written only by consumer thread */
+            volatile uint64_t   droppedCount;           /*!< @brief is used to hold the number of dropped samples */
+            volatile uint64_t   transferErrorCount;     /*!< @brief is used to hold the number of failed transactions */
+
+            /*! @brief Decodes result fields of received frames.
+            */
+            void                decodeFrames();
+
+            /*! @brief Sends the transaction, decodes it and pushes the samples to ring buffers.
+            */
+            bool                onTickHandler(uint64_t tick);
+    };
+    // ############################################ BLACKSPIADC DECLARATION ENDS ############################################# //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKSPIADC_H_ */
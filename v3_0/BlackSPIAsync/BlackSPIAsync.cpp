@@ -0,0 +1,310 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackSPIAsync.h"
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackSPIAsync::BlackSPIAsync()
+    {
+        this->isMergeEnabled    = true;
+        this->isFinishRequested = false;
+
+        this->batch.reserve(8);
+
+        pthread_mutex_init( &(this->queueMutex), NULL);
+        pthread_cond_init( &(this->queueCondition), NULL);
+    }
+
+    BlackSPIAsync::~BlackSPIAsync()
+    {
+        this->finish();
+
+        while( not this->requestQueue.empty() )
+        {
+            if( this->requestQueue.front().future != NULL )
+            {
+                this->requestQueue.front().future->complete(false);
+            }
+            this->requestQueue.pop_front();
+        }
+
+        pthread_cond_destroy( &(this->queueCondition) );
+        pthread_mutex_destroy( &(this->queueMutex) );
+    }
+
+    bool BlackSPIAsync::submit(BlackSPI *device, BlackSPITransaction *transaction, BlackFuture *future)
+    {
+        if( device == NULL or transaction == NULL or transaction->getSegmentCount() == 0 )
+        {
+            return false;
+        }
+
+        asyncRequest request;
+        request.device      = device;
+        request.transaction = transaction;
+        request.future      = future;
+
+        pthread_mutex_lock( &(this->queueMutex) );
+
+        if( this->isFinishRequested )
+        {
+            pthread_mutex_unlock( &(this->queueMutex) );
+            return false;
+        }
+
+        if( future != NULL )
+        {
+            future->reset();
+        }
+
+        this->requestQueue.push_back(request);
+
+        if( this->requestQueue.size() > this->statistics.maxQueueDepth )
+        {
+            this->statistics.maxQueueDepth = this->requestQueue.size();
+        }
+
+        pthread_cond_signal( &(this->queueCondition) );
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return true;
+    }
+
+    void BlackSPIAsync::setMerging(bool isEnabled)
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        this->isMergeEnabled = isEnabled;
+        pthread_mutex_unlock( &(this->queueMutex) );
+    }
+
+    bool BlackSPIAsync::getMerging()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        bool temp = this->isMergeEnabled;
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return temp;
+    }
+
+    size_t BlackSPIAsync::getPendingCount()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        size_t temp = this->requestQueue.size();
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return temp;
+    }
+
+    BlackSPIAsyncStatistics BlackSPIAsync::getStatistics()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        BlackSPIAsyncStatistics temp = this->statistics;
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        return temp;
+    }
+
+    void BlackSPIAsync::resetStatistics()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        this->statistics = BlackSPIAsyncStatistics();
+        pthread_mutex_unlock( &(this->queueMutex) );
+    }
+
+    void BlackSPIAsync::finish()
+    {
+        pthread_mutex_lock( &(this->queueMutex) );
+        this->isFinishRequested = true;
+        pthread_cond_broadcast( &(this->queueCondition) );
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+        // flag stays set, so later submits fail instead of waiting for a thread which doesn't exist
+        this->waitUntilFinish();
+    }
+
+    bool BlackSPIAsync::isMergeable(BlackSPITransaction *transaction, uint32_t speed, uint8_t bitsPerWord,
+                                    size_t segmentCount, size_t totalLength)
+    {
+        size_t count = transaction->getSegmentCount();
+
+        if( count == 0 or segmentCount + count > SPI_MAX_MESSAGE_SEGMENTS )
+        {
+            return false;
+        }
+
+        if( transaction->getSegment(count - 1).cs_change != 0 )
+        {
+            return false;
+        }
+
+        for( size_t i = 0 ; i < count ; i++ )
+        {
+            const spi_ioc_transfer &segment = transaction->getSegment(i);
+
+            if( segment.speed_hz != speed or segment.bits_per_word != bitsPerWord )
+            {
+                return false;
+            }
+        }
+
+        return ( totalLength + transaction->getTotalLength() <= BlackSPI::getMaximumMessageSize() );
+    }
+
+    void BlackSPIAsync::collectBatch()
+    {
+        this->batch.clear();
+        this->batch.push_back( this->requestQueue.front() );
+        this->requestQueue.pop_front();
+
+        if( not this->isMergeEnabled )
+        {
+            return;
+        }
+
+        BlackSPI *device                = this->batch[0].device;
+        BlackSPITransaction *first      = this->batch[0].transaction;
+        uint32_t speed                  = first->getSegment(0).speed_hz;
+        uint8_t bitsPerWord             = first->getSegment(0).bits_per_word;
+
+        if( not this->isMergeable(first, speed, bitsPerWord, 0, 0) )
+        {
+            return;
+        }
+
+        size_t segmentCount             = first->getSegmentCount();
+        size_t totalLength              = first->getTotalLength();
+
+        std::deque<asyncRequest>::iterator iter = this->requestQueue.begin();
+        while( iter != this->requestQueue.end() )
+        {
+            if( iter->device != device )
+            {
+                ++iter;
+                continue;
+            }
+
+            // the first incompatible request of same device ends the batch, so device order is kept
+            if( not this->isMergeable(iter->transaction, speed, bitsPerWord, segmentCount, totalLength) )
+            {
+                break;
+            }
+
+            segmentCount   += iter->transaction->getSegmentCount();
+            totalLength    += iter->transaction->getTotalLength();
+
+            this->batch.push_back(*iter);
+            iter = this->requestQueue.erase(iter);
+        }
+    }
+
+    void BlackSPIAsync::executeBatch()
+    {
+        bool result;
+
+        if( this->batch.size() == 1 )
+        {
+            result = this->batch[0].device->transfer( *(this->batch[0].transaction) );
+        }
+        else
+        {
+            this->mergedTransaction.clear();
+
+            for( size_t i = 0 ; i < this->batch.size() ; i++ )
+            {
+                this->mergedTransaction.append( *(this->batch[i].transaction) );
+
+                if( i + 1 < this->batch.size() )
+                {
+                    this->mergedTransaction.getSegment( this->mergedTransaction.getSegmentCount() - 1 ).cs_change = 1;
+                }
+            }
+
+            result = this->batch[0].device->transfer( this->mergedTransaction );
+        }
+
+
+        pthread_mutex_lock( &(this->queueMutex) );
+
+        this->statistics.transactionCount  += this->batch.size();
+        this->statistics.mergedCount       += this->batch.size() - 1;
+        ++(this->statistics.messageCount);
+
+        if( not result )
+        {
+            this->statistics.failedCount   += this->batch.size();
+        }
+
+        pthread_mutex_unlock( &(this->queueMutex) );
+
+
+        for( size_t i = 0 ; i < this->batch.size() ; i++ )
+        {
+            if( this->batch[i].future != NULL )
+            {
+                this->batch[i].future->complete(result);
+            }
+        }
+    }
+
+    void BlackSPIAsync::onStartHandler()
+    {
+        while( true )
+        {
+            pthread_mutex_lock( &(this->queueMutex) );
+
+            while( this->requestQueue.empty() and not this->isFinishRequested )
+            {
+                pthread_cond_wait( &(this->queueCondition), &(this->queueMutex) );
+            }
+
+            if( this->requestQueue.empty() )
+            {
+                pthread_mutex_unlock( &(this->queueMutex) );
+                break;
+            }
+
+            this->collectBatch();
+
+            pthread_mutex_unlock( &(this->queueMutex) );
+
+            this->executeBatch();
+        }
+    }
+
+
+
+} /* namespace BlackLib */
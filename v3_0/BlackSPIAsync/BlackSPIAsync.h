@@ -0,0 +1,271 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKSPIASYNC_H_
+#define BLACKSPIASYNC_H_
+
+#include "../BlackSPI/BlackSPI.h"
+#include "../BlackThread/BlackThread.h"
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+
+
+
+namespace BlackLib
+{
+
+    // ##################################### BLACKSPIASYNCSTATISTICS DECLARATION STARTS ###################################### //
+
+    /*! @brief Holds counters of BlackSPIAsync class.
+    *
+    *    The difference between transaction count and message count shows the saved
+    *    SPI_IOC_MESSAGE requests.
+    */
+    struct BlackSPIAsyncStatistics
+    {
+        uint64_t    transactionCount;   /*!< @brief is used to hold the number of completed transactions */
+        uint64_t    messageCount;       /*!< @brief is used to hold the number of messages which are passed to spi device */
+        uint64_t    mergedCount;        /*!< @brief is used to hold the number of transactions which are merged into other messages */
+        uint64_t    failedCount;        /*!< @brief is used to hold the number of failed transactions */
+        size_t      maxQueueDepth;      /*!< @brief is used to hold the maximum number of waiting transactions */
+
+        /*! @brief Default constructor of BlackSPIAsyncStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackSPIAsyncStatistics()
+        {
+            transactionCount    = 0;
+            messageCount        = 0;
+            mergedCount         = 0;
+            failedCount         = 0;
+            maxQueueDepth       = 0;
+        }
+    };
+    // ###################################### BLACKSPIASYNCSTATISTICS DECLARATION ENDS ####################################### //
+
+
+
+
+
+
+
+
+
+
+    // ########################################## BLACKSPIASYNC DECLARATION STARTS ########################################### //
+
+    /*! @brief Executes spi transactions at a dedicated worker thread.
+     *
+     *    This class is used for sending spi transactions without blocking the caller. Transactions are
+     *    queued with submit() function and executed in submission order by the worker thread. Completion
+     *    is reported with BlackFuture handles, so callers can poll, block or get a callback.
+     *
+     *    If merging is enabled, consecutive queued transactions of the same spi device are combined into
+     *    one multi-segment message and sent with one SPI_IOC_MESSAGE(n) request. Chip select is released
+     *    between merged transactions, so the device sees the same frames. Only transactions which use the
+     *    same speed and word size are merged, and the merged message never exceeds spidev's segment and
+     *    size limits. Transactions which keep chip select active at their end are never merged. Because a
+     *    merged message is sent with one request, all merged transactions take the same result.
+     *
+     *    Transactions of different devices keep their submission order for each device. Transaction
+     *    objects, their buffers and future handles must stay valid until the transaction is completed.
+     *
+     *    @warning While transactions are queued, spi devices must not be used directly from other threads.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: mySpiAsyncProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackSPIAsync/BlackSPIAsync.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiDefault, 2400000);
+     *      mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+     *
+     *      BlackLib::BlackSPIAsync worker;
+     *      worker.run();
+     *
+     *      uint8_t writeArr[4][3] = { {0x01,0x80,0x00}, {0x01,0x90,0x00}, {0x01,0xA0,0x00}, {0x01,0xB0,0x00} };
+     *      uint8_t readArr[4][3];
+     *
+     *      BlackLib::BlackSPITransaction   transactions[4];
+     *      BlackLib::BlackFuture           futures[4];
+     *
+     *      for( int i = 0 ; i < 4 ; i++ )
+     *      {
+     *          transactions[i].addSegment(writeArr[i], readArr[i], 3);
+     *          worker.submit(&mySpi, &transactions[i], &futures[i]);
+     *      }
+     *
+     *      // ... other jobs ...
+     *
+     *      for( int i = 0 ; i < 4 ; i++ )
+     *      {
+     *          if( futures[i].wait() )
+     *          {
+     *              std::cout << "Channel " << i << ": " << (((readArr[i][1] & 0x03) << 8) | readArr[i][2]) << std::endl;
+     *          }
+     *      }
+     *
+     *      worker.finish();
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackSPIAsync : public BlackThread
+    {
+        private:
+
+            /*! @brief Holds one queued request.
+            */
+            struct asyncRequest
+            {
+                BlackSPI                   *device;             /*!< @brief is used to hold the target spi device */
+                BlackSPITransaction        *transaction;        /*!< @brief is used to hold the queued transaction */
+                BlackFuture                *future;             /*!< @brief is used to hold the completion handle, can be NULL */
+            };
+
+            std::deque<asyncRequest>        requestQueue;       /*!< @brief is used to hold the waiting requests */
+            std::vector<asyncRequest>       batch;              /*!< @brief is used to hold the requests which are sent with one message */
+            BlackSPITransaction             mergedTransaction;  /*!< @brief is used to build merged messages without allocation at steady state */
+            BlackSPIAsyncStatistics         statistics;         /*!< @brief is used to hold the counters of worker */
+            pthread_mutex_t                 queueMutex;         /*!< @brief is used to protect the queue and the counters */
+            pthread_cond_t                  queueCondition;     /*!< @brief is used to wake up the worker thread */
+            bool                            isMergeEnabled;     /*!< @brief is used to hold the merging state */
+            bool                            isFinishRequested;  /*!< @brief is used to hold the finish request of worker */
+
+            /*! @brief Checks a transaction can be merged into current batch.
+            *
+            * @param [in] transaction       candidate transaction
+            * @param [in] speed             speed of first segment of batch
+            * @param [in] bitsPerWord       word size of first segment of batch
+            * @param [in] segmentCount      current segment count of batch
+            * @param [in] totalLength       current total length of batch
+            * @return true if transaction is compatible, else false.
+            */
+            bool                            isMergeable(BlackSPITransaction *transaction, uint32_t speed, uint8_t bitsPerWord,
+                                                        size_t segmentCount, size_t totalLength);
+
+            /*! @brief Takes the next request and the compatible requests from queue.
+            *
+            * This function must be called while the queue mutex is locked.
+            */
+            void                            collectBatch();
+
+            /*! @brief Sends current batch and completes its futures.
+            *
+            */
+            void                            executeBatch();
+
+            /*! @brief Thread's start handler function.
+            *
+            *  This function waits for requests and executes them until finish is requested and
+            *  the queue is empty. Users should not call this function directly.
+            */
+            void                            onStartHandler();
+
+
+
+        public:
+
+            /*! @brief Constructor of BlackSPIAsync class.
+            *
+            * This function initializes the queue. Merging is enabled by default. Worker thread is
+            * started with run() function; transactions which are submitted before, wait in the queue.
+            */
+                                            BlackSPIAsync();
+
+            /*! @brief Destructor of BlackSPIAsync class.
+            *
+            * This function executes the waiting transactions and waits the worker thread.
+            */
+            virtual                         ~BlackSPIAsync();
+
+            /*! @brief Queues a transaction.
+            *
+            * This function returns immediately. If future handle is passed, it is marked as pending
+            * and it is completed after the transaction is sent.
+            *
+            * @param [in] device            target spi device, it must be opened
+            * @param [in] transaction       transaction which will be sent
+            * @param [in] future            completion handle, can be NULL
+            * @return true if transaction is queued, else false.
+            */
+            bool                            submit(BlackSPI *device, BlackSPITransaction *transaction, BlackFuture *future = NULL);
+
+            /*! @brief Enables or disables merging of queued transactions.
+            *
+            * @param [in] isEnabled         new merging state
+            */
+            void                            setMerging(bool isEnabled);
+
+            /*! @brief Exports merging state.
+            *
+            * @return true if merging is enabled, else false.
+            */
+            bool                            getMerging();
+
+            /*! @brief Exports the number of waiting transactions.
+            *
+            */
+            size_t                          getPendingCount();
+
+            /*! @brief Exports the counters of worker.
+            *
+            * @return copy of BlackSPIAsyncStatistics struct.
+            */
+            BlackSPIAsyncStatistics         getStatistics();
+
+            /*! @brief Clears the counters of worker.
+            *
+            */
+            void                            resetStatistics();
+
+            /*! @brief Executes the waiting transactions and finishes the worker thread.
+            *
+            * This function blocks the caller until the worker thread is finished. New transactions
+            * are rejected after this function is called, submit() returns false.
+            */
+            void                            finish();
+    };
+    // ########################################### BLACKSPIASYNC DECLARATION ENDS ############################################ //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKSPIASYNC_H_ */
@@ -0,0 +1,266 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackSPIBus.h"
+
+
+
+
+
+namespace BlackLib
+{
+
+    BlackSPIBus::BlackSPIBus(spiBusName bus, uint openMode)
+    {
+        this->busName       = bus;
+        this->portOpenMode  = openMode;
+        this->lastDevice    = NULL;
+
+        for( uint8_t i = 0 ; i < SPI_BUS_CHIP_SELECT_COUNT ; i++ )
+        {
+            this->ports[i] = NULL;
+        }
+
+        pthread_mutex_init( &(this->busMutex), NULL);
+    }
+
+    BlackSPIBus::~BlackSPIBus()
+    {
+        for( uint8_t i = 0 ; i < SPI_BUS_CHIP_SELECT_COUNT ; i++ )
+        {
+            if( this->ports[i] != NULL )
+            {
+                delete this->ports[i];
+            }
+        }
+
+        pthread_mutex_destroy( &(this->busMutex) );
+    }
+
+    BlackSPI *BlackSPIBus::getPort(uint8_t chipSelect)
+    {
+        if( chipSelect >= SPI_BUS_CHIP_SELECT_COUNT )
+        {
+            return NULL;
+        }
+
+        if( this->ports[chipSelect] == NULL )
+        {
+            spiName name = static_cast<spiName>( static_cast<int>(this->busName) * SPI_BUS_CHIP_SELECT_COUNT + chipSelect );
+            this->ports[chipSelect] = new BlackSPI(name);
+        }
+
+        if( not this->ports[chipSelect]->isOpen() )
+        {
+            // default properties are read once here and they are used as cache after
+            if( not this->ports[chipSelect]->open(this->portOpenMode) )
+            {
+                return NULL;
+            }
+        }
+
+        return this->ports[chipSelect];
+    }
+
+    BlackSPI *BlackSPIBus::lock(const BlackSPIBusDevice &device)
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+
+        BlackSPI *port = this->getPort( device.getChipSelect() );
+
+        if( port == NULL )
+        {
+            pthread_mutex_unlock( &(this->busMutex) );
+            return NULL;
+        }
+
+        BlackSpiProperties wanted = device.getProperties();
+        BlackSpiProperties cached = port->getCachedProperties();
+
+        uint64_t writeCount = 0;
+        if( wanted.spiBitsPerWord != cached.spiBitsPerWord )    { ++writeCount; }
+        if( wanted.spiSpeed       != cached.spiSpeed )          { ++writeCount; }
+        if( wanted.spiMode        != cached.spiMode )           { ++writeCount; }
+
+        this->statistics.propertyWriteCount    += writeCount;
+        this->statistics.propertySkipCount     += 3 - writeCount;
+
+        if( writeCount > 0 and not port->updateProperties(wanted) )
+        {
+            pthread_mutex_unlock( &(this->busMutex) );
+            return NULL;
+        }
+
+        ++(this->statistics.transferCount);
+
+        if( this->lastDevice != &device )
+        {
+            ++(this->statistics.deviceSwitchCount);
+            this->lastDevice = &device;
+        }
+
+        return port;
+    }
+
+    void BlackSPIBus::unlock()
+    {
+        pthread_mutex_unlock( &(this->busMutex) );
+    }
+
+    spiBusName BlackSPIBus::getBusName()
+    {
+        return this->busName;
+    }
+
+    BlackSPIBusStatistics BlackSPIBus::getStatistics()
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+        BlackSPIBusStatistics temp = this->statistics;
+        pthread_mutex_unlock( &(this->busMutex) );
+
+        return temp;
+    }
+
+    void BlackSPIBus::resetStatistics()
+    {
+        pthread_mutex_lock( &(this->busMutex) );
+        this->statistics = BlackSPIBusStatistics();
+        pthread_mutex_unlock( &(this->busMutex) );
+    }
+
+
+
+
+
+
+
+
+
+    BlackSPIBusDevice::BlackSPIBusDevice(BlackSPIBus &ownerBus, uint8_t cs, BlackSpiProperties deviceProperties)
+    {
+        this->bus           = &ownerBus;
+        this->chipSelect    = cs;
+        this->properties    = deviceProperties;
+    }
+
+    void BlackSPIBusDevice::setProperties(const BlackSpiProperties &deviceProperties)
+    {
+        this->properties = deviceProperties;
+    }
+
+    BlackSpiProperties BlackSPIBusDevice::getProperties() const
+    {
+        return this->properties;
+    }
+
+    uint8_t BlackSPIBusDevice::getChipSelect() const
+    {
+        return this->chipSelect;
+    }
+
+    bool BlackSPIBusDevice::transfer(uint8_t *writeBuffer, uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us)
+    {
+        BlackSPI *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->transfer(writeBuffer, readBuffer, bufferSize, wait_us);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackSPIBusDevice::transfer(uint8_t *buffer, size_t bufferSize, uint16_t wait_us)
+    {
+        BlackSPI *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->transfer(buffer, bufferSize, wait_us);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackSPIBusDevice::transfer(BlackSPITransaction &transaction)
+    {
+        BlackSPI *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->transfer(transaction);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackSPIBusDevice::write(const uint8_t *writeBuffer, size_t bufferSize, uint16_t wait_us)
+    {
+        BlackSPI *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->write(writeBuffer, bufferSize, wait_us);
+        this->bus->unlock();
+
+        return result;
+    }
+
+    bool BlackSPIBusDevice::read(uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us)
+    {
+        BlackSPI *port = this->bus->lock(*this);
+
+        if( port == NULL )
+        {
+            return false;
+        }
+
+        bool result = port->read(readBuffer, bufferSize, wait_us);
+        this->bus->unlock();
+
+        return result;
+    }
+
+
+
+} /* namespace BlackLib */
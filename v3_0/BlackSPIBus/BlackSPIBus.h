@@ -0,0 +1,291 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKSPIBUS_H_
+#define BLACKSPIBUS_H_
+
+#include "../BlackSPI/BlackSPI.h"
+
+#include <pthread.h>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for setting spi bus name.
+    */
+    enum spiBusName         {   SPIBUS0                 = 0,
+                                SPIBUS1                 = 1
+                            };
+
+    const uint8_t           SPI_BUS_CHIP_SELECT_COUNT   = 2;        //!< Chip select count of every spi bus
+
+
+
+
+
+    // ###################################### BLACKSPIBUSSTATISTICS DECLARATION STARTS ####################################### //
+
+    /*! @brief Holds counters of BlackSPIBus class.
+    *
+    *    Property write and skip counts are counted for every field (word size, speed and mode).
+    */
+    struct BlackSPIBusStatistics
+    {
+        uint64_t    transferCount;          /*!< @brief is used to hold the number of locked bus accesses */
+        uint64_t    deviceSwitchCount;      /*!< @brief is used to hold the number of accesses which use another device than the previous one */
+        uint64_t    propertyWriteCount;     /*!< @brief is used to hold the number of issued property ioctls */
+        uint64_t    propertySkipCount;      /*!< @brief is used to hold the number of property ioctls which are skipped because of cache */
+
+        /*! @brief Default constructor of BlackSPIBusStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackSPIBusStatistics()
+        {
+            transferCount       = 0;
+            deviceSwitchCount   = 0;
+            propertyWriteCount  = 0;
+            propertySkipCount   = 0;
+        }
+    };
+    // ####################################### BLACKSPIBUSSTATISTICS DECLARATION ENDS ######################################## //
+
+
+
+
+
+    class BlackSPIBusDevice;
+
+    // ########################################### BLACKSPIBUS DECLARATION STARTS ############################################ //
+
+    /*! @brief Shares one spi bus between many devices and threads.
+     *
+     *    This class opens every spidev file of the bus only once, when the first device of that chip
+     *    select is used. The last written mode, speed and word size values of every spidev file are
+     *    cached. When a device accesses the bus, only the fields which differ from cached values are
+     *    written with ioctl requests, so devices which share the same chip select with different
+     *    settings, or devices which use the same settings, don't pay for redundant requests.
+     *
+     *    Every access is done while the bus lock is held, so settings of one device can't be changed
+     *    by another thread in the middle of its transfer. The lock is held only for property ioctls
+     *    and the transfer itself; buffers and transactions should be prepared before the access.
+     *
+     *    Devices are represented with lightweight BlackSPIBusDevice objects.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: mySpiBusProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackSPIBus/BlackSPIBus.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackSPIBus       bus(BlackLib::SPIBUS0);
+     *
+     *      BlackLib::BlackSPIBusDevice adc(bus, 0, BlackLib::BlackSpiProperties(8, BlackLib::SpiMode0, 2000000));
+     *      BlackLib::BlackSPIBusDevice dac(bus, 0, BlackLib::BlackSpiProperties(8, BlackLib::SpiMode1, 10000000));
+     *
+     *      uint8_t writeArr[3] = { 0x01, 0x80, 0x00 };
+     *      uint8_t readArr[3];
+     *
+     *      adc.transfer(writeArr, readArr, sizeof(writeArr));
+     *      adc.transfer(writeArr, readArr, sizeof(writeArr));      // no property ioctl
+     *      dac.write(writeArr, sizeof(writeArr));                  // only mode and speed ioctls
+     *
+     *      std::cout << "Skipped ioctls: " << bus.getStatistics().propertySkipCount << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackSPIBus
+    {
+        private:
+            spiBusName              busName;                                    /*!< @brief is used to hold the spi bus name */
+            uint                    portOpenMode;                               /*!< @brief is used to hold the open mode of spidev files */
+            BlackSPI               *ports[SPI_BUS_CHIP_SELECT_COUNT];           /*!< @brief is used to hold the spidev objects of chip selects */
+            const BlackSPIBusDevice *lastDevice;                                /*!< @brief is used to hold the last device which accessed the bus */
+            BlackSPIBusStatistics   statistics;                                 /*!< @brief is used to hold the counters of bus */
+            pthread_mutex_t         busMutex;                                   /*!< @brief is used to serialize the bus accesses */
+
+            /*! @brief Opens the spidev file of chip select if it isn't opened yet.
+            *
+            * This function must be called while the bus lock is held.
+            */
+            BlackSPI               *getPort(uint8_t chipSelect);
+
+        public:
+
+            /*! @brief Constructor of BlackSPIBus class.
+            *
+            * This function doesn't open any file. Spidev files are opened at first accesses.
+            *
+            * @param [in] bus               spi bus name (enum)
+            * @param [in] openMode          open mode of spidev files
+            */
+                                    BlackSPIBus(spiBusName bus, uint openMode = ReadWrite);
+
+            /*! @brief Destructor of BlackSPIBus class.
+            *
+            * This function closes the opened spidev files. Devices of this bus must not be used after.
+            */
+            virtual                 ~BlackSPIBus();
+
+            /*! @brief Locks the bus for a device and applies its properties.
+            *
+            * This function waits for the bus lock, opens the spidev file of device if needed and
+            * writes only the properties which differ from cached values. If this function returns
+            * a valid pointer, unlock() function must be called after the access. Users can use the
+            * returned object for a group of transfers which must not be interleaved with other
+            * threads. Properties of returned object must not be changed directly.
+            *
+            * @param [in] device            device which accesses the bus
+            * @return pointer of spidev object, or NULL if the file can't open or properties can't set.
+            * In error case, the bus is not locked.
+            */
+            BlackSPI               *lock(const BlackSPIBusDevice &device);
+
+            /*! @brief Releases the bus lock.
+            *
+            */
+            void                    unlock();
+
+            /*! @brief Exports bus name.
+            *
+            */
+            spiBusName              getBusName();
+
+            /*! @brief Exports the counters of bus.
+            *
+            * @return copy of BlackSPIBusStatistics struct.
+            */
+            BlackSPIBusStatistics   getStatistics();
+
+            /*! @brief Clears the counters of bus.
+            *
+            */
+            void                    resetStatistics();
+    };
+    // ############################################ BLACKSPIBUS DECLARATION ENDS ############################################# //
+
+
+
+
+
+
+
+
+
+
+    // ######################################## BLACKSPIBUSDEVICE DECLARATION STARTS ######################################### //
+
+    /*! @brief Lightweight handle of a device which is connected to a BlackSPIBus.
+     *
+     *    This class holds only the chip select and the properties of device. All transfer functions
+     *    lock the bus, apply the differing properties and release the bus after transfer. Objects are
+     *    cheap, so a driver can create a handle for every setting profile of its device.
+     *
+     *    Example usage is shown in BlackSPIBus class.
+     */
+    class BlackSPIBusDevice
+    {
+        private:
+            BlackSPIBus            *bus;                    /*!< @brief is used to hold the owner bus */
+            uint8_t                 chipSelect;             /*!< @brief is used to hold the chip select number */
+            BlackSpiProperties      properties;             /*!< @brief is used to hold the properties of device */
+
+        public:
+
+            /*! @brief Constructor of BlackSPIBusDevice class.
+            *
+            * @param [in] ownerBus          bus which the device is connected
+            * @param [in] cs                chip select number
+            * @param [in] deviceProperties  word size, mode and speed of device
+            */
+                                    BlackSPIBusDevice(BlackSPIBus &ownerBus, uint8_t cs, BlackSpiProperties deviceProperties);
+
+            /*! @brief Changes properties of device.
+            *
+            * This function doesn't issue any request. New properties are applied at next access.
+            */
+            void                    setProperties(const BlackSpiProperties &deviceProperties);
+
+            /*! @brief Exports properties of device.
+            *
+            */
+            BlackSpiProperties      getProperties() const;
+
+            /*! @brief Exports chip select number of device.
+            *
+            */
+            uint8_t                 getChipSelect() const;
+
+            /*! @brief Transfers buffers to/from device.
+            *
+            * @sa BlackSPI::transfer(uint8_t*, uint8_t*, size_t, uint16_t)
+            */
+            bool                    transfer(uint8_t *writeBuffer, uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us = 10);
+
+            /*! @brief Transfers a buffer in place.
+            *
+            * @sa BlackSPI::transfer(uint8_t*, size_t, uint16_t)
+            */
+            bool                    transfer(uint8_t *buffer, size_t bufferSize, uint16_t wait_us = 10);
+
+            /*! @brief Sends a multi-segment transaction.
+            *
+            * @sa BlackSPI::transfer(BlackSPITransaction&)
+            */
+            bool                    transfer(BlackSPITransaction &transaction);
+
+            /*! @brief Writes a buffer and discards received data.
+            *
+            * @sa BlackSPI::write()
+            */
+            bool                    write(const uint8_t *writeBuffer, size_t bufferSize, uint16_t wait_us = 10);
+
+            /*! @brief Sends zeros and reads received data.
+            *
+            * @sa BlackSPI::read()
+            */
+            bool                    read(uint8_t *readBuffer, size_t bufferSize, uint16_t wait_us = 10);
+    };
+    // ######################################### BLACKSPIBUSDEVICE DECLARATION ENDS ########################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKSPIBUS_H_ */
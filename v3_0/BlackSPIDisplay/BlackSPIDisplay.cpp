@@ -0,0 +1,524 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#include "BlackSPIDisplay.h"
+
+#include <cstring>
+#include <unistd.h>
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+
+
+
+
+namespace BlackLib
+{
+
+    // ######################################## BLACKSPIDISPLAY DEFINITION STARTS ######################################### //
+
+    BlackSPIDisplay::BlackSPIDisplay(BlackSPI *spi, BlackGPIO *dataCommandPin, displayController type,
+                                     uint16_t columns, uint16_t rows, BlackGPIO *reset)
+    {
+        this->spiObject         = spi;
+        this->dcPin             = dataCommandPin;
+        this->resetPin          = reset;
+        this->controller        = type;
+        this->width             = (columns == 0) ? 1 : columns;
+        this->height            = (rows == 0) ? 1 : rows;
+        this->offsetX           = 0;
+        this->offsetY           = 0;
+        this->dcState           = -1;
+        this->statisticsStart   = BlackTime::getMonotonicTime();
+
+        this->frame.assign( static_cast<size_t>(this->width) * this->height, 0x0000 );
+        this->dirtyRects.reserve(DISPLAY_MAX_DIRTY_RECTS + 1);
+        this->setChunkSize(DISPLAY_DEFAULT_CHUNK_SIZE);
+    }
+
+    BlackSPIDisplay::~BlackSPIDisplay()
+    {
+    }
+
+    bool        BlackSPIDisplay::setDataMode(bool isData)
+    {
+        int newState = isData ? 1 : 0;
+
+        if( this->dcState == newState )
+        {
+            return true;
+        }
+
+        if( not this->dcPin->setValue( isData ? high : low ) )
+        {
+            this->dcState = -1;
+            return false;
+        }
+
+        this->dcState = newState;
+        return true;
+    }
+
+    bool        BlackSPIDisplay::sendCommand(uint8_t command, const uint8_t *parameters, size_t parameterCount)
+    {
+        if( not this->setDataMode(false) or not this->spiObject->write(&command, 1, 0) )
+        {
+            return false;
+        }
+
+        if( parameters == NULL or parameterCount == 0 )
+        {
+            return true;
+        }
+
+        return ( this->setDataMode(true) and this->spiObject->write(parameters, parameterCount, 0) );
+    }
+
+    bool        BlackSPIDisplay::initialize()
+    {
+        return this->initialize( (this->controller == ILI9341) ? 0x48 : 0x00 );
+    }
+
+    bool        BlackSPIDisplay::initialize(uint8_t memoryAccess)
+    {
+        if( this->resetPin != NULL )
+        {
+            this->resetPin->setValue(high);
+            ::usleep(5000);
+            this->resetPin->setValue(low);
+            ::usleep(20000);
+            this->resetPin->setValue(high);
+            ::usleep(150000);
+        }
+
+        uint8_t pixelFormat = 0x55;                         // 16 bit RGB565 at both interfaces
+
+        if( not this->sendCommand(0x01) )                   // software reset
+        {
+            return false;
+        }
+        ::usleep(150000);
+
+        if( not this->sendCommand(0x11) )                   // sleep out
+        {
+            return false;
+        }
+        ::usleep(120000);
+
+        bool isInitialized = ( this->sendCommand(0x3A, &pixelFormat, 1) and
+                               this->sendCommand(0x36, &memoryAccess, 1) );
+
+        if( isInitialized and this->controller == ST7789 )
+        {
+            isInitialized = this->sendCommand(0x21);        // ST7789 panels need display inversion
+        }
+
+        isInitialized = isInitialized and this->sendCommand(0x13) and this->sendCommand(0x29);
+
+        this->dirtyRects.clear();
+        this->markDirty(0, 0, this->width, this->height);
+
+        return isInitialized;
+    }
+
+    void        BlackSPIDisplay::setWindowOffset(uint16_t x, uint16_t y)
+    {
+        this->offsetX = x;
+        this->offsetY = y;
+    }
+
+    void        BlackSPIDisplay::setChunkSize(size_t bytes)
+    {
+        size_t pixels = bytes / sizeof(uint16_t);
+
+        this->chunkSize = (pixels < this->width) ? this->width : pixels;
+        this->transmitBuffer.resize(this->chunkSize);
+    }
+
+    uint16_t   *BlackSPIDisplay::getFrame()
+    {
+        return &(this->frame[0]);
+    }
+
+    uint16_t    BlackSPIDisplay::getWidth()
+    {
+        return this->width;
+    }
+
+    uint16_t    BlackSPIDisplay::getHeight()
+    {
+        return this->height;
+    }
+
+    bool        BlackSPIDisplay::clip(int x, int y, int w, int h, BlackDisplayRect &rect)
+    {
+        int firstX  = (x < 0) ? 0 : x;
+        int firstY  = (y < 0) ? 0 : y;
+        int lastX   = x + w - 1;
+        int lastY   = y + h - 1;
+
+        if( lastX >= this->width )  { lastX = this->width - 1;  }
+        if( lastY >= this->height ) { lastY = this->height - 1; }
+
+        if( w <= 0 or h <= 0 or firstX > lastX or firstY > lastY )
+        {
+            return false;
+        }
+
+        rect = BlackDisplayRect(firstX, firstY, lastX, lastY);
+        return true;
+    }
+
+    void        BlackSPIDisplay::addDirtyRect(const BlackDisplayRect &rect)
+    {
+        BlackDisplayRect merged = rect;
+        bool isMerged           = true;
+
+        while( isMerged )
+        {
+            isMerged = false;
+
+            for( size_t i = 0 ; i < this->dirtyRects.size() ; i++ )
+            {
+                const BlackDisplayRect &other = this->dirtyRects[i];
+                BlackDisplayRect bounds( (merged.x0 < other.x0) ? merged.x0 : other.x0,
+                                         (merged.y0 < other.y0) ? merged.y0 : other.y0,
+                                         (merged.x1 > other.x1) ? merged.x1 : other.x1,
+                                         (merged.y1 > other.y1) ? merged.y1 : other.y1 );
+
+                // one window is cheaper if it doesn't send more extra pixels than a window setup costs
+                if( bounds.getArea() <= merged.getArea() + other.getArea() + DISPLAY_WINDOW_COST )
+                {
+                    merged = bounds;
+                    this->dirtyRects.erase( this->dirtyRects.begin() + i );
+                    isMerged = true;
+                    break;
+                }
+            }
+        }
+
+        this->dirtyRects.push_back(merged);
+
+        if( this->dirtyRects.size() > DISPLAY_MAX_DIRTY_RECTS )
+        {
+            BlackDisplayRect bounds = this->dirtyRects[0];
+
+            for( size_t i = 1 ; i < this->dirtyRects.size() ; i++ )
+            {
+                const BlackDisplayRect &other = this->dirtyRects[i];
+                if( other.x0 < bounds.x0 ) { bounds.x0 = other.x0; }
+                if( other.y0 < bounds.y0 ) { bounds.y0 = other.y0; }
+                if( other.x1 > bounds.x1 ) { bounds.x1 = other.x1; }
+                if( other.y1 > bounds.y1 ) { bounds.y1 = other.y1; }
+            }
+
+            this->dirtyRects.clear();
+            this->dirtyRects.push_back(bounds);
+        }
+    }
+
+    void        BlackSPIDisplay::markDirty(int x, int y, int w, int h)
+    {
+        BlackDisplayRect rect;
+
+        if( this->clip(x, y, w, h, rect) )
+        {
+            this->addDirtyRect(rect);
+        }
+    }
+
+    void        BlackSPIDisplay::setPixel(int x, int y, uint16_t color)
+    {
+        this->fillRect(x, y, 1, 1, color);
+    }
+
+    void        BlackSPIDisplay::fillRect(int x, int y, int w, int h, uint16_t color)
+    {
+        BlackDisplayRect rect;
+
+        if( not this->clip(x, y, w, h, rect) )
+        {
+            return;
+        }
+
+        size_t rowLength = rect.x1 - rect.x0 + 1;
+
+        for( uint32_t row = rect.y0 ; row <= rect.y1 ; row++ )
+        {
+            uint16_t *target = &(this->frame[row * this->width + rect.x0]);
+
+            for( size_t i = 0 ; i < rowLength ; i++ )
+            {
+                target[i] = color;
+            }
+        }
+
+        this->addDirtyRect(rect);
+    }
+
+    void        BlackSPIDisplay::drawRGB565(int x, int y, int w, int h, const uint16_t *pixels)
+    {
+        BlackDisplayRect rect;
+
+        if( not this->clip(x, y, w, h, rect) )
+        {
+            return;
+        }
+
+        size_t rowLength = rect.x1 - rect.x0 + 1;
+
+        for( uint32_t row = rect.y0 ; row <= rect.y1 ; row++ )
+        {
+            const uint16_t *source = pixels + (row - y) * w + (rect.x0 - x);
+            memcpy( &(this->frame[row * this->width + rect.x0]), source, rowLength * sizeof(uint16_t) );
+        }
+
+        this->addDirtyRect(rect);
+    }
+
+    void        BlackSPIDisplay::drawRGB888(int x, int y, int w, int h, const uint8_t *pixels)
+    {
+        BlackDisplayRect rect;
+
+        if( not this->clip(x, y, w, h, rect) )
+        {
+            return;
+        }
+
+        size_t rowLength = rect.x1 - rect.x0 + 1;
+
+        for( uint32_t row = rect.y0 ; row <= rect.y1 ; row++ )
+        {
+            const uint8_t *source   = pixels + ((row - y) * w + (rect.x0 - x)) * 3;
+            uint16_t *target        = &(this->frame[row * this->width + rect.x0]);
+
+            size_t i = 0;
+
+#if defined(__ARM_NEON__)
+            // 8 pixels per step: channels are de-interleaved by the load and packed with shift-insert
+            for( ; i + 8 <= rowLength ; i += 8 )
+            {
+                uint8x8x3_t rgb     = vld3_u8(source + 3*i);
+                uint16x8_t  pixel   = vshll_n_u8(rgb.val[0], 8);
+
+                pixel = vsriq_n_u16(pixel, vshll_n_u8(rgb.val[1], 8), 5);
+                pixel = vsriq_n_u16(pixel, vshll_n_u8(rgb.val[2], 8), 11);
+                vst1q_u16(target + i, pixel);
+            }
+#endif
+
+            for( ; i < rowLength ; i++ )
+            {
+                target[i] = static_cast<uint16_t>( ((source[3*i] & 0xF8) << 8) | ((source[3*i + 1] & 0xFC) << 3) | (source[3*i + 2] >> 3) );
+            }
+        }
+
+        this->addDirtyRect(rect);
+    }
+
+    void        BlackSPIDisplay::drawXRGB8888(int x, int y, int w, int h, const uint32_t *pixels)
+    {
+        BlackDisplayRect rect;
+
+        if( not this->clip(x, y, w, h, rect) )
+        {
+            return;
+        }
+
+        size_t rowLength = rect.x1 - rect.x0 + 1;
+
+        for( uint32_t row = rect.y0 ; row <= rect.y1 ; row++ )
+        {
+            const uint32_t *source  = pixels + (row - y) * w + (rect.x0 - x);
+            uint16_t *target        = &(this->frame[row * this->width + rect.x0]);
+
+            size_t i = 0;
+
+#if defined(__ARM_NEON__)
+            // little endian XRGB words are B, G, R, X bytes, so they are packed like RGB888 pixels
+            const uint8_t *sourceBytes = reinterpret_cast<const uint8_t *>(source);
+
+            for( ; i + 8 <= rowLength ; i += 8 )
+            {
+                uint8x8x4_t bgrx    = vld4_u8(sourceBytes + 4*i);
+                uint16x8_t  pixel   = vshll_n_u8(bgrx.val[2], 8);
+
+                pixel = vsriq_n_u16(pixel, vshll_n_u8(bgrx.val[1], 8), 5);
+                pixel = vsriq_n_u16(pixel, vshll_n_u8(bgrx.val[0], 8), 11);
+                vst1q_u16(target + i, pixel);
+            }
+#endif
+
+            for( ; i < rowLength ; i++ )
+            {
+                target[i] = static_cast<uint16_t>( ((source[i] >> 8) & 0xF800) | ((source[i] >> 5) & 0x07E0) | ((source[i] >> 3) & 0x001F) );
+            }
+        }
+
+        this->addDirtyRect(rect);
+    }
+
+    size_t      BlackSPIDisplay::sendWindow(const BlackDisplayRect &rect)
+    {
+        uint16_t firstX = rect.x0 + this->offsetX;
+        uint16_t lastX  = rect.x1 + this->offsetX;
+        uint16_t firstY = rect.y0 + this->offsetY;
+        uint16_t lastY  = rect.y1 + this->offsetY;
+
+        uint8_t columns[4]  = { static_cast<uint8_t>(firstX >> 8), static_cast<uint8_t>(firstX),
+                                static_cast<uint8_t>(lastX >> 8),  static_cast<uint8_t>(lastX) };
+        uint8_t rows[4]     = { static_cast<uint8_t>(firstY >> 8), static_cast<uint8_t>(firstY),
+                                static_cast<uint8_t>(lastY >> 8),  static_cast<uint8_t>(lastY) };
+
+        if( not ( this->sendCommand(0x2A, columns, 4) and           // column address set
+                  this->sendCommand(0x2B, rows, 4) and              // row address set
+                  this->sendCommand(0x2C) and                       // memory write
+                  this->setDataMode(true) ) )
+        {
+            return 0;
+        }
+
+
+        size_t rowLength    = rect.x1 - rect.x0 + 1;
+        size_t rowsPerChunk = this->chunkSize / rowLength;
+        size_t sentBytes    = 0;
+
+        for( uint32_t row = rect.y0 ; row <= rect.y1 ; row += rowsPerChunk )
+        {
+            size_t rowCount = rect.y1 - row + 1;
+            if( rowCount > rowsPerChunk )
+            {
+                rowCount = rowsPerChunk;
+            }
+
+            size_t pixelCount = rowCount * rowLength;
+            const uint16_t *chunk;
+
+            if( rowLength == this->width )
+            {
+                // full width rows are contiguous at framebuffer, so they are sent without copying
+                chunk = &(this->frame[row * this->width]);
+            }
+            else
+            {
+                for( size_t i = 0 ; i < rowCount ; i++ )
+                {
+                    memcpy( &(this->transmitBuffer[i * rowLength]), &(this->frame[(row + i) * this->width + rect.x0]),
+                            rowLength * sizeof(uint16_t) );
+                }
+
+                chunk = &(this->transmitBuffer[0]);
+            }
+
+            if( not this->spiObject->write(chunk, pixelCount, 0) )
+            {
+                return 0;
+            }
+
+            sentBytes += pixelCount * sizeof(uint16_t);
+        }
+
+        return sentBytes;
+    }
+
+    bool        BlackSPIDisplay::flush()
+    {
+        if( this->dirtyRects.empty() )
+        {
+            return true;
+        }
+
+        uint64_t beginTime  = BlackTime::getMonotonicTime();
+        uint64_t frameBytes = 0;
+        bool isAllSent      = true;
+
+        for( size_t i = 0 ; i < this->dirtyRects.size() ; i++ )
+        {
+            size_t sentBytes = this->sendWindow( this->dirtyRects[i] );
+
+            if( sentBytes == 0 )
+            {
+                isAllSent = false;
+                break;
+            }
+
+            frameBytes += sentBytes;
+            ++(this->statistics.windowCount);
+        }
+
+        uint64_t endTime = BlackTime::getMonotonicTime();
+
+        if( isAllSent )
+        {
+            this->dirtyRects.clear();
+        }
+
+        ++(this->statistics.frameCount);
+        this->statistics.byteCount         += frameBytes;
+        this->statistics.lastFrameBytes     = frameBytes;
+        this->statistics.lastFrameTime      = endTime - beginTime;
+        this->statistics.busyTime          += endTime - beginTime;
+
+        return isAllSent;
+    }
+
+    bool        BlackSPIDisplay::flushAll()
+    {
+        this->dirtyRects.clear();
+        this->markDirty(0, 0, this->width, this->height);
+
+        return this->flush();
+    }
+
+    size_t      BlackSPIDisplay::getDirtyRectCount()
+    {
+        return this->dirtyRects.size();
+    }
+
+    BlackDisplayStatistics BlackSPIDisplay::getStatistics()
+    {
+        BlackDisplayStatistics temp = this->statistics;
+        temp.elapsedTime = BlackTime::getMonotonicTime() - this->statisticsStart;
+
+        return temp;
+    }
+
+    void        BlackSPIDisplay::resetStatistics()
+    {
+        this->statistics        = BlackDisplayStatistics();
+        this->statisticsStart   = BlackTime::getMonotonicTime();
+    }
+
+    // ######################################### BLACKSPIDISPLAY DEFINITION ENDS ########################################## //
+
+} /* namespace BlackLib */
@@ -0,0 +1,389 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef BLACKSPIDISPLAY_H_
+#define BLACKSPIDISPLAY_H_
+
+#include "../BlackSPI/BlackSPI.h"
+#include "../BlackGPIO/BlackGPIO.h"
+#include "../BlackTime/BlackTime.h"
+
+#include <vector>
+
+
+
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting the display controller of BlackSPIDisplay.
+    */
+    enum displayController  {   ILI9341                 = 0,
+                                ST7789                  = 1
+                            };
+
+    const size_t            DISPLAY_MAX_DIRTY_RECTS     = 16;           //!< Dirty rectangle count which causes merging of all rectangles
+    const uint32_t          DISPLAY_WINDOW_COST         = 64;           //!< Pixel count which is equal to the cost of one window setup
+    const size_t            DISPLAY_DEFAULT_CHUNK_SIZE  = 32768;        //!< Default byte count of one pixel data transfer
+
+
+
+
+    // ######################################## BLACKDISPLAYRECT DECLARATION STARTS ######################################### //
+
+    /*! @brief Holds a rectangle of display.
+    *
+    *    Coordinates are inclusive, so a one pixel rectangle has same first and last values.
+    */
+    struct BlackDisplayRect
+    {
+        uint16_t    x0;                 /*!< @brief is used to hold the first column */
+        uint16_t    y0;                 /*!< @brief is used to hold the first row */
+        uint16_t    x1;                 /*!< @brief is used to hold the last column */
+        uint16_t    y1;                 /*!< @brief is used to hold the last row */
+
+        /*! @brief Default constructor of BlackDisplayRect struct.
+         */
+        BlackDisplayRect()
+        {
+            x0 = 0; y0 = 0; x1 = 0; y1 = 0;
+        }
+
+        /*! @brief Overloaded constructor of BlackDisplayRect struct.
+         */
+        BlackDisplayRect(uint16_t firstX, uint16_t firstY, uint16_t lastX, uint16_t lastY)
+        {
+            x0 = firstX; y0 = firstY; x1 = lastX; y1 = lastY;
+        }
+
+        /*! @brief Calculates pixel count of rectangle.
+         */
+        uint32_t getArea() const
+        {
+            return ( static_cast<uint32_t>(x1 - x0 + 1) * static_cast<uint32_t>(y1 - y0 + 1) );
+        }
+    };
+    // ######################################### BLACKDISPLAYRECT DECLARATION ENDS ########################################## //
+
+
+
+
+
+    // ##################################### BLACKDISPLAYSTATISTICS DECLARATION STARTS ###################################### //
+
+    /*! @brief Holds transfer counters of BlackSPIDisplay class.
+    */
+    struct BlackDisplayStatistics
+    {
+        uint64_t    frameCount;         /*!< @brief is used to hold the number of flushes which send data */
+        uint64_t    byteCount;          /*!< @brief is used to hold the number of sent pixel bytes */
+        uint64_t    windowCount;        /*!< @brief is used to hold the number of sent windows */
+        uint64_t    lastFrameBytes;     /*!< @brief is used to hold the pixel bytes of last frame */
+        uint64_t    lastFrameTime;      /*!< @brief is used to hold the transfer time of last frame at nanosecond level */
+        uint64_t    busyTime;           /*!< @brief is used to hold the sum of frame transfer times at nanosecond level */
+        uint64_t    elapsedTime;        /*!< @brief is used to hold the time since statistics are reset at nanosecond level */
+
+        /*! @brief Default constructor of BlackDisplayStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackDisplayStatistics()
+        {
+            frameCount      = 0;
+            byteCount       = 0;
+            windowCount     = 0;
+            lastFrameBytes  = 0;
+            lastFrameTime   = 0;
+            busyTime        = 0;
+            elapsedTime     = 0;
+        }
+
+        /*! @brief Calculates achieved frame rate since statistics are reset.
+         */
+        double getFrameRate() const
+        {
+            return ( (elapsedTime == 0) ? 0.0 : (frameCount * 1.0e9 / elapsedTime) );
+        }
+
+        /*! @brief Calculates average pixel bytes per frame.
+         */
+        uint64_t getAverageFrameBytes() const
+        {
+            return ( (frameCount == 0) ? 0 : (byteCount / frameCount) );
+        }
+    };
+    // ###################################### BLACKDISPLAYSTATISTICS DECLARATION ENDS ####################################### //
+
+
+
+
+
+
+
+
+
+
+    // ######################################## BLACKSPIDISPLAY DECLARATION STARTS ######################################### //
+
+    /*! @brief Framebuffer driver of ILI9341 and ST7789 class spi displays.
+     *
+     *    This class keeps a RGB565 framebuffer in memory. Drawing functions change the framebuffer and
+     *    record the changed area as dirty rectangle. Overlapping rectangles, and close rectangles whose
+     *    bounding box costs less than a separate window setup, are merged. flush() function sends only the
+     *    dirty windows: it sets the column and row address window, starts memory write and streams the
+     *    rows of window with large transfers. Data/command line is driven with a BlackGPIO object and it
+     *    is changed only when the line state has to change.
+     *
+     *    Pixels are sent with 16 bit word transfers, so the controller sends them most significant byte
+     *    first without byte swapping if it supports 16 bit words. RGB888 and XRGB8888 images are converted
+     *    8 pixels at a time with NEON instructions when the library is compiled with NEON support
+     *    (-mfpu=neon), else with scalar loops.
+     *
+     *    Achieved frame rate and bytes per frame are reported with getStatistics() function.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  // Filename: myDisplayProject.cpp
+     *  // Author:   Yiğit Yüce - ygtyce@gmail.com
+     *
+     *  #include <iostream>
+     *  #include "BlackLib/BlackSPIDisplay/BlackSPIDisplay.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackSPI  mySpi(BlackLib::SPI0_0, 8, BlackLib::SpiMode0, 48000000);
+     *      mySpi.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+     *
+     *      BlackLib::BlackGPIO dcPin(BlackLib::GPIO_48, BlackLib::output, BlackLib::FastMode);
+     *
+     *      BlackLib::BlackSPIDisplay myDisplay(&mySpi, &dcPin, BlackLib::ILI9341, 240, 320);
+     *      myDisplay.initialize();
+     *
+     *      myDisplay.fillRect(0, 0, 240, 320, 0x0000);
+     *      myDisplay.flush();                                      // full frame, one window
+     *
+     *      for( int i = 0 ; i < 100 ; i++ )
+     *      {
+     *          myDisplay.fillRect(10 + i, 10, 20, 20, 0xF800);     // only 20x20 window is sent
+     *          myDisplay.flush();
+     *      }
+     *
+     *      BlackLib::BlackDisplayStatistics stats = myDisplay.getStatistics();
+     *      std::cout << stats.getFrameRate() << " fps, " << stats.getAverageFrameBytes() << " bytes/frame" << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackSPIDisplay
+    {
+        private:
+            BlackSPI                       *spiObject;          /*!< @brief is used to hold the spi device */
+            BlackGPIO                      *dcPin;              /*!< @brief is used to hold the data/command pin */
+            BlackGPIO                      *resetPin;           /*!< @brief is used to hold the optional hardware reset pin */
+            displayController               controller;         /*!< @brief is used to hold the display controller type */
+            uint16_t                        width;              /*!< @brief is used to hold the column count */
+            uint16_t                        height;             /*!< @brief is used to hold the row count */
+            uint16_t                        offsetX;            /*!< @brief is used to hold the column offset of panel at controller memory */
+            uint16_t                        offsetY;            /*!< @brief is used to hold the row offset of panel at controller memory */
+            int                             dcState;            /*!< @brief is used to hold the last data/command line state, -1 if unknown */
+            size_t                          chunkSize;          /*!< @brief is used to hold the byte limit of one pixel transfer */
+            std::vector<uint16_t>           frame;              /*!< @brief is used to hold the RGB565 framebuffer */
+            std::vector<uint16_t>           transmitBuffer;     /*!< @brief is used to hold the gathered rows of current chunk */
+            std::vector<BlackDisplayRect>   dirtyRects;         /*!< @brief is used to hold the changed areas */
+            BlackDisplayStatistics          statistics;         /*!< @brief is used to hold the transfer counters */
+            uint64_t                        statisticsStart;    /*!< @brief is used to hold the reset time of statistics */
+
+            /*! @brief Changes data/command line if its state is different.
+            */
+            bool                            setDataMode(bool isData);
+
+            /*! @brief Clips a rectangle to display area.
+            *
+            * @return false if rectangle is completely outside, else true.
+            */
+            bool                            clip(int x, int y, int w, int h, BlackDisplayRect &rect);
+
+            /*! @brief Adds a dirty rectangle and merges the rectangles which are cheaper together.
+            */
+            void                            addDirtyRect(const BlackDisplayRect &rect);
+
+            /*! @brief Sends a window of framebuffer.
+            *
+            * @return number of sent pixel bytes, or 0 if transfer fails.
+            */
+            size_t                          sendWindow(const BlackDisplayRect &rect);
+
+        public:
+
+            /*! @brief Constructor of BlackSPIDisplay class.
+            *
+            * This function allocates framebuffer and transfer buffer. It doesn't send anything.
+            *
+            * @param [in] spi               opened spi device
+            * @param [in] dataCommandPin    output gpio which is connected to D/C pin of display
+            * @param [in] type              display controller (enum)
+            * @param [in] columns           column count of display
+            * @param [in] rows              row count of display
+            * @param [in] reset             optional output gpio which is connected to reset pin
+            */
+                                            BlackSPIDisplay(BlackSPI *spi, BlackGPIO *dataCommandPin, displayController type,
+                                                            uint16_t columns, uint16_t rows, BlackGPIO *reset = NULL);
+
+            /*! @brief Destructor of BlackSPIDisplay class.
+            */
+            virtual                         ~BlackSPIDisplay();
+
+            /*! @brief Resets and initializes display controller with default orientation.
+            *
+            * MADCTL value is 0x48 (portrait, BGR) for ILI9341 and 0x00 for ST7789.
+            *
+            * @return true if all commands are sent, else false.
+            * @sa initialize(uint8_t)
+            */
+            bool                            initialize();
+
+            /*! @brief Resets and initializes display controller.
+            *
+            * This function wakes up the controller, selects RGB565 pixel format and turns display on.
+            * Whole framebuffer is marked as dirty.
+            *
+            * @param [in] memoryAccess      MADCTL register value (rotation and color order)
+            * @return true if all commands are sent, else false.
+            */
+            bool                            initialize(uint8_t memoryAccess);
+
+            /*! @brief Sends a command and its parameters.
+            *
+            * @param [in] command           command byte
+            * @param [in] parameters        parameter bytes, can be NULL
+            * @param [in] parameterCount    parameter byte count
+            * @return true if sending successful, else false.
+            */
+            bool                            sendCommand(uint8_t command, const uint8_t *parameters = NULL, size_t parameterCount = 0);
+
+            /*! @brief Sets position of panel at controller memory.
+            *
+            * Some ST7789 panels (for example 240x240) don't start from first row or column of controller.
+            */
+            void                            setWindowOffset(uint16_t x, uint16_t y);
+
+            /*! @brief Changes byte limit of one pixel transfer.
+            */
+            void                            setChunkSize(size_t bytes);
+
+            /*! @brief Exports pointer of framebuffer.
+            *
+            * Users can draw directly to framebuffer. Changed areas must be reported with markDirty() function.
+            */
+            uint16_t                       *getFrame();
+
+            /*! @brief Exports column count.
+            */
+            uint16_t                        getWidth();
+
+            /*! @brief Exports row count.
+            */
+            uint16_t                        getHeight();
+
+            /*! @brief Reports a changed area of framebuffer.
+            */
+            void                            markDirty(int x, int y, int w, int h);
+
+            /*! @brief Changes color of a pixel.
+            */
+            void                            setPixel(int x, int y, uint16_t color);
+
+            /*! @brief Fills a rectangle with RGB565 color.
+            */
+            void                            fillRect(int x, int y, int w, int h, uint16_t color);
+
+            /*! @brief Copies a RGB565 image to framebuffer.
+            *
+            * @param [in] x                 first column
+            * @param [in] y                 first row
+            * @param [in] w                 image width
+            * @param [in] h                 image height
+            * @param [in] pixels            image pixels, row by row
+            */
+            void                            drawRGB565(int x, int y, int w, int h, const uint16_t *pixels);
+
+            /*! @brief Converts a RGB888 image (three bytes per pixel, red first) to framebuffer.
+            *
+            * @sa drawRGB565()
+            */
+            void                            drawRGB888(int x, int y, int w, int h, const uint8_t *pixels);
+
+            /*! @brief Converts a XRGB8888 image (0x00RRGGBB words) to framebuffer.
+            *
+            * @sa drawRGB565()
+            */
+            void                            drawXRGB8888(int x, int y, int w, int h, const uint32_t *pixels);
+
+            /*! @brief Sends dirty windows to display.
+            *
+            * @return true if all windows are sent, else false.
+            */
+            bool                            flush();
+
+            /*! @brief Sends whole framebuffer to display.
+            *
+            * @return true if sending successful, else false.
+            */
+            bool                            flushAll();
+
+            /*! @brief Exports the number of waiting dirty rectangles.
+            */
+            size_t                          getDirtyRectCount();
+
+            /*! @brief Exports transfer counters.
+            *
+            * @return copy of BlackDisplayStatistics struct.
+            */
+            BlackDisplayStatistics          getStatistics();
+
+            /*! @brief Clears transfer counters and starts new measurement period.
+            */
+            void                            resetStatistics();
+
+            /*! @brief Converts 8 bit color components to RGB565 color.
+            */
+            static uint16_t                 toRGB565(uint8_t red, uint8_t green, uint8_t blue)
+            {
+                return static_cast<uint16_t>( ((red & 0xF8) << 8) | ((green & 0xFC) << 3) | (blue >> 3) );
+            }
+    };
+    // ######################################### BLACKSPIDISPLAY DECLARATION ENDS ########################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKSPIDISPLAY_H_ */
@@ -6,6 +6,9 @@
  */
 
 #include "BlackThread.h"
+#include "../BlackTime/BlackTime.h"
+
+#include <cerrno>
 
 namespace BlackLib
 {
@@ -336,14 +339,273 @@ namespace BlackLib
 
 
 
+    BlackPeriodicThread::BlackPeriodicThread(uint64_t interval, timeType tType)
+    {
+        this->intervalNs        = 1000000;
+        this->isStopRequested   = false;
+
+        pthread_mutex_init( &(this->statisticsMutex), NULL);
+
+        this->setInterval(interval, tType);
+    }
+
+    BlackPeriodicThread::~BlackPeriodicThread()
+    {
+        pthread_mutex_destroy( &(this->statisticsMutex) );
+    }
+
+    bool BlackPeriodicThread::setInterval(uint64_t interval, timeType tType)
+    {
+        uint64_t newInterval;
+
+        switch(tType)
+        {
+            case picosecond:    { newInterval = interval / 1000;            break; }
+            case nanosecond:    { newInterval = interval;                   break; }
+            case microsecond:   { newInterval = interval * 1000;            break; }
+            case milisecond:    { newInterval = interval * 1000000;         break; }
+            case second:        { newInterval = interval * 1000000000ULL;   break; }
+            default:            { newInterval = 0;                          break; }
+        }
+
+        if( newInterval == 0 )
+        {
+            return false;
+        }
+
+        pthread_mutex_lock( &(this->statisticsMutex) );
+        this->intervalNs = newInterval;
+        pthread_mutex_unlock( &(this->statisticsMutex) );
+        return true;
+    }
+
+    uint64_t BlackPeriodicThread::getInterval()
+    {
+        pthread_mutex_lock( &(this->statisticsMutex) );
+        uint64_t interval = this->intervalNs;
+        pthread_mutex_unlock( &(this->statisticsMutex) );
+
+        return interval;
+    }
+
+    void BlackPeriodicThread::requestStop()
+    {
+        this->isStopRequested = true;
+    }
+
+    BlackTimerStatistics BlackPeriodicThread::getStatistics()
+    {
+        pthread_mutex_lock( &(this->statisticsMutex) );
+        BlackTimerStatistics temp = this->statistics;
+        pthread_mutex_unlock( &(this->statisticsMutex) );
+
+        return temp;
+    }
+
+    void BlackPeriodicThread::resetStatistics()
+    {
+        pthread_mutex_lock( &(this->statisticsMutex) );
+        this->statistics = BlackTimerStatistics();
+        pthread_mutex_unlock( &(this->statisticsMutex) );
+    }
+
+    void BlackPeriodicThread::onStartHandler()
+    {
+        uint64_t tick       = 0;
+        uint64_t deadline   = BlackTime::getMonotonicTime();
+
+        while( ! this->isStopRequested )
+        {
+            timespec wakeUp;
+            wakeUp.tv_sec   = static_cast<time_t>(deadline / 1000000000ULL);
+            wakeUp.tv_nsec  = static_cast<long>(deadline % 1000000000ULL);
+
+            while( ::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp, NULL) == EINTR ) {}
+
+            uint64_t latency = BlackTime::getMonotonicTime() - deadline;
+
+            if( ! this->onTickHandler(tick) )
+            {
+                break;
+            }
+
+            // 64 bit value isn't written atomically at 32 bit targets, so it is read under lock
+            pthread_mutex_lock( &(this->statisticsMutex) );
+            uint64_t interval   = this->intervalNs;
+            pthread_mutex_unlock( &(this->statisticsMutex) );
+
+            uint64_t now        = BlackTime::getMonotonicTime();
+            uint64_t missed     = 0;
+
+            deadline += interval;
+            ++tick;
+
+            if( now > deadline )
+            {
+                missed      = (now - deadline) / interval + 1;
+                deadline   += missed * interval;
+                tick       += missed;
+            }
+
+
+            pthread_mutex_lock( &(this->statisticsMutex) );
+
+            ++(this->statistics.tickCount);
+            this->statistics.lastLatency        = latency;
+            this->statistics.totalLatency      += latency;
+            this->statistics.missedTickCount   += missed;
+
+            if( missed > 0 )                                { ++(this->statistics.overrunCount);        }
+            if( latency > this->statistics.maxLatency )     { this->statistics.maxLatency = latency;    }
+
+            pthread_mutex_unlock( &(this->statisticsMutex) );
+        }
+
+        this->isStopRequested = false;
+    }
+
+
+
+
+
+
+
+
+
+    BlackFuture::BlackFuture()
+    {
+        this->callback      = NULL;
+        this->callbackData  = NULL;
 
+        this->initialize();
+    }
 
+    BlackFuture::BlackFuture(futureCallback callback, void *userData)
+    {
+        this->callback      = callback;
+        this->callbackData  = userData;
 
+        this->initialize();
+    }
 
+    BlackFuture::~BlackFuture()
+    {
+        pthread_cond_destroy( &(this->condition) );
+        pthread_mutex_destroy( &(this->mutex) );
+    }
 
+    void BlackFuture::initialize()
+    {
+        this->isDone        = true;
+        this->result        = false;
 
+        pthread_condattr_t attributes;
+        pthread_condattr_init( &attributes );
+        pthread_condattr_setclock( &attributes, CLOCK_MONOTONIC );
 
+        pthread_mutex_init( &(this->mutex), NULL);
+        pthread_cond_init( &(this->condition), &attributes);
 
+        pthread_condattr_destroy( &attributes );
+    }
+
+    void BlackFuture::setCallback(futureCallback callback, void *userData)
+    {
+        pthread_mutex_lock( &(this->mutex) );
+        this->callback      = callback;
+        this->callbackData  = userData;
+        pthread_mutex_unlock( &(this->mutex) );
+    }
+
+    bool BlackFuture::isReady()
+    {
+        return this->isDone;
+    }
+
+    bool BlackFuture::wait()
+    {
+        pthread_mutex_lock( &(this->mutex) );
+
+        while( ! this->isDone )
+        {
+            pthread_cond_wait( &(this->condition), &(this->mutex) );
+        }
+
+        bool temp = this->result;
+        pthread_mutex_unlock( &(this->mutex) );
+
+        return temp;
+    }
+
+    bool BlackFuture::waitFor(uint64_t timeout, timeType tType)
+    {
+        uint64_t timeoutNs;
+
+        switch(tType)
+        {
+            case picosecond:    { timeoutNs = timeout / 1000;            break; }
+            case nanosecond:    { timeoutNs = timeout;                   break; }
+            case microsecond:   { timeoutNs = timeout * 1000;            break; }
+            case milisecond:    { timeoutNs = timeout * 1000000;         break; }
+            case second:        { timeoutNs = timeout * 1000000000ULL;   break; }
+            default:            { timeoutNs = 0;                         break; }
+        }
+
+        uint64_t deadline = BlackTime::getMonotonicTime() + timeoutNs;
+
+        timespec wakeUp;
+        wakeUp.tv_sec   = static_cast<time_t>(deadline / 1000000000ULL);
+        wakeUp.tv_nsec  = static_cast<long>(deadline % 1000000000ULL);
+
+        pthread_mutex_lock( &(this->mutex) );
+
+        while( ! this->isDone )
+        {
+            if( pthread_cond_timedwait( &(this->condition), &(this->mutex), &wakeUp) == ETIMEDOUT )
+            {
+                break;
+            }
+        }
+
+        bool temp = this->isDone;
+        pthread_mutex_unlock( &(this->mutex) );
+
+        return temp;
+    }
+
+    bool BlackFuture::getResult()
+    {
+        pthread_mutex_lock( &(this->mutex) );
+        bool temp = (this->isDone and this->result);
+        pthread_mutex_unlock( &(this->mutex) );
+
+        return temp;
+    }
+
+    void BlackFuture::reset()
+    {
+        pthread_mutex_lock( &(this->mutex) );
+        this->isDone    = false;
+        this->result    = false;
+        pthread_mutex_unlock( &(this->mutex) );
+    }
+
+    void BlackFuture::complete(bool requestResult)
+    {
+        pthread_mutex_lock( &(this->mutex) );
+        this->result            = requestResult;
+        this->isDone            = true;
+        futureCallback handler  = this->callback;
+        void *handlerData       = this->callbackData;
+        pthread_cond_broadcast( &(this->condition) );
+        pthread_mutex_unlock( &(this->mutex) );
+
+        // handler can free or reuse the object, so members aren't used after this call
+        if( handler != NULL )
+        {
+            handler(this, handlerData);
+        }
+    }
 
 
 
@@ -37,6 +37,8 @@
 #include <sched.h>
 #include <vector>
 #include <unistd.h>
+#include <ctime>
+#include "../BlackDef.h"
 
 
 
@@ -1240,6 +1242,326 @@ namespace BlackLib
 
     // ############################################ BLACKTHREAD DECLARATION ENDS ############################################# //
 
+
+
+
+
+
+
+
+
+
+    // ####################################### BLACKTIMERSTATISTICS DECLARATION STARTS ####################################### //
+
+    /*! @brief Holds timing statistics of periodic threads.
+    *
+    *    This struct holds tick, overrun and wake-up latency informations of BlackPeriodicThread
+    *    class. All time values are at nanosecond (ns) level.
+    */
+    struct BlackTimerStatistics
+    {
+        uint64_t    tickCount;          /*!< @brief is used to hold the number of executed ticks */
+        uint64_t    overrunCount;       /*!< @brief is used to hold the number of ticks which finished after the next deadline */
+        uint64_t    missedTickCount;    /*!< @brief is used to hold the number of ticks which are skipped because of overruns */
+        uint64_t    lastLatency;        /*!< @brief is used to hold the wake-up latency of the last tick */
+        uint64_t    maxLatency;         /*!< @brief is used to hold the maximum wake-up latency */
+        uint64_t    totalLatency;       /*!< @brief is used to hold the sum of wake-up latencies */
+
+        /*! @brief Default constructor of BlackTimerStatistics struct.
+         *
+         *  This function clears all values.
+         */
+        BlackTimerStatistics()
+        {
+            tickCount       = 0;
+            overrunCount    = 0;
+            missedTickCount = 0;
+            lastLatency     = 0;
+            maxLatency      = 0;
+            totalLatency    = 0;
+        }
+
+        /*! @brief Calculates average wake-up latency.
+         *
+         *  @return average wake-up latency at nanosecond level.
+         */
+        uint64_t getAverageLatency() const
+        {
+            return ( (tickCount == 0) ? 0 : (totalLatency / tickCount) );
+        }
+    };
+    // ######################################## BLACKTIMERSTATISTICS DECLARATION ENDS ######################################## //
+
+
+
+
+
+
+
+
+
+
+    // ####################################### BLACKPERIODICTHREAD DECLARATION STARTS ######################################## //
+
+    /*! @brief Interface class for user specific periodic thread class.
+    *
+    *    This class is derived from BlackThread class. It runs onTickHandler() function at fixed intervals.
+    *    The deadlines are calculated from an absolute time base and the thread sleeps with
+    *    clock_nanosleep() function until the next deadline, so the execution time of handler and
+    *    the wake-up latencies don't accumulate as drift. If a tick finishes after the next deadline,
+    *    it is recorded as an overrun and the missed deadlines are skipped. Users have to derive their
+    *    own class(es) from this class and they have to implement onTickHandler() function.
+    *
+    * @par Example
+    *  @code{.cpp}
+    *  class Blinker : public BlackLib::BlackPeriodicThread
+    *  {
+    *       public:
+    *           Blinker() : BlackLib::BlackPeriodicThread(500, BlackLib::milisecond) {}
+    *
+    *       private:
+    *           bool onTickHandler(uint64_t tick)
+    *           {
+    *               std::cout << "tick: " << tick << std::endl;
+    *               return (tick < 9);
+    *           }
+    *  };
+    *
+    *  int main()
+    *  {
+    *       Blinker *b = new Blinker();
+    *
+    *       b->run();
+    *
+    *       WAIT_THREAD_FINISH(b)
+    *
+    *       std::cout << "Overruns: " << b->getStatistics().overrunCount << std::endl;
+    *
+    *       return 0;
+    *  }
+    * @endcode
+    */
+    class BlackPeriodicThread : public BlackThread
+    {
+        public:
+
+            /*! @brief Constructor of BlackPeriodicThread class.
+            *
+            * This function sets the tick interval of thread.
+            *
+            * @param [in] interval      tick interval
+            * @param [in] tType         time type of interval (enum)
+            *
+            * @sa setInterval()
+            */
+                                    BlackPeriodicThread(uint64_t interval, timeType tType = microsecond);
+
+            /*! @brief Destructor of BlackPeriodicThread class.
+            *
+            */
+            virtual                 ~BlackPeriodicThread();
+
+            /*! @brief Changes the tick interval of thread.
+            *
+            * New interval is used after the current tick. Interval must be greater than zero.
+            *
+            * @param [in] interval      tick interval
+            * @param [in] tType         time type of interval (enum)
+            * @return true if interval is valid, else false.
+            *
+            * @sa BlackLib::timeType
+            */
+            bool                    setInterval(uint64_t interval, timeType tType = microsecond);
+
+            /*! @brief Exports the tick interval of thread.
+            *
+            * @return tick interval at nanosecond (ns) level.
+            */
+            uint64_t                getInterval();
+
+            /*! @brief Requests the thread to finish.
+            *
+            * This function doesn't wait the thread. The thread finishes after the current tick and
+            * calls onStopHandler() function. Users can use waitUntilFinish() function to wait it.
+            */
+            void                    requestStop();
+
+            /*! @brief Exports the timing statistics of thread.
+            *
+            * @return copy of BlackTimerStatistics struct.
+            */
+            BlackTimerStatistics    getStatistics();
+
+            /*! @brief Clears the timing statistics of thread.
+            *
+            */
+            void                    resetStatistics();
+
+
+
+        private:
+
+            uint64_t                intervalNs;                 /*!< @brief is used to hold the tick interval at nanosecond level */
+            volatile bool           isStopRequested;            /*!< @brief is used to hold the stop request of thread */
+            BlackTimerStatistics    statistics;                 /*!< @brief is used to hold the timing statistics of thread */
+            pthread_mutex_t         statisticsMutex;            /*!< @brief is used to protect the statistics and the interval while they are used from another thread */
+
+            /*! @brief Thread's tick handler function.
+            *
+            *  This function has to overload at user's derived class. This function calls from
+            *  onStartHandler() function at every tick. Users should not call this function directly.
+            *
+            *  @param [in] tick     index of scheduled tick. Missed ticks are counted too, so the
+            *                       tick index always represents the elapsed time from the start.
+            *  @return true for continuing, false for finishing the thread.
+            */
+            virtual bool            onTickHandler(uint64_t tick) = 0;
+
+            /*! @brief Thread's start handler function.
+            *
+            *  This function runs the absolute time loop and calls onTickHandler() function at
+            *  every deadline. Users should not call this function directly.
+            */
+            void                    onStartHandler();
+    };
+    // ######################################## BLACKPERIODICTHREAD DECLARATION ENDS ######################################### //
+
+
+
+
+
+
+
+
+
+
+    class BlackFuture;
+
+    /*!
+    * This type is used for completion callbacks of asynchronous requests.
+    */
+    typedef void (*futureCallback)(BlackFuture *future, void *userData);
+
+    // ########################################### BLACKFUTURE DECLARATION STARTS ############################################ //
+
+    /*! @brief Completion handle of asynchronous requests.
+    *
+    *    This class is used for taking the result of a request which is executed by a worker thread.
+    *    The caller owns the object and it must stay valid until the request is completed. The caller
+    *    can poll the state with isReady() function, can block with wait() or waitFor() functions, or
+    *    can register a callback function. The callback runs at worker thread after the result is set
+    *    and waiting threads are woken up, so it should be short. The callback can free or reuse the
+    *    handle; if a thread also waits on it, that thread must not free it while the callback runs.
+    *
+    * @par Example
+    *  @code{.cpp}
+    *  void onDone(BlackLib::BlackFuture *future, void *userData)
+    *  {
+    *       std::cout << "Request finished: " << future->getResult() << std::endl;
+    *  }
+    *
+    *  BlackLib::BlackFuture withCallback(onDone, NULL);
+    *  BlackLib::BlackFuture blocking;
+    *
+    *  // ... submit requests with these handles to a worker ...
+    *
+    *  bool result = blocking.wait();
+    *  @endcode
+    */
+    class BlackFuture
+    {
+        public:
+
+            /*! @brief Default constructor of BlackFuture class.
+            *
+            * This function creates a handle without callback.
+            */
+                                    BlackFuture();
+
+            /*! @brief Constructor of BlackFuture class.
+            *
+            * This function creates a handle with completion callback.
+            *
+            * @param [in] callback      function which is called at completion, can be NULL
+            * @param [in] userData      pointer which is passed to callback
+            */
+                                    BlackFuture(futureCallback callback, void *userData);
+
+            /*! @brief Destructor of BlackFuture class.
+            *
+            */
+            virtual                 ~BlackFuture();
+
+            /*! @brief Changes the completion callback.
+            *
+            * This function must not be called while a request is pending.
+            *
+            * @param [in] callback      function which is called at completion, can be NULL
+            * @param [in] userData      pointer which is passed to callback
+            */
+            void                    setCallback(futureCallback callback, void *userData);
+
+            /*! @brief Checks the completion of request without blocking.
+            *
+            * @return true if request is completed, else false.
+            */
+            bool                    isReady();
+
+            /*! @brief Blocks the caller until the request is completed.
+            *
+            * @return result of request.
+            */
+            bool                    wait();
+
+            /*! @brief Blocks the caller until the request is completed or timeout is expired.
+            *
+            * @param [in] timeout       maximum waiting time
+            * @param [in] tType         time type of timeout (enum)
+            * @return true if request is completed, else false.
+            */
+            bool                    waitFor(uint64_t timeout, timeType tType = milisecond);
+
+            /*! @brief Exports the result of completed request.
+            *
+            * @return result of request, or false if request is not completed yet.
+            */
+            bool                    getResult();
+
+            /*! @brief Marks the handle as pending.
+            *
+            * This function is called by workers while the request is accepted. Users should not
+            * call this function directly.
+            */
+            void                    reset();
+
+            /*! @brief Completes the request.
+            *
+            * This function stores the result, runs the callback and wakes up waiting threads. It is
+            * called by workers. Users should not call this function directly.
+            *
+            * @param [in] requestResult result of request
+            */
+            void                    complete(bool requestResult);
+
+
+
+        private:
+
+            pthread_mutex_t         mutex;                      /*!< @brief is used to protect the state of handle */
+            pthread_cond_t          condition;                  /*!< @brief is used to wake up waiting threads */
+            volatile bool           isDone;                     /*!< @brief is used to hold the completion state */
+            bool                    result;                     /*!< @brief is used to hold the result of request */
+            futureCallback          callback;                   /*!< @brief is used to hold the completion callback */
+            void                   *callbackData;               /*!< @brief is used to hold the user pointer of callback */
+
+            /*! @brief Initializes synchronization objects.
+            *
+            * Condition variable uses monotonic clock, so timeouts are not affected by system time changes.
+            */
+            void                    initialize();
+    };
+    // ############################################ BLACKFUTURE DECLARATION ENDS ############################################# //
+
 } /* namespace BlackLib */
 
 #endif /* BLACKTHREAD_H_ */
@@ -55,6 +55,15 @@ namespace BlackLib
     }
 
 
+    uint64_t BlackTime::getMonotonicTime()
+    {
+        timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return ( static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec) );
+    }
+
+
     int BlackTime::getHour()
     {
         return this->hour;
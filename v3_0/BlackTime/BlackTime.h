@@ -35,6 +35,7 @@
 #include <ctime>
 #include <string>
 #include <cmath>
+#include <cstdint>
 #include <sys/time.h>
 
 
@@ -565,6 +566,30 @@ namespace BlackLib
             */
             static long int  fromTimeToSecond(BlackTime t);
 
+            /*! @brief Exports the monotonic clock value.
+            *
+            * This function reads the CLOCK_MONOTONIC clock of the system. This clock is not affected
+            * by the system time changes, so it is suitable for measuring intervals and for scheduling
+            * periodic jobs.
+            *
+            * @return monotonic clock value at nanosecond (ns) level.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *   uint64_t begin = BlackLib::BlackTime::getMonotonicTime();
+            *
+            *   // do some operations
+            *
+            *   uint64_t end   = BlackLib::BlackTime::getMonotonicTime();
+            *   std::cout << "Operations took " << (end - begin) << " nanoseconds";
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Operations took 18034 nanoseconds
+            * @endcode
+            */
+            static uint64_t  getMonotonicTime();
+
             /*! @brief Calculates difference of two %BlackTime.
             *
             * @param [in] t    %BlackTime value
@@ -218,43 +218,80 @@ namespace BlackLib
 
 
 
+    ssize_t     BlackUART::receive()
+    {
+        if( this->receiveBuffer.size() < this->readBufferSize )
+        {
+            this->receiveBuffer.resize(this->readBufferSize);
+        }
+
+        ssize_t readSize = -1;
+        if( this->readBufferSize > 0 )
+        {
+            readSize = ::read(this->uartFD, &(this->receiveBuffer[0]), this->readBufferSize);
+        }
+
+        this->uartErrors->readError = ( readSize <= 0 );
+        return ( readSize > 0 ) ? readSize : -1;
+    }
+
     bool        BlackUART::read(char *readBuffer, size_t size)
     {
-        char tempReadBuffer[size];
-        memset(&tempReadBuffer, 0, size);
+        ssize_t readSize = this->readBytes(readBuffer, size);
 
-        if(::read(this->uartFD, tempReadBuffer, sizeof(tempReadBuffer)) > 0)
+        if( readSize > 0 )
         {
-            memcpy(readBuffer, tempReadBuffer, sizeof(tempReadBuffer));
-            this->uartErrors->readError = false;
+            memset(readBuffer + readSize, 0, size - readSize);
             return true;
         }
         else
         {
-            this->uartErrors->readError = true;
             return false;
         }
     }
 
-    std::string BlackUART::read()
+    ssize_t     BlackUART::readBytes(char *readBuffer, size_t size)
     {
-        std::string tempReadBuffer;
-        tempReadBuffer.resize(this->readBufferSize);
+        ssize_t readSize = ::read(this->uartFD, readBuffer, size);
 
-        int readSize = ::read(this->uartFD, &tempReadBuffer[0], tempReadBuffer.size() );
-        if( readSize > 0)
+        if( readSize > 0 )
         {
             this->uartErrors->readError = false;
-            tempReadBuffer.resize(readSize);
-            return tempReadBuffer;
+            return readSize;
         }
         else
         {
             this->uartErrors->readError = true;
+            return -1;
+        }
+    }
+
+    std::string BlackUART::read()
+    {
+        ssize_t readSize = this->receive();
+        if( readSize > 0 )
+        {
+            return std::string(&(this->receiveBuffer[0]), readSize);
+        }
+        else
+        {
             return UART_READ_FAILED;
         }
     }
 
+    BlackUARTView BlackUART::readView()
+    {
+        ssize_t readSize = this->receive();
+        if( readSize > 0 )
+        {
+            return BlackUARTView(&(this->receiveBuffer[0]), readSize);
+        }
+        else
+        {
+            return BlackUARTView();
+        }
+    }
+
 
 
     bool        BlackUART::write(char *writeBuffer, size_t size)
@@ -302,21 +339,24 @@ namespace BlackLib
 
         usleep(wait_us);
 
+        return this->read(readBuffer, size);
+    }
 
-        char tempReadBuffer[ size ];
-        memset(&tempReadBuffer, 0, size);
-
-        if(::read(this->uartFD, tempReadBuffer, sizeof(tempReadBuffer)) > 0)
+    ssize_t     BlackUART::transferBytes(const char *writeBuffer, size_t writeSize, char *readBuffer, size_t readSize, uint32_t wait_us)
+    {
+        if(::write(this->uartFD, writeBuffer, writeSize ) > 0)
         {
-            memcpy(readBuffer,tempReadBuffer,sizeof(tempReadBuffer));
-            this->uartErrors->readError = false;
-            return true;
+            this->uartErrors->writeError = false;
         }
         else
         {
-            this->uartErrors->readError = true;
-            return false;
+            this->uartErrors->writeError = true;
+            return -1;
         }
+
+        usleep(wait_us);
+
+        return this->readBytes(readBuffer, readSize);
     }
 
     std::string BlackUART::transfer(std::string writeBuffer, uint32_t wait_us)
@@ -333,24 +373,40 @@ namespace BlackLib
 
         usleep(wait_us);
 
-        std::string tempReadBuffer;
-        tempReadBuffer.resize(this->readBufferSize);
-
-        int readSize = ::read(this->uartFD, &tempReadBuffer[0], tempReadBuffer.size() );
+        ssize_t readSize = this->receive();
         if( readSize > 0 )
         {
-            this->uartErrors->readError = false;
-            tempReadBuffer.resize(readSize);
-            return tempReadBuffer;
+            return std::string(&(this->receiveBuffer[0]), readSize);
         }
         else
         {
-            this->uartErrors->readError = true;
             return UART_READ_FAILED;
         }
+    }
 
+    BlackUARTView BlackUART::transferView(const char *writeBuffer, size_t writeSize, uint32_t wait_us)
+    {
+        if(::write(this->uartFD, writeBuffer, writeSize ) > 0)
+        {
+            this->uartErrors->writeError = false;
+        }
+        else
+        {
+            this->uartErrors->writeError = true;
+            return BlackUARTView();
+        }
 
+        usleep(wait_us);
 
+        ssize_t readSize = this->receive();
+        if( readSize > 0 )
+        {
+            return BlackUARTView(&(this->receiveBuffer[0]), readSize);
+        }
+        else
+        {
+            return BlackUARTView();
+        }
     }
 
 
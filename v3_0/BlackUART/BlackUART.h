@@ -35,6 +35,7 @@
 #include "../BlackCore.h"
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <cstdint>
 #include <unistd.h>
@@ -208,6 +209,62 @@ namespace BlackLib
 
 
 
+    // ######################################### BLACKUARTVIEW DECLARATION STARTS ########################################## //
+
+    /*! @brief Read-only view of received uart bytes.
+     *
+     *    This struct points to the internal receive buffer of BlackUART class, like std::string_view does. It
+     *    doesn't own the bytes, so it is valid until one of these functions of the same object is called, because
+     *    they all overwrite or resize the same buffer:
+     *      - BlackUART::readView() and BlackUART::transferView()
+     *      - BlackUART::read() and BlackUART::transfer(std::string, uint32_t), which return strings
+     *      - BlackUART::setReadBufferSize()
+     */
+    struct BlackUARTView
+    {
+        const char     *data;                   /*!< @brief is used to hold the first received byte, NULL if nothing is received */
+        size_t          length;                 /*!< @brief is used to hold the received byte count */
+
+        /*! @brief Default constructor of BlackUARTView struct.
+         *
+         *  This function creates an empty view.
+         */
+        BlackUARTView()
+        {
+            data    = NULL;
+            length  = 0;
+        }
+
+        /*! @brief Overloaded constructor of BlackUARTView struct.
+         *
+         *  This function sets input arguments to variables.
+         */
+        BlackUARTView(const char *S_data, size_t S_length)
+        {
+            data    = S_data;
+            length  = S_length;
+        }
+
+        const char     *begin() const               { return data; }
+        const char     *end() const                 { return data + length; }
+        size_t          size() const                { return length; }
+        bool            empty() const               { return length == 0; }
+        char            operator[](size_t i) const  { return data[i]; }
+
+        /*! @brief Copies viewed bytes to a string.
+         *
+         *  This function allocates, so it should be used only when bytes must live longer than the view.
+         */
+        std::string     toString() const            { return (length == 0) ? std::string() : std::string(data, length); }
+    };
+    // ########################################## BLACKUARTVIEW DECLARATION ENDS ########################################### //
+
+
+
+
+
+
+
     // ########################################### BLACKUART DECLARATION STARTS ############################################ //
 
     /*! @brief Interacts with end user, to use UART.
@@ -337,6 +394,7 @@ namespace BlackLib
             std::string     uartPortPath;                   /*!< @brief is used to hold the uart's tty port path */
 
             uint32_t        readBufferSize;                 /*!< @brief is used to hold the size of temporary buffer */
+            std::vector<char> receiveBuffer;                /*!< @brief is used to hold the reusable buffer of string and view reads */
             int             uartFD;                         /*!< @brief is used to hold the uart's tty file's file descriptor */
             bool            isOpenFlag;                     /*!< @brief is used to hold the uart's tty file's state */
             bool            isCurrentEqDefault;             /*!< @brief is used to hold the properties of uart is equal to default properties */
@@ -350,6 +408,14 @@ namespace BlackLib
             */
             bool            loadDeviceTree();
 
+            /*! @brief Reads values from uart line to internal receive buffer.
+            *
+            *  This function grows the receive buffer to BlackUART::readBufferSize only if it is smaller,
+            *  so repeated reads don't allocate.
+            *  @return read byte count, or -1 if reading fails or nothing is read.
+            */
+            ssize_t         receive();
+
 
         public:
             /*!
@@ -542,9 +608,9 @@ namespace BlackLib
             /*! @brief Reads values from uart line.
             *
             * This function reads values from uart line and returns read value as string.
-            * It creates temporary read buffer with specified size and reads values to this
-            * buffer. Then resize buffer to read value size. BlackUART::readBufferSize variable
-            * is used to specify temporary buffer size.
+            * Values are read to the reusable internal receive buffer, then a string which has exactly
+            * read value size is created. BlackUART::readBufferSize variable is used to specify
+            * maximum read size.
             *
             * @return read value if reading successful, else returns BlackLib::UART_READ_FAILED string.
             *
@@ -580,9 +646,8 @@ namespace BlackLib
 
             /*! @brief Reads values from uart line.
             *
-            * This function reads values from uart line and saves read value to @a @b readBuffer pointer.
-            * It creates temporary read buffer with specified size and reads values to this
-            * buffer. Then copies buffer to  @a @b readBuffer pointer.
+            * This function reads values from uart line directly to @a @b readBuffer pointer. Unused
+            * part of the buffer is cleared. Use BlackUART::readBytes() if read byte count is needed.
             *
             * @param [out] readBuffer          buffer pointer
             * @param [in] size                 buffer size
@@ -618,6 +683,69 @@ namespace BlackLib
             */
             bool            read(char *readBuffer, size_t size);
 
+            /*! @brief Reads values from uart line and returns exact read size.
+            *
+            * This function reads values from uart line directly to @a @b readBuffer pointer. No copy is
+            * done and unused part of the buffer isn't touched.
+            *
+            * @param [out] readBuffer          buffer pointer
+            * @param [in] size                 buffer size
+            * @return read byte count if reading successful, else -1.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *
+            *   BlackLib::BlackUART  myUart(BlackLib::UART1,
+            *                               BlackLib::Baud9600,
+            *                               BlackLib::ParityEven,
+            *                               BlackLib::StopOne,
+            *                               BlackLib::Char8 );
+            *
+            *   myUart.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+            *
+            *   char readBuffer[64];
+            *   ssize_t readSize = myUart.readBytes(readBuffer, sizeof(readBuffer));
+            *
+            *   if( readSize > 0 )
+            *   {
+            *       std::cout.write(readBuffer, readSize);
+            *   }
+            *
+            * @endcode
+            */
+            ssize_t         readBytes(char *readBuffer, size_t size);
+
+            /*! @brief Reads values from uart line and returns a view of them.
+            *
+            * This function reads values to the reusable internal receive buffer and returns a view of read
+            * values. No allocation is done after the first call, so it fits streaming reads. View is valid
+            * until the next readView(), transferView(), string returning read() or transfer(), or
+            * setReadBufferSize() call.
+            *
+            * @return view of read values, or empty view if reading fails.
+            *
+            * @par Example
+            *  @code{.cpp}
+            *
+            *   BlackLib::BlackUART  myUart(BlackLib::UART1,
+            *                               BlackLib::Baud9600,
+            *                               BlackLib::ParityEven,
+            *                               BlackLib::StopOne,
+            *                               BlackLib::Char8 );
+            *
+            *   myUart.open( BlackLib::ReadWrite );
+            *
+            *   while( true )
+            *   {
+            *       BlackLib::BlackUARTView received = myUart.readView();
+            *       std::cout.write(received.data, received.size());
+            *   }
+            *
+            * @endcode
+            * @sa BlackUART::readBufferSize
+            */
+            BlackUARTView   readView();
+
             /*! @brief Writes values to uart line.
             *
             * This function writes values to uart line. Values sent to this function as string type.
@@ -693,10 +821,9 @@ namespace BlackLib
 
             /*! @brief Writes and reads values sequentially to/from uart line.
             *
-            * This function writes values to uart line firstly and then reads values from uart line and saves read
-            * value to @a @b readBuffer pointer. It creates temporary read buffer with specified size and reads
-            * values to this buffer. Then it copies buffer to  @a @b readBuffer pointer. This function waits between
-            * writing and reading operations.
+            * This function writes values to uart line firstly and then reads values from uart line directly to
+            * @a @b readBuffer pointer. Unused part of the buffer is cleared. This function waits between writing
+            * and reading operations. Use BlackUART::transferBytes() if read byte count is needed.
             *
             * @param [in] writeBuffer          values buffer
             * @param [out] readBuffer          read buffer pointer
@@ -732,12 +859,39 @@ namespace BlackLib
             */
             bool            transfer(char *writeBuffer, char *readBuffer, size_t size, uint32_t wait_us);
 
+            /*! @brief Writes and reads values sequentially and returns exact read size.
+            *
+            * This function writes values to uart line firstly and then reads values from uart line directly to
+            * @a @b readBuffer pointer. This function waits between writing and reading operations.
+            *
+            * @param [in] writeBuffer          values buffer
+            * @param [in] writeSize            write buffer size
+            * @param [out] readBuffer          read buffer pointer
+            * @param [in] readSize             read buffer size
+            * @param [in] wait_us              sleep time between writing and reading
+            * @return read byte count if transfering successful, else -1.
+            */
+            ssize_t         transferBytes(const char *writeBuffer, size_t writeSize, char *readBuffer, size_t readSize, uint32_t wait_us);
+
+            /*! @brief Writes and reads values sequentially and returns a view of read values.
+            *
+            * This function writes values to uart line firstly and then reads values to the reusable internal
+            * receive buffer. This function waits between writing and reading operations.
+            *
+            * @param [in] writeBuffer          values buffer
+            * @param [in] writeSize            write buffer size
+            * @param [in] wait_us              sleep time between writing and reading
+            * @return view of read values, or empty view if transfering fails.
+            * @sa BlackUART::readView()
+            */
+            BlackUARTView   transferView(const char *writeBuffer, size_t writeSize, uint32_t wait_us);
+
             /*! @brief Writes and reads values sequentially to/from uart line.
             *
             * This function writes values to uart line firstly and then reads values from uart line and returns read
-            * value as string. It creates temporary read buffer with specified size and reads values to this buffer.
-            * Then resize buffer to read value size. BlackUART::readBufferSize variable is used to specify temporary
-            * buffer size.
+            * value as string. Values are read to the reusable internal receive buffer, then a string which has
+            * exactly read value size is created. BlackUART::readBufferSize variable is used to specify maximum
+            * read size.
             *
             * @param [in] writeBuffer          write buffer
             * @param [in] wait_us              sleep time between writing and reading
@@ -32,7 +32,10 @@
 
 #include "examples/example_GPIO.h"
 #include "examples/example_ADC.h"
+#include "examples/example_Capture.h"
+#include "examples/example_EQEP.h"
 #include "examples/example_PWM.h"
+#include "examples/example_PWMSequencer.h"
 #include "examples/example_SPI.h"
 #include "examples/example_UART.h"
 #include "examples/example_I2C.h"
@@ -48,7 +51,10 @@ int main()
 
     example_GPIO();
     example_ADC();
+    example_Capture();
+    example_EQEP();
     example_PWM();
+    example_PWMSequencer();
     example_SPI();
     example_UART();
     example_I2C();
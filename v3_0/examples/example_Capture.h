@@ -0,0 +1,99 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+
+#ifndef EXAMPLE_CAPTURE_H_
+#define EXAMPLE_CAPTURE_H_
+
+
+
+
+#include "../BlackCapture/BlackCapture.h"
+#include "../BlackTime/BlackTime.h"
+#include <iostream>
+
+
+
+
+
+
+
+
+
+
+void example_Capture()
+{
+
+    BlackLib::BlackCapture      inputCapture(BlackLib::CAPTURE0);
+
+    if( inputCapture.fail(BlackLib::BlackCapture::mapErr) )
+    {
+        std::cout << "eCAP0 registers couldn't map." << std::endl;
+        return;
+    }
+
+
+
+
+    BlackLib::BlackCaptureValue measurement;
+
+    for( int i = 0 ; i < 10 ; i++ )
+    {
+        if( inputCapture.readCapture(measurement) )
+        {
+            std::cout << "Period: \t"   << measurement.periodTime   << " ns"    << std::endl;
+            std::cout << "High time: \t"<< measurement.highTime     << " ns"    << std::endl;
+            std::cout << "Frequency: \t"<< measurement.frequency    << " Hz"    << std::endl;
+            std::cout << "Duty: \t\t"   << measurement.dutyPercent  << " %"     << std::endl << std::endl;
+        }
+        else
+        {
+            std::cout << "There is no input signal." << std::endl << std::endl;
+        }
+
+        sleep(1);
+    }
+
+
+
+
+    std::cout << "Signal exists at last 100 ms: " << std::boolalpha
+              << inputCapture.isSignalPresent(100, BlackLib::milisecond) << std::endl;
+
+}
+
+
+
+
+
+
+
+#endif /* EXAMPLE_CAPTURE_H_ */
@@ -0,0 +1,114 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+
+#ifndef EXAMPLE_EQEP_H_
+#define EXAMPLE_EQEP_H_
+
+
+
+
+#include "../BlackEQEP/BlackEQEP.h"
+#include <iostream>
+
+
+
+
+
+
+
+
+
+
+void example_EQEP()
+{
+
+    BlackLib::BlackEQEP         encoder(BlackLib::EQEP2, 10, BlackLib::milisecond);
+
+    if( encoder.fail(BlackLib::BlackEQEP::mapErr) )
+    {
+        std::cout << "eQEP2 registers couldn't map." << std::endl;
+        return;
+    }
+
+    encoder.setPosition(0);
+
+
+
+
+    for( int i = 0 ; i < 10 ; i++ )
+    {
+        BlackLib::BlackThread::msleep(10);
+
+        int32_t indexPosition;
+        if( encoder.readIndexLatch(indexPosition) )
+        {
+            std::cout << "Index passed at position: " << indexPosition << std::endl;
+        }
+
+        std::cout << "Position: \t" << encoder.getPosition() << std::endl;
+        std::cout << "Velocity: \t" << encoder.getVelocity() << " counts/s" << std::endl;
+    }
+
+
+
+
+    // control loop consumes samples which are taken every 500 us
+    BlackLib::BlackEQEPSampler  sampler(&encoder, 500, BlackLib::microsecond, 1024);
+    BlackLib::BlackEQEPSample   samples[256];
+
+    sampler.run();
+
+    for( int i = 0 ; i < 10 ; i++ )
+    {
+        BlackLib::BlackThread::msleep(20);
+
+        size_t count = sampler.popSamples(samples, 256);
+        if( count > 0 )
+        {
+            std::cout << count << " samples, last position: " << samples[count-1].position << std::endl;
+        }
+    }
+
+    sampler.requestStop();
+    WAIT_THREAD_FINISH(&sampler)
+
+    std::cout << "Dropped samples: " << sampler.getDroppedCount() << std::endl;
+
+}
+
+
+
+
+
+
+
+#endif /* EXAMPLE_EQEP_H_ */
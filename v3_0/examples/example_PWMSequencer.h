@@ -0,0 +1,112 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+
+#ifndef EXAMPLE_PWMSEQUENCER_H_
+#define EXAMPLE_PWMSEQUENCER_H_
+
+
+
+
+#include "../BlackPWM/BlackPWM.h"
+#include "../BlackPWMSequencer/BlackPWMSequencer.h"
+#include <vector>
+#include <iostream>
+
+
+
+
+
+
+
+
+
+
+void example_PWMSequencer()
+{
+
+    BlackLib::BlackPWM          pwmMotor(BlackLib::EHRPWM1A);
+    BlackLib::BlackPWM          pwmLed(BlackLib::EHRPWM2A);
+
+
+    // if new period value is less than the current duty value, the new period value setting
+    // operation couldn't execute. So firstly duty value is set to zero for safe steps.
+    pwmMotor.setDutyPercent(0.0);
+    pwmMotor.setPeriodTime(50, BlackLib::microsecond);
+    pwmLed.setDutyPercent(0.0);
+    pwmLed.setPeriodTime(1, BlackLib::milisecond);
+
+
+
+
+    BlackLib::BlackPWMSequencer sequencer(1000);
+
+    int motorChannel    = sequencer.addChannel(&pwmMotor);
+    int ledChannel      = sequencer.addChannel(&pwmLed);
+
+
+    // motor soft-start: 0% -> 75% in 2 seconds with s-curve profile
+    sequencer.setRamp(motorChannel, 0.0, 75.0, 2, BlackLib::second, BlackLib::SCurveRamp);
+
+
+    // led blinks with sample table, every sample is played at one tick (1 ms)
+    std::vector<float> blinkTable(500, 0.0);
+    blinkTable.resize(1000, 100.0);
+    sequencer.setTable(ledChannel, blinkTable);
+
+
+
+
+    sequencer.run();
+    WAIT_THREAD_FINISH(&sequencer)
+
+
+
+
+    BlackLib::BlackTimerStatistics stats = sequencer.getStatistics();
+
+    std::cout << "Played samples: \t"       << (sequencer.getCurrentStep() + 1) << "/" << sequencer.getStepCount() << std::endl;
+    std::cout << "Ticks: \t\t\t"            << stats.tickCount              << std::endl;
+    std::cout << "Overruns: \t\t"           << stats.overrunCount           << std::endl;
+    std::cout << "Missed ticks: \t\t"       << stats.missedTickCount        << std::endl;
+    std::cout << "Max latency: \t\t"        << stats.maxLatency             << " ns" << std::endl;
+    std::cout << "Average latency: \t"      << stats.getAverageLatency()    << " ns" << std::endl;
+    std::cout << "Write errors: \t\t"       << sequencer.getWriteErrorCount() << std::endl;
+
+}
+
+
+
+
+
+
+
+#endif /* EXAMPLE_PWMSEQUENCER_H_ */
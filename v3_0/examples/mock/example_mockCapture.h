@@ -0,0 +1,111 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKCAPTURE_H_
+#define EXAMPLE_MOCKCAPTURE_H_
+
+
+#include "../../BlackCapture/BlackCapture.h"
+#include "../../BlackRegisterMap/BlackRegisterMap.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+
+
+/*
+ * Runs BlackCapture against a register image file instead of "/dev/mem". The image is written with a
+ * second BlackRegisterMap object, like eCAP hardware would latch the time stamps of input edges. Offsets
+ * are relative to the start of pwm subsystem, eCAP registers start at 0x100.
+ */
+
+
+void example_mockCapture()
+{
+    const std::string   imagePath   = "/tmp/BlackLib-mockCapture.img";
+    const uint32_t      ecapTsctr   = 0x100;
+    const uint32_t      ecapCap1    = 0x108;
+    const uint32_t      ecapEcflg   = 0x12E;
+    const uint16_t      cevt4       = 0x0010;
+
+    std::vector<char> zeros(4096, 0);
+    std::ofstream imageFile(imagePath.c_str(), std::ios::binary);
+    imageFile.write(&zeros[0], zeros.size());
+    imageFile.close();
+
+    BlackLib::BlackCapture      capture(BlackLib::CAPTURE0, imagePath);
+    BlackLib::BlackRegisterMap  hardware(imagePath, 0, 4096);
+    BlackLib::BlackCaptureValue value;
+
+    // 1 kHz input with 25 % duty at 100 MHz counter: rise, fall, rise, fall
+    bool isRejectedBeforeEdges = not capture.readCapture(value);
+
+    uint32_t edges[4] = { 1000000, 1025000, 1100000, 1125000 };
+    for( int i = 0 ; i < 4 ; i++ ) { hardware.write32(ecapCap1 + 4 * i, edges[i]); }
+    hardware.write32(ecapTsctr, 1150000);
+    hardware.write16(ecapEcflg, cevt4);
+
+    bool isFirstRead    = capture.readCapture(value);
+    bool isFirstCorrect = isFirstRead and value.periodTime == 1000000 and value.highTime == 250000 and
+                          value.frequency > 999.9 and value.frequency < 1000.1 and
+                          value.dutyPercent > 24.99 and value.dutyPercent < 25.01;
+
+    std::cout << "[capture]   no edges: " << (isRejectedBeforeEdges ? "rejected" : "FAILED") << ", edges "
+              << edges[0] << " " << edges[1] << " " << edges[2] << " " << edges[3] << ": period "
+              << value.periodTime << " ns, high " << value.highTime << " ns, " << value.frequency << " Hz, "
+              << value.dutyPercent << " % " << (isFirstCorrect ? "ok" : "FAILED")
+              << " (expected 1000000 ns, 250000 ns, 1000 Hz, 25 %)" << std::endl;
+
+    // next rise overwrites CAP1, so the newest cycle is CAP3, CAP4, CAP1
+    hardware.write32(ecapCap1, 1200000);
+    hardware.write32(ecapTsctr, 1210000);
+
+    bool isRotated = capture.readCapture(value) and value.periodTime == 1000000 and value.highTime == 250000 and
+                     value.lastEdgeAge == 100000;
+
+    // time stamp counter wraps between the edges of a 40 % duty cycle
+    uint32_t wrapped[4] = { 0xFFFF0000, 0xFFFF0000 + 40000, 0xFFFF0000 + 100000, 0xFFFF0000 + 140000 };
+    for( int i = 0 ; i < 4 ; i++ ) { hardware.write32(ecapCap1 + 4 * i, wrapped[i]); }
+    hardware.write32(ecapTsctr, 0xFFFF0000 + 150000);
+
+    bool isWrapped = capture.readCapture(value) and value.periodTime == 1000000 and value.highTime == 400000;
+
+    std::cout << "            CAP1 overwritten by the next rise: " << (isRotated ? "ok" : "FAILED")
+              << ", counter wrapped inside the cycle: period " << value.periodTime << " ns, duty "
+              << value.dutyPercent << " % " << (isWrapped ? "ok" : "FAILED") << " (expected 1000000 ns, 40 %)" << std::endl;
+
+    remove( imagePath.c_str() );
+}
+
+
+#endif /* EXAMPLE_MOCKCAPTURE_H_ */
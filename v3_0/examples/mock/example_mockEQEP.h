@@ -0,0 +1,118 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKEQEP_H_
+#define EXAMPLE_MOCKEQEP_H_
+
+
+#include "../../BlackEQEP/BlackEQEP.h"
+#include "../../BlackRegisterMap/BlackRegisterMap.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+
+
+/*
+ * Runs BlackEQEP against a register image file instead of "/dev/mem". The image is written with a second
+ * BlackRegisterMap object, like eQEP hardware would count encoder edges and latch the position at every
+ * unit time. Offsets are relative to the start of pwm subsystem, eQEP registers start at 0x180.
+ */
+
+
+void example_mockEQEP()
+{
+    const std::string   imagePath   = "/tmp/BlackLib-mockEQEP.img";
+    const uint32_t      eqepQposcnt = 0x180;
+    const uint32_t      eqepQposilat= 0x190;
+    const uint32_t      eqepQposlat = 0x198;
+    const uint32_t      eqepQuprd   = 0x1A0;
+    const uint32_t      eqepQflg    = 0x1B2;
+    const uint16_t      qflgIel     = 0x0400;
+    const uint16_t      qflgUto     = 0x0800;
+
+    std::vector<char> zeros(4096, 0);
+    std::ofstream imageFile(imagePath.c_str(), std::ios::binary);
+    imageFile.write(&zeros[0], zeros.size());
+    imageFile.close();
+
+    BlackLib::BlackEQEP         encoder(BlackLib::EQEP2, imagePath, 10, BlackLib::milisecond);
+    BlackLib::BlackRegisterMap  hardware(imagePath, 0, 4096);
+
+    bool isUnitTimerSet = ( hardware.read32(eqepQuprd) == 1000000 );         // 10 ms at 100 MHz
+
+    hardware.write32(eqepQposcnt, 1234);
+    int32_t forwardPosition = encoder.getPosition();
+    hardware.write32(eqepQposcnt, static_cast<uint32_t>(-5));
+    int32_t reversePosition = encoder.getPosition();
+
+    std::cout << "[eqep]      unit timer period " << (isUnitTimerSet ? "ok" : "FAILED") << ", position "
+              << forwardPosition << " and " << reversePosition << " "
+              << ((forwardPosition == 1234 and reversePosition == -5) ? "ok" : "FAILED")
+              << " (expected 1234 and -5)" << std::endl;
+
+    // unit timer latches: the first one only starts the measurement, then every latch gives one velocity
+    hardware.write32(eqepQposlat, 1000);
+    hardware.write16(eqepQflg, qflgUto);
+    bool isFirstRejected = ( encoder.getVelocityCount() == 0 and encoder.fail(BlackLib::BlackEQEP::velocityErr) );
+
+    const uint32_t  latches[4]  = { 1400, 1100, 0x00000064, static_cast<uint32_t>(-100) };
+    const int32_t   expected[4] = { 400,  -300, -1000,      -200 };
+    const char     *names[4]    = { "forward", "reverse", "reverse", "reverse across 0" };
+
+    for( int i = 0 ; i < 4 ; i++ )
+    {
+        hardware.write32(eqepQposlat, latches[i]);
+        float velocity  = encoder.getVelocity();
+        int32_t counts  = static_cast<int32_t>(velocity / 100.0f + ((velocity < 0) ? -0.5f : 0.5f));
+
+        std::cout << "            latch " << static_cast<int32_t>(latches[i]) << ": " << velocity << " counts/s, "
+                  << ((velocity > 0) ? "forward" : "reverse") << " "
+                  << ((counts == expected[i] and ((velocity > 0) == (expected[i] > 0))) ? "ok" : "FAILED")
+                  << " (expected " << expected[i] * 100 << " counts/s, " << names[i] << ")" << std::endl;
+    }
+
+    int32_t indexPosition = 0;
+    bool isIndexMissing = not encoder.readIndexLatch(indexPosition);
+    hardware.write32(eqepQposilat, 2048);
+    hardware.write16(eqepQflg, qflgUto | qflgIel);
+    bool isIndexRead = encoder.readIndexLatch(indexPosition) and indexPosition == 2048;
+
+    std::cout << "            first latch: " << (isFirstRejected ? "no velocity" : "FAILED") << ", index latch: "
+              << ((isIndexMissing and isIndexRead) ? "ok" : "FAILED") << " (expected 2048 only after IEL)" << std::endl;
+
+    remove( imagePath.c_str() );
+}
+
+
+#endif /* EXAMPLE_MOCKEQEP_H_ */
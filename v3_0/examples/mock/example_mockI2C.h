@@ -0,0 +1,134 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKI2C_H_
+#define EXAMPLE_MOCKI2C_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackI2C/BlackI2C.h"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+
+
+
+/*
+ * Runs BlackI2C against the simulated adapter of mockI2CAdapter.h and prints the measured values next to
+ * the expected ones. Checks of the other i2c modules are in their own example_mockI2C*.h files. They don't
+ * need a Beaglebone or i2c-stub.
+ */
+
+
+void example_mockI2CBind()
+{
+    mockI2C::reset();
+    mockI2C::addDevice(0x53, mockI2C::mockRegisterMap);
+    mockI2C::addDevice(0x68, mockI2C::mockRegisterMap);
+
+    BlackLib::BlackI2C  accelerometer(BlackLib::I2C_1, 0x53);
+    BlackLib::BlackI2C  gyroscope(BlackLib::I2C_1, 0x68);
+
+    accelerometer.open( BlackLib::ReadWrite );
+    gyroscope.open(accelerometer);                          // shares the descriptor
+
+    for( int i = 0 ; i < 100 ; i++ ) { accelerometer.readByte(0x00); }
+    for( int i = 0 ; i < 100 ; i++ ) { gyroscope.readByte(0x00); }
+    accelerometer.readByte(0x00);
+
+    BlackLib::BlackI2CStatistics first  = accelerometer.getStatistics();
+    BlackLib::BlackI2CStatistics second = gyroscope.getStatistics();
+    uint64_t untracked = first.bindCount + first.skippedBindCount + second.bindCount + second.skippedBindCount;
+
+    std::cout << "[bind]      201 reads over 2 shared objects: "
+              << mockI2C::counters.slaveCount << " I2C_SLAVE requests (expected 3), " << untracked
+              << " without address tracking (expected 202, open and every read), "
+              << mockI2C::counters.openCount << " open (expected 1)" << std::endl;
+}
+
+
+
+void example_mockI2CLongBlock()
+{
+    const size_t blockSize = 500000;
+    std::vector<uint8_t> source(blockSize), target(blockSize);
+
+    for( size_t i = 0 ; i < blockSize ; i++ ) { source[i] = static_cast<uint8_t>(i * 7 + 3); }
+
+    for( int path = 0 ; path < 2 ; path++ )
+    {
+        mockI2C::reset();
+        mockI2C::addDevice(0x3C, mockI2C::mockStream);
+        mockI2C::functions |= (path == 1) ? I2C_FUNC_NOSTART : 0;
+
+        BlackLib::BlackI2C display(BlackLib::I2C_1, 0x3C);
+        display.open( BlackLib::ReadWrite );
+
+        bool isWritten          = display.writeLongBlock(0x40, &source[0], blockSize);
+        uint32_t writeRequests  = mockI2C::counters.rdwrCount;
+
+        mockI2C::resetCounters();
+        bool isRead             = display.readLongBlock(0x40, &target[0], blockSize);
+
+        bool isReadEqual = isRead;
+        for( size_t i = 0 ; i < blockSize and isReadEqual ; i++ )
+        {
+            isReadEqual = ( target[i] == static_cast<uint8_t>(i * 7) );
+        }
+
+        std::cout << "[longBlock] " << ((path == 1) ? "NOSTART" : "packed ") << " 500000 bytes: write "
+                  << ((isWritten and mockI2C::devices[0x3C].stream == source) ? "ok" : "FAILED") << " in " << writeRequests
+                  << " requests, read " << (isReadEqual ? "ok" : "FAILED") << " in " << mockI2C::counters.rdwrCount
+                  << " requests (expected 2 and 2)" << std::endl;
+    }
+
+    for( int path = 0 ; path < 2 ; path++ )
+    {
+        mockI2C::reset();
+        mockI2C::addDevice(0x1D, mockI2C::mockRegisterMap);
+        mockI2C::functions |= (path == 1) ? I2C_FUNC_NOSTART : 0;
+
+        BlackLib::BlackI2C sensor(BlackLib::I2C_1, 0x1D);
+        sensor.open( BlackLib::ReadWrite );
+
+        bool isWritten  = sensor.writeLongBlock(0x30, &source[0], 200, BlackLib::I2cIncrementRegister);
+        bool isEqual    = isWritten and memcmp(&mockI2C::devices[0x1D].registers[0x30], &source[0], 200) == 0;
+        bool isRejected = not sensor.writeLongBlock(0xF0, &source[0], 32, BlackLib::I2cIncrementRegister);
+
+        std::cout << "[longBlock] " << ((path == 1) ? "NOSTART" : "packed ") << " 200 bytes to registers 0x30-0xF7: "
+                  << (isEqual ? "ok" : "FAILED") << ", block past register 0xFF "
+                  << (isRejected ? "rejected" : "NOT REJECTED") << std::endl;
+    }
+}
+
+
+#endif /* EXAMPLE_MOCKI2C_H_ */
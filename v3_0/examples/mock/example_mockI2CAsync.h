@@ -0,0 +1,137 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKI2CASYNC_H_
+#define EXAMPLE_MOCKI2CASYNC_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackI2CAsync/BlackI2CAsync.h"
+#include "../../BlackTime/BlackTime.h"
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+
+
+
+/*
+ * Runs BlackI2CAsync against the simulated adapter of mockI2CAdapter.h with 10 us per byte. A high priority
+ * read waits at most for the current 64 byte slice of a low priority dump, which takes about 0.66 ms.
+ * Steady submissions take their requests from the pool, so only the pointer queues allocate, one block
+ * for every 64 requests. Allocations are counted with a replaced operator new.
+ */
+
+
+static volatile uint32_t mockAllocationCount = 0;
+
+#if __cplusplus < 201103L
+void* operator new(std::size_t size) throw(std::bad_alloc)
+#else
+void* operator new(std::size_t size)
+#endif
+{
+    __sync_fetch_and_add(&mockAllocationCount, 1);
+
+    void *memory = malloc( (size > 0) ? size : 1 );
+    if( memory == NULL ) { throw std::bad_alloc(); }
+    return memory;
+}
+
+void operator delete(void *memory) throw()
+{
+    free(memory);
+}
+
+
+
+void example_mockI2CAsync()
+{
+    mockI2C::reset();
+    mockI2C::addDevice(0x50, mockI2C::mockStream);
+    mockI2C::addDevice(0x40, mockI2C::mockRegisterMap);
+    mockI2C::nsPerByte = 10000;                             // 10 us per byte
+
+    BlackLib::BlackI2CBus       bus(BlackLib::I2C_1);
+    BlackLib::BlackI2CBusDevice memory(bus, 0x50), sensor(bus, 0x40);
+    BlackLib::BlackI2CAsync     worker(bus);
+    worker.run();
+
+    static uint8_t dump[8192];
+    BlackLib::BlackFuture dumpDone, readDone;
+
+    uint64_t dumpStart = BlackLib::BlackTime::getMonotonicTime();
+    worker.submitRead(memory, 0x00, dump, sizeof(dump), 64, BlackLib::I2cLowPriority, &dumpDone);
+    BlackLib::BlackThread::msleep(5);
+
+    uint8_t currentRegister = 0x04, current[2];
+    BlackLib::BlackI2CTransaction transaction;
+    transaction.addWrite(&currentRegister, 1).addRead(current, 2);
+
+    uint64_t readStart = BlackLib::BlackTime::getMonotonicTime();
+    worker.submit(sensor, transaction, BlackLib::I2cHighPriority, &readDone);
+    readDone.wait();
+    uint64_t readEnd = BlackLib::BlackTime::getMonotonicTime();
+    dumpDone.wait();
+    uint64_t dumpEnd = BlackLib::BlackTime::getMonotonicTime();
+
+    bool isDumpEqual = dumpDone.getResult();
+    for( size_t i = 0 ; i < sizeof(dump) and isDumpEqual ; i++ )
+    {
+        isDumpEqual = ( dump[i] == static_cast<uint8_t>(i * 7) );
+    }
+
+    mockI2C::nsPerByte = 0;
+    for( int i = 0 ; i < 100 ; i++ )
+    {
+        worker.submit(sensor, transaction, BlackLib::I2cNormalPriority, &readDone);
+        readDone.wait();
+    }
+
+    uint32_t allocationStart = mockAllocationCount;
+    for( int i = 0 ; i < 2000 ; i++ )
+    {
+        worker.submit(sensor, transaction, BlackLib::I2cNormalPriority, &readDone);
+        readDone.wait();
+    }
+    uint32_t allocationCount = mockAllocationCount - allocationStart;
+
+    worker.finish();
+
+    std::cout << "[async]     high priority read during 8 KiB low priority dump: " << (readEnd - readStart) / 1000
+              << " us (expected below 1000, dump takes " << (dumpEnd - dumpStart) / 1000000 << " ms), dump "
+              << (isDumpEqual ? "ok" : "FAILED") << std::endl;
+    std::cout << "            2000 steady submissions: " << allocationCount
+              << " allocations (expected about 31, one per 64 requests)" << std::endl;
+}
+
+
+#endif /* EXAMPLE_MOCKI2CASYNC_H_ */
@@ -0,0 +1,86 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKI2CBUS_H_
+#define EXAMPLE_MOCKI2CBUS_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackI2CBus/BlackI2CBus.h"
+#include <iostream>
+
+
+
+
+/*
+ * Runs BlackI2CBus against the simulated adapter of mockI2CAdapter.h. Three devices share one descriptor
+ * and their queued transactions are sent with one I2C_RDWR request per address switch.
+ */
+
+
+void example_mockI2CBus()
+{
+    mockI2C::reset();
+    mockI2C::addDevice(0x10, mockI2C::mockRegisterMap);
+    mockI2C::addDevice(0x20, mockI2C::mockRegisterMap);
+    mockI2C::addDevice(0x30, mockI2C::mockRegisterMap);
+
+    BlackLib::BlackI2CBus       bus(BlackLib::I2C_1);
+    BlackLib::BlackI2CBusDevice devices[3] = { BlackLib::BlackI2CBusDevice(bus, 0x20),
+                                               BlackLib::BlackI2CBusDevice(bus, 0x10),
+                                               BlackLib::BlackI2CBusDevice(bus, 0x30) };
+
+    uint8_t value;
+    devices[0].readByte(0x01, value);
+
+    uint8_t registers[12];
+    BlackLib::BlackI2CTransaction transactions[12];
+
+    for( int i = 0 ; i < 12 ; i++ )
+    {
+        registers[i] = static_cast<uint8_t>(i);
+        transactions[i].addWrite(&registers[i], 1);
+        devices[i % 3].enqueue(transactions[i]);
+    }
+
+    uint32_t slaveCount = mockI2C::counters.slaveCount;
+    bus.flush();
+
+    BlackLib::BlackI2CBusStatistics statistics = bus.getStatistics();
+
+    std::cout << "[bus]       12 interleaved transactions of 3 devices: " << mockI2C::counters.openCount
+              << " open (expected 1), " << statistics.addressSwitchCount << " address switches (expected 3), "
+              << mockI2C::counters.slaveCount << " I2C_SLAVE requests (" << mockI2C::counters.slaveCount - slaveCount
+              << " in flush, expected 0)" << std::endl;
+}
+
+
+#endif /* EXAMPLE_MOCKI2CBUS_H_ */
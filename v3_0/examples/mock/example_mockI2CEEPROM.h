@@ -0,0 +1,89 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKI2CEEPROM_H_
+#define EXAMPLE_MOCKI2CEEPROM_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackI2CEEPROM/BlackI2CEEPROM.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+
+
+
+/*
+ * Runs BlackI2CEEPROM against a simulated 24Cxx memory of mockI2CAdapter.h with a 3 ms write cycle. The
+ * memory doesn't acknowledge during its write cycle, so every page write is finished with acknowledge
+ * polling. A second write with one changed byte writes only the page of that byte.
+ */
+
+
+void example_mockI2CEEPROM()
+{
+    BlackLib::eepromModel models[2] = { BlackLib::EEPROM_24C64, BlackLib::EEPROM_24C16 };
+
+    for( int i = 0 ; i < 2 ; i++ )
+    {
+        mockI2C::reset();
+
+        if( models[i] == BlackLib::EEPROM_24C64 )   { mockI2C::addEeprom(0x50, 8192, 32, 3000000); }
+        else                                        { mockI2C::addEeprom(0x50, 2048, 16, 3000000); }
+
+        BlackLib::BlackI2C       i2c(BlackLib::I2C_1, 0x50);
+        i2c.open( BlackLib::ReadWrite );
+        BlackLib::BlackI2CEEPROM eeprom(&i2c, models[i]);
+
+        uint8_t source[700], target[700];
+        for( size_t k = 0 ; k < sizeof(source) ; k++ ) { source[k] = static_cast<uint8_t>(rand()); }
+
+        bool isCopied = eeprom.write(250, source, sizeof(source)) and eeprom.read(250, target, sizeof(target)) and
+                        memcmp(source, target, sizeof(source)) == 0;
+
+        source[400] ^= 0x01;
+        eeprom.resetStatistics();
+
+        bool isRewritten = eeprom.write(250, source, sizeof(source)) and eeprom.read(250, target, sizeof(target)) and
+                           memcmp(source, target, sizeof(source)) == 0;
+
+        BlackLib::BlackEEPROMStatistics statistics = eeprom.getStatistics();
+
+        std::cout << "[eeprom]    " << ((i == 0) ? "24C64 (2 byte address)" : "24C16 (1 byte address)")
+                  << ", 700 bytes at 250 with 3 ms write cycle: " << (isCopied ? "ok" : "FAILED")
+                  << ", one byte changed: " << (isRewritten ? "ok" : "FAILED") << " with " << statistics.pageWriteCount
+                  << " page write (expected 1), " << statistics.pageSkipCount << " skipped pages" << std::endl;
+    }
+}
+
+
+#endif /* EXAMPLE_MOCKI2CEEPROM_H_ */
@@ -0,0 +1,88 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKI2CFIFOREADER_H_
+#define EXAMPLE_MOCKI2CFIFOREADER_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackI2CFIFOReader/BlackI2CFIFOReader.h"
+#include "../../BlackThread/BlackThread.h"
+#include <iostream>
+
+
+
+
+/*
+ * Runs BlackI2CFIFOReader against a simulated MPU-6050 fifo of mockI2CAdapter.h. The sensor runs 1 % slower
+ * than its nominal 1000 Hz rate, so the estimated rate has to follow the drain times to reach 990 Hz.
+ */
+
+
+void example_mockI2CFIFOReader()
+{
+    mockI2C::reset();
+    mockI2C::addFifo(0x68, 990);                            // sensor runs 1 % slower than nominal 1000 Hz
+
+    BlackLib::BlackI2C           i2c(BlackLib::I2C_1, 0x68);
+    i2c.open( BlackLib::ReadWrite );
+    BlackLib::BlackI2CFIFOReader reader(&i2c, BlackLib::BlackFIFODescription(), 1000, 256);
+
+    int16_t   values[6][256];
+    int16_t  *channels[6];
+    uint64_t  timestamps[256];
+
+    for( int c = 0 ; c < 6 ; c++ ) { channels[c] = values[c]; }
+
+    size_t total        = 0;
+    bool isParsed       = true;
+
+    for( int drain = 0 ; drain < 40 ; drain++ )
+    {
+        BlackLib::BlackThread::msleep(50);
+        size_t count = reader.drain(channels, timestamps, 256);
+
+        for( size_t i = 0 ; i < count ; i++ )
+        {
+            for( uint8_t c = 0 ; c < 6 ; c++ )
+            {
+                isParsed = isParsed and ( values[c][i] == mockI2C::fifoValue(total + i, c) );
+            }
+        }
+        total += count;
+    }
+
+    std::cout << "[fifo]      990 Hz sensor, 40 drains: " << total << " frames " << (isParsed ? "ok" : "FAILED")
+              << ", estimated rate " << reader.getEstimatedRate() << " Hz (expected about 990)" << std::endl;
+}
+
+
+#endif /* EXAMPLE_MOCKI2CFIFOREADER_H_ */
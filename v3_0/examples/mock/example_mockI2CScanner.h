@@ -0,0 +1,107 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKI2CSCANNER_H_
+#define EXAMPLE_MOCKI2CSCANNER_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackI2CScanner/BlackI2CScanner.h"
+#include <iostream>
+#include <vector>
+
+
+
+
+/*
+ * Runs BlackI2CScanner against the simulated adapter of mockI2CAdapter.h. Every adapter name opens the same
+ * simulated adapter, so concurrent scans find the same devices. Probes are counted by method: an adapter
+ * with the zero length quirk or without SMBus quick must be probed with reads only.
+ */
+
+
+void example_mockI2CScanner()
+{
+    const char *names[3] = { "quick write", "zero length quirk", "no SMBus quick" };
+
+    for( int adapter = 0 ; adapter < 3 ; adapter++ )
+    {
+        mockI2C::reset();
+        mockI2C::addDevice(0x1D, mockI2C::mockRegisterMap);
+        mockI2C::addDevice(0x50, mockI2C::mockRegisterMap);
+        mockI2C::addDevice(0x68, mockI2C::mockRegisterMap);
+        mockI2C::addDevice(0x77, mockI2C::mockRegisterMap);
+
+        if( adapter == 1 ) { mockI2C::isZeroLengthRejected = true; }
+        if( adapter == 2 ) { mockI2C::functions = I2C_FUNC_I2C; }
+
+        BlackLib::BlackI2CScanner   scanner;
+        BlackLib::BlackI2CScanResult result = scanner.scan(BlackLib::I2C_1);
+
+        bool isFound = result.isScanned and result.getDeviceCount() == 4 and result.isPresent(0x1D) and
+                       result.isPresent(0x50) and result.isPresent(0x68) and result.isPresent(0x77);
+
+        int readCount = 0;
+        for( uint8_t address = 0x03 ; address <= 0x77 ; address++ )
+        {
+            if( result.methods[address] == BlackLib::ProbeReadByte ) { ++readCount; }
+        }
+
+        std::cout << ((adapter == 0) ? "[scanner]   " : "            ") << names[adapter] << " adapter: 0x1D 0x50 0x68 0x77 "
+                  << (isFound ? "ok" : "FAILED") << ", " << readCount << " of 117 probes read (expected "
+                  << ((adapter == 0) ? 24 : 117) << "), " << mockI2C::counters.slaveCount << " I2C_SLAVE request (expected 1, at open)" << std::endl;
+    }
+
+    mockI2C::reset();
+    mockI2C::addDevice(0x68, mockI2C::mockRegisterMap);
+    mockI2C::nsPerByte = 100000;                            // 100 kHz bus
+
+    BlackLib::BlackI2CScanner   scanner;
+    BlackLib::i2cName           buses[2] = { BlackLib::I2C_0, BlackLib::I2C_1 };
+
+    uint64_t scanStart = BlackLib::BlackTime::getMonotonicTime();
+    std::vector<BlackLib::BlackI2CScanResult> results = scanner.scan(buses, 2);
+    uint64_t scanTime = BlackLib::BlackTime::getMonotonicTime() - scanStart;
+
+    uint64_t busTimeSum = 0;
+    bool isFound        = true;
+    for( size_t i = 0 ; i < results.size() ; i++ )
+    {
+        busTimeSum += results[i].totalTime;
+        isFound     = isFound and results[i].getDeviceCount() == 1 and results[i].isPresent(0x68);
+    }
+
+    std::cout << "            2 adapters at 100 kHz: 0x68 " << (isFound ? "ok" : "FAILED") << " on both, "
+              << scanTime / 1000000 << " ms in total, " << busTimeSum / 1000000 << " ms summed over adapters" << std::endl;
+}
+
+
+#endif /* EXAMPLE_MOCKI2CSCANNER_H_ */
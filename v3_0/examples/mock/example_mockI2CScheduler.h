@@ -0,0 +1,89 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKI2CSCHEDULER_H_
+#define EXAMPLE_MOCKI2CSCHEDULER_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackI2CScheduler/BlackI2CScheduler.h"
+#include <iostream>
+
+
+
+
+/*
+ * Runs BlackI2CScheduler against the simulated adapter of mockI2CAdapter.h with a 400 kHz bus. Due jobs
+ * are batched into one I2C_RDWR request. The last job reads an address without a device, so its batches
+ * fail and are retried job by job, without errors at the other jobs.
+ */
+
+
+void example_mockI2CScheduler()
+{
+    mockI2C::reset();
+    mockI2C::addDevice(0x68, mockI2C::mockRegisterMap);
+    mockI2C::addDevice(0x77, mockI2C::mockRegisterMap);
+    mockI2C::addDevice(0x1E, mockI2C::mockRegisterMap);
+    mockI2C::nsPerByte = 25000;                             // 400 kHz bus
+
+    BlackLib::BlackI2CBus       bus(BlackLib::I2C_1);
+    BlackLib::BlackI2CBusDevice imu(bus, 0x68), barometer(bus, 0x77), compass(bus, 0x1E), missing(bus, 0x29);
+    uint8_t imuData[14], barometerData[6], compassData[6], missingData[2];
+
+    BlackLib::BlackI2CScheduler scheduler;
+    int jobs[4];
+    jobs[0] = scheduler.addJob(imu,       0x3B, imuData,       sizeof(imuData),       2500, 0, BlackLib::microsecond);
+    jobs[1] = scheduler.addJob(barometer, 0xF7, barometerData, sizeof(barometerData), 10,   0, BlackLib::milisecond);
+    jobs[2] = scheduler.addJob(compass,   0x03, compassData,   sizeof(compassData),   1,    0, BlackLib::second);
+    jobs[3] = scheduler.addJob(missing,   0x00, missingData,   sizeof(missingData),   100,  0, BlackLib::milisecond);
+
+    scheduler.run();
+    BlackLib::BlackThread::sleep(1);
+    scheduler.requestStop();
+    scheduler.waitUntilFinish();
+
+    BlackLib::BlackI2CSchedulerStatistics statistics = scheduler.getStatistics();
+
+    std::cout << "[scheduler] 400 Hz, 100 Hz, 1 Hz and absent 10 Hz jobs for 1 s: " << statistics.runCount << " runs in "
+              << statistics.batchCount << " requests (" << statistics.retriedBatchCount << " retried), up to " << mockI2C::counters.maxMessageCount / 2
+              << " jobs per request, bus busy " << statistics.getBusyPercentage() << " %" << std::endl;
+
+    for( int i = 0 ; i < 4 ; i++ )
+    {
+        BlackLib::BlackI2CJobStatistics job = scheduler.getJobStatistics(jobs[i]);
+        std::cout << "            job " << i << ": " << job.runCount << " runs, " << job.errorCount << " errors, "
+                  << job.getAverageLatency() / 1000 << " us average latency" << std::endl;
+    }
+}
+
+
+#endif /* EXAMPLE_MOCKI2CSCHEDULER_H_ */
@@ -0,0 +1,122 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef EXAMPLE_MOCKUART_H_
+#define EXAMPLE_MOCKUART_H_
+
+
+#include "mockI2CAdapter.h"
+#include "../../BlackUART/BlackUART.h"
+#include "../../BlackThread/BlackThread.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <termios.h>
+#include <unistd.h>
+
+
+
+
+/*
+ * Runs BlackUART against a pseudo terminal. The uart file is opened at the slave side of the terminal by
+ * the open() wrapper of mockI2CAdapter.h, and the master side plays the connected device. Slave side is
+ * switched to raw mode, like a real uart which doesn't wait for line ends.
+ */
+
+
+void example_mockUART()
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if( master < 0 or grantpt(master) != 0 or unlockpt(master) != 0 )
+    {
+        std::cout << "[uart]      pseudo terminal can't be opened, check is skipped" << std::endl;
+        return;
+    }
+
+    mockI2C::uartPath = ptsname(master);
+
+    BlackLib::BlackUART uart(BlackLib::UART1, BlackLib::Baud9600, BlackLib::ParityNo, BlackLib::StopOne, BlackLib::Char8);
+    uart.open( BlackLib::ReadWrite | BlackLib::NonBlock );
+
+    int slave = ::open(mockI2C::uartPath.c_str(), O_RDWR | O_NOCTTY);
+    struct termios properties;
+    tcgetattr(slave, &properties);
+    cfmakeraw(&properties);
+    tcsetattr(slave, TCSANOW, &properties);
+    ::close(slave);
+
+    char buffer[32];
+
+    memset(buffer, 'x', sizeof(buffer));
+    ::write(master, "hello uart", 10);
+    BlackLib::BlackThread::msleep(10);
+    ssize_t readSize    = uart.readBytes(buffer, sizeof(buffer));
+    bool isExact        = ( readSize == 10 and memcmp(buffer, "hello uart", 10) == 0 and buffer[10] == 'x' );
+
+    memset(buffer, 'x', sizeof(buffer));
+    ::write(master, "hello", 5);
+    BlackLib::BlackThread::msleep(10);
+    bool isCleared      = uart.read(buffer, sizeof(buffer)) and memcmp(buffer, "hello", 5) == 0 and buffer[5] == '\0' and
+                          buffer[sizeof(buffer) - 1] == '\0';
+
+    ::write(master, "first", 5);
+    BlackLib::BlackThread::msleep(10);
+    BlackLib::BlackUARTView first   = uart.readView();
+    const char *firstData           = first.data;
+    bool isFirstEqual               = ( first.toString() == "first" );
+
+    ::write(master, "second", 6);
+    BlackLib::BlackThread::msleep(10);
+    BlackLib::BlackUARTView second  = uart.readView();
+    bool isViewReused               = isFirstEqual and second.toString() == "second" and second.data == firstData;
+
+    // answer of device is queued before the request, transfer reads it after its wait time
+    char request[16];
+    memset(buffer, 'x', sizeof(buffer));
+    ::write(master, "ok", 2);
+    ssize_t answerSize  = uart.transferBytes("status?", 7, buffer, sizeof(buffer), 10000);
+    ssize_t requestSize = ::read(master, request, sizeof(request));
+    bool isTransferred  = ( answerSize == 2 and memcmp(buffer, "ok", 2) == 0 and buffer[2] == 'x' and
+                            requestSize == 7 and memcmp(request, "status?", 7) == 0 );
+
+    uart.close();
+    ::close(master);
+    mockI2C::uartPath.clear();
+
+    std::cout << "[uart]      readBytes: " << readSize << " bytes (expected 10), buffer tail "
+              << (isExact ? "untouched ok" : "FAILED") << ", read: tail " << (isCleared ? "cleared ok" : "FAILED") << std::endl;
+    std::cout << "            readView: " << (isViewReused ? "same buffer for 2 reads ok" : "FAILED")
+              << ", transferBytes: 7 bytes sent, " << answerSize << " received (expected 2) "
+              << (isTransferred ? "ok" : "FAILED") << std::endl;
+}
+
+
+#endif /* EXAMPLE_MOCKUART_H_ */
@@ -0,0 +1,67 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+/*
+ * Runs the modules against simulated hardware on a host computer. Build with "make mock-examples".
+ */
+
+#include "example_mockI2C.h"
+#include "example_mockI2CBus.h"
+#include "example_mockI2CScheduler.h"
+#include "example_mockI2CAsync.h"
+#include "example_mockI2CEEPROM.h"
+#include "example_mockI2CFIFOReader.h"
+#include "example_mockI2CScanner.h"
+#include "example_mockCapture.h"
+#include "example_mockEQEP.h"
+#include "example_mockUART.h"
+
+
+
+
+int main()
+{
+
+    example_mockI2CBind();
+    example_mockI2CLongBlock();
+    example_mockI2CBus();
+    example_mockI2CScheduler();
+    example_mockI2CAsync();
+    example_mockI2CEEPROM();
+    example_mockI2CFIFOReader();
+    example_mockI2CScanner();
+    example_mockCapture();
+    example_mockEQEP();
+    example_mockUART();
+
+
+    return 0;
+}
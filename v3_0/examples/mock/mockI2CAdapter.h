@@ -0,0 +1,510 @@
+ /*
+
+ ####################################################################################
+ #  BlackLib Library controls Beaglebone Black's inputs and outputs.                #
+ #  Copyright (C) 2013-2015 by Yigit YUCE                                           #
+ ####################################################################################
+ #                                                                                  #
+ #  This file is part of BlackLib library.                                          #
+ #                                                                                  #
+ #  BlackLib library is free software: you can redistribute it and/or modify        #
+ #  it under the terms of the GNU Lesser General Public License as published by     #
+ #  the Free Software Foundation, either version 3 of the License, or               #
+ #  (at your option) any later version.                                             #
+ #                                                                                  #
+ #  BlackLib library is distributed in the hope that it will be useful,             #
+ #  but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+ #  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+ #  GNU Lesser General Public License for more details.                             #
+ #                                                                                  #
+ #  You should have received a copy of the GNU Lesser General Public License        #
+ #  along with this program.  If not, see <http://www.gnu.org/licenses/>.           #
+ #                                                                                  #
+ #  For any comment or suggestion please contact the creator of BlackLib Library    #
+ #  at ygtyce@gmail.com                                                             #
+ #                                                                                  #
+ ####################################################################################
+
+ */
+
+
+
+#ifndef MOCKI2CADAPTER_H_
+#define MOCKI2CADAPTER_H_
+
+
+/*
+ * Simulated i2c-dev adapter for checking i2c modules on a host computer.
+ *
+ * This file replaces open() and ioctl() calls with the linker's --wrap option, so it must be included
+ * by exactly one source file and the program must be linked with "-Wl,--wrap=open -Wl,--wrap=ioctl".
+ * Files which aren't "/dev/i2c-N" are opened normally. I2C_RDWR requests are checked against the
+ * i2c-dev limits and every message is sent to the simulated device at its address:
+ *
+ *   - mockRegisterMap  256 registers with an auto incremented register pointer
+ *   - mockStream       data written after the register byte is appended to a stream, reads return a
+ *                      counting pattern
+ *   - mockEeprom       24Cxx memory with page writes and a busy write cycle which doesn't acknowledge
+ *   - mockFifo         MPU-6050 like sensor fifo which produces 12 byte frames at a real rate
+ *
+ * Addresses without a device don't acknowledge. If isZeroLengthRejected is set, the adapter has the zero
+ * length quirk of some controllers and I2C_RDWR requests with an empty message fail with EOPNOTSUPP.
+ * Counters are updated atomically, so several threads can use the adapter at the same time.
+ *
+ * Uart files "/dev/ttyON" are opened at uartPath instead, if it isn't empty, so BlackUART can be checked
+ * with a pseudo terminal.
+ */
+
+
+#include "../../BlackI2C/BlackI2C.h"
+#include "../../BlackTime/BlackTime.h"
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <vector>
+
+
+
+
+namespace mockI2C
+{
+    enum deviceType         {   mockAbsent          = 0,
+                                mockRegisterMap     = 1,
+                                mockStream          = 2,
+                                mockEeprom          = 3,
+                                mockFifo            = 4
+                            };
+
+    const int               MOCK_FD                 = 1000;     // descriptor which is returned for i2c-dev files
+    const size_t            MOCK_FIFO_FRAME_SIZE    = 12;       // 3 axis accelerometer and 3 axis gyroscope, 16 bit each
+
+
+    struct mockDevice
+    {
+        deviceType              type;
+        uint8_t                 registers[256];
+        uint8_t                 pointer;
+        uint8_t                 currentRegister;
+        std::vector<uint8_t>    stream;
+        uint32_t                streamReadPosition;
+    };
+
+    struct mockEepromChip
+    {
+        uint16_t                baseAddress;
+        uint8_t                 addressLength;
+        uint16_t                pageSize;
+        uint32_t                size;
+        uint64_t                writeCycleTime;
+        uint64_t                busyUntil;
+        uint32_t                pointer;
+        uint32_t                pageWriteCount;
+        uint32_t                nackCount;
+        std::vector<uint8_t>    memory;
+    };
+
+    struct mockFifoSensor
+    {
+        uint64_t                startTime;
+        uint64_t                framePeriod;
+        uint64_t                consumedFrames;
+    };
+
+    struct mockCounters
+    {
+        uint32_t                openCount;
+        uint32_t                slaveCount;
+        uint32_t                smbusCount;
+        uint32_t                rdwrCount;
+        uint32_t                maxMessageCount;
+    };
+
+
+    static mockDevice           devices[128];
+    static mockEepromChip       eeprom;
+    static mockFifoSensor       fifo;
+    static mockCounters         counters;
+    static unsigned long        functions               = I2C_FUNC_I2C | I2C_FUNC_SMBUS_EMUL;
+    static uint32_t             nsPerByte               = 0;
+    static bool                 isZeroLengthRejected    = false;
+    static uint16_t             slaveAddress            = 0;
+    static std::string          uartPath;
+
+
+
+    inline void resetCounters()
+    {
+        memset(&counters, 0, sizeof(counters));
+    }
+
+    inline void reset()
+    {
+        for( size_t i = 0 ; i < 128 ; i++ )
+        {
+            devices[i].type                 = mockAbsent;
+            devices[i].pointer              = 0;
+            devices[i].currentRegister      = 0;
+            devices[i].streamReadPosition   = 0;
+            devices[i].stream.clear();
+            memset(devices[i].registers, 0, sizeof(devices[i].registers));
+        }
+
+        eeprom.memory.clear();
+        eeprom.size             = 0;
+        functions               = I2C_FUNC_I2C | I2C_FUNC_SMBUS_EMUL;
+        nsPerByte               = 0;
+        slaveAddress            = 0;
+        isZeroLengthRejected    = false;
+        uartPath.clear();
+        resetCounters();
+    }
+
+    inline void addDevice(uint16_t address, deviceType type)
+    {
+        devices[address & 0x7F].type = type;
+    }
+
+    inline void addEeprom(uint16_t address, uint32_t size, uint16_t pageSize, uint64_t writeCycleTime)
+    {
+        eeprom.baseAddress      = address;
+        eeprom.addressLength    = (size > 2048) ? 2 : 1;
+        eeprom.pageSize         = pageSize;
+        eeprom.size             = size;
+        eeprom.writeCycleTime   = writeCycleTime;
+        eeprom.busyUntil        = 0;
+        eeprom.pointer          = 0;
+        eeprom.pageWriteCount   = 0;
+        eeprom.nackCount        = 0;
+        eeprom.memory.assign(size, 0xFF);
+
+        // small memories answer at 8 addresses, block select bits are the low address bits
+        uint16_t addressCount = (eeprom.addressLength == 1 and size > 256) ? static_cast<uint16_t>(size / 256) : 1;
+        for( uint16_t i = 0 ; i < addressCount ; i++ )
+        {
+            addDevice(address + i, mockEeprom);
+        }
+    }
+
+    inline void addFifo(uint16_t address, uint32_t frameRate)
+    {
+        addDevice(address, mockFifo);
+        fifo.startTime      = BlackLib::BlackTime::getMonotonicTime();
+        fifo.framePeriod    = 1000000000ULL / frameRate;
+        fifo.consumedFrames = 0;
+    }
+
+    inline uint8_t fifoByte(uint64_t byteIndex)
+    {
+        uint64_t frame  = byteIndex / MOCK_FIFO_FRAME_SIZE;
+        uint64_t word   = (byteIndex % MOCK_FIFO_FRAME_SIZE) / 2;
+        int16_t value   = static_cast<int16_t>(frame * 10 + word - 300);
+
+        return (byteIndex & 1) ? static_cast<uint8_t>(value) : static_cast<uint8_t>(value >> 8);
+    }
+
+    inline int16_t fifoValue(uint64_t frame, uint8_t channel)
+    {
+        return static_cast<int16_t>(frame * 10 + channel - 300);
+    }
+
+
+
+    inline bool eepromMessage(i2c_msg &message)
+    {
+        uint64_t now = BlackLib::BlackTime::getMonotonicTime();
+
+        if( now < eeprom.busyUntil )
+        {
+            ++eeprom.nackCount;
+            return false;
+        }
+
+        uint32_t block = (eeprom.addressLength == 1) ? static_cast<uint32_t>((message.addr - eeprom.baseAddress) & 7) << 8 : 0;
+
+        if( message.flags & I2C_M_RD )
+        {
+            for( uint16_t i = 0 ; i < message.len ; i++ )
+            {
+                message.buf[i]  = eeprom.memory[eeprom.pointer];
+                eeprom.pointer  = (eeprom.pointer + 1) % eeprom.size;
+            }
+            return true;
+        }
+
+        if( message.len < eeprom.addressLength )
+        {
+            return message.len == 0;
+        }
+
+        uint32_t address = (eeprom.addressLength == 1) ? (block | message.buf[0])
+                                                       : ((static_cast<uint32_t>(message.buf[0]) << 8) | message.buf[1]);
+        eeprom.pointer = address % eeprom.size;
+
+        size_t dataLength = message.len - eeprom.addressLength;
+        if( dataLength == 0 )
+        {
+            return true;
+        }
+
+        if( dataLength > eeprom.pageSize )
+        {
+            return false;
+        }
+
+        // page write wraps inside its page, like a real chip
+        uint32_t pageStart = eeprom.pointer - eeprom.pointer % eeprom.pageSize;
+        for( size_t i = 0 ; i < dataLength ; i++ )
+        {
+            eeprom.memory[pageStart + (eeprom.pointer - pageStart + i) % eeprom.pageSize] = message.buf[eeprom.addressLength + i];
+        }
+
+        ++eeprom.pageWriteCount;
+        eeprom.busyUntil = now + eeprom.writeCycleTime;
+        return true;
+    }
+
+    inline bool fifoMessage(mockDevice &device, i2c_msg &message)
+    {
+        if( not (message.flags & I2C_M_RD) )
+        {
+            if( message.len > 0 ) { device.currentRegister = message.buf[0]; }
+            return true;
+        }
+
+        uint64_t produced   = (BlackLib::BlackTime::getMonotonicTime() - fifo.startTime) / fifo.framePeriod;
+        uint64_t available  = std::min<uint64_t>(produced - fifo.consumedFrames, 1024 / MOCK_FIFO_FRAME_SIZE);
+
+        if( device.currentRegister == 0x72 )
+        {
+            uint16_t byteCount = static_cast<uint16_t>(available * MOCK_FIFO_FRAME_SIZE);
+            message.buf[0] = static_cast<uint8_t>(byteCount >> 8);
+            if( message.len > 1 ) { message.buf[1] = static_cast<uint8_t>(byteCount); }
+        }
+        else
+        {
+            uint64_t firstByte = fifo.consumedFrames * MOCK_FIFO_FRAME_SIZE;
+            for( uint16_t i = 0 ; i < message.len ; i++ )
+            {
+                message.buf[i] = fifoByte(firstByte + i);
+            }
+            fifo.consumedFrames += message.len / MOCK_FIFO_FRAME_SIZE;
+        }
+        return true;
+    }
+
+    inline bool deviceMessage(i2c_msg &message, bool isContinued)
+    {
+        if( message.addr > 0x7F )
+        {
+            return false;
+        }
+
+        mockDevice &device = devices[message.addr];
+
+        switch( device.type )
+        {
+            case mockEeprom:
+            {
+                return eepromMessage(message);
+            }
+
+            case mockFifo:
+            {
+                return fifoMessage(device, message);
+            }
+
+            case mockRegisterMap:
+            {
+                uint16_t first = 0;
+                if( not (message.flags & I2C_M_RD) and not isContinued and message.len > 0 )
+                {
+                    device.pointer  = message.buf[0];
+                    first           = 1;
+                }
+
+                for( uint16_t i = first ; i < message.len ; i++ )
+                {
+                    if( message.flags & I2C_M_RD )  { message.buf[i] = device.registers[device.pointer++]; }
+                    else                            { device.registers[device.pointer++] = message.buf[i]; }
+                }
+                return true;
+            }
+
+            case mockStream:
+            {
+                if( message.flags & I2C_M_RD )
+                {
+                    for( uint16_t i = 0 ; i < message.len ; i++ )
+                    {
+                        message.buf[i] = static_cast<uint8_t>(device.streamReadPosition++ * 7);
+                    }
+                    return true;
+                }
+
+                uint16_t first = (isContinued or message.len == 0) ? 0 : 1;
+                device.stream.insert(device.stream.end(), message.buf + first, message.buf + message.len);
+                return true;
+            }
+
+            default:
+            {
+                return false;
+            }
+        }
+    }
+
+    inline int rdwrRequest(i2c_rdwr_ioctl_data *request)
+    {
+        __sync_fetch_and_add(&counters.rdwrCount, 1);
+
+        if( request->nmsgs == 0 or request->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS )
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        if( request->nmsgs > counters.maxMessageCount )
+        {
+            counters.maxMessageCount = request->nmsgs;
+        }
+
+        size_t byteCount = 0;
+        for( uint32_t i = 0 ; i < request->nmsgs ; i++ )
+        {
+            if( request->msgs[i].len > 8192 or
+                ((request->msgs[i].flags & I2C_M_NOSTART) and not (functions & I2C_FUNC_NOSTART)) )
+            {
+                errno = EINVAL;
+                return -1;
+            }
+            if( request->msgs[i].len == 0 and isZeroLengthRejected )
+            {
+                errno = EOPNOTSUPP;
+                return -1;
+            }
+            byteCount += request->msgs[i].len + 1;
+        }
+
+        if( nsPerByte > 0 )
+        {
+            uint64_t until = BlackLib::BlackTime::getMonotonicTime() + byteCount * nsPerByte;
+            while( BlackLib::BlackTime::getMonotonicTime() < until ) { usleep(20); }
+        }
+
+        // like i2c-dev, transfer stops at the first message which isn't acknowledged
+        for( uint32_t i = 0 ; i < request->nmsgs ; i++ )
+        {
+            bool isContinued = ( (request->msgs[i].flags & I2C_M_NOSTART) != 0 );
+
+            if( not deviceMessage(request->msgs[i], isContinued) )
+            {
+                errno = (request->msgs[i].len == 0 and devices[request->msgs[i].addr & 0x7F].type != mockAbsent) ? EOPNOTSUPP : ENXIO;
+                return -1;
+            }
+        }
+
+        return static_cast<int>(request->nmsgs);
+    }
+
+    inline int smbusRequest(i2c_smbus_ioctl_data *request)
+    {
+        __sync_fetch_and_add(&counters.smbusCount, 1);
+
+        mockDevice &device = devices[slaveAddress & 0x7F];
+        if( device.type != mockRegisterMap )
+        {
+            errno = ENXIO;
+            return -1;
+        }
+
+        if( request->read_write == I2C_SMBUS_READ and request->data != NULL )
+        {
+            request->data->byte = device.registers[request->command];
+        }
+        else if( request->read_write == I2C_SMBUS_WRITE and request->data != NULL )
+        {
+            device.registers[request->command] = request->data->byte;
+        }
+        return 0;
+    }
+
+} /* namespace mockI2C */
+
+
+
+
+extern "C" int __real_open(const char *path, int flags, ...);
+extern "C" int __real_ioctl(int fd, unsigned long request, ...);
+
+extern "C" int __wrap_open(const char *path, int flags, ...)
+{
+    va_list arguments;
+    va_start(arguments, flags);
+    mode_t mode = static_cast<mode_t>(va_arg(arguments, int));
+    va_end(arguments);
+
+    if( strncmp(path, "/dev/i2c-", 9) == 0 )
+    {
+        __sync_fetch_and_add(&mockI2C::counters.openCount, 1);
+        return mockI2C::MOCK_FD;
+    }
+
+    if( strncmp(path, "/dev/ttyO", 9) == 0 and not mockI2C::uartPath.empty() )
+    {
+        return __real_open(mockI2C::uartPath.c_str(), flags, mode);
+    }
+
+    return __real_open(path, flags, mode);
+}
+
+extern "C" int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+    va_list arguments;
+    va_start(arguments, request);
+    void *argument = va_arg(arguments, void *);
+    va_end(arguments);
+
+    if( fd != mockI2C::MOCK_FD )
+    {
+        return __real_ioctl(fd, request, argument);
+    }
+
+    switch( request )
+    {
+        case I2C_SLAVE:
+        case I2C_SLAVE_FORCE:
+        {
+            __sync_fetch_and_add(&mockI2C::counters.slaveCount, 1);
+            // address is passed as int, so only its low bits are valid
+            mockI2C::slaveAddress = static_cast<uint16_t>(reinterpret_cast<unsigned long>(argument) & 0x3FF);
+            return 0;
+        }
+
+        case I2C_FUNCS:
+        {
+            *static_cast<unsigned long *>(argument) = mockI2C::functions;
+            return 0;
+        }
+
+        case I2C_RDWR:
+        {
+            return mockI2C::rdwrRequest(static_cast<i2c_rdwr_ioctl_data *>(argument));
+        }
+
+        case I2C_SMBUS:
+        {
+            return mockI2C::smbusRequest(static_cast<i2c_smbus_ioctl_data *>(argument));
+        }
+
+        default:
+        {
+            return 0;
+        }
+    }
+}
+
+
+#endif /* MOCKI2CADAPTER_H_ */